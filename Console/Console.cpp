@@ -1,37 +1,143 @@
 #include <iostream>
-#include <filesystem>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <thread>
 
-#include "shared/environment_repository.h"
 #include "shared/process_service.h"
+#include "snapshot/retention_task.h"
+#include "tasks/executor.h"
+#include "tasks/task_journal.h"
+#include "tasks/timer_scheduler.h"
+#include "monitoring_engine.h"
+#include "snapshot_archive.h"
+#include "target_configuration.h"
 
+using std::cerr;
 using std::cout;
 using std::endl;
 
-using shared::infrastructure::make_shared_const_environment_repository;
+using console::monitoring_engine;
+using console::read_targets;
+using console::snapshot_archive;
+using console::target_configuration;
+using shared::model::process;
 using shared::service::make_process_service;
 
-int main()
+namespace
 {
+    std::atomic<bool> stop_requested{};
+
+    /// <summary>longest a snapshot helper may run before it is terminated, a full UMDH dump of a large process takes tens of seconds</summary>
+    constexpr auto snapshot_timeout = std::chrono::minutes(5);
+
+    /// <summary>how often the snapshot archive is thinned, each tick only does a bounded amount of work</summary>
+    constexpr auto retention_period = std::chrono::minutes(1);
+
+    /// <summary>a series not appended to for this long, most likely because its process exited, has its segment closed</summary>
+    constexpr auto series_idle_time = std::chrono::hours(1);
+
+    extern "C" void on_stop_signal(int)
+    {
+        stop_requested.store(true);
+    }
+
+    void print_status(monitoring_engine const& engine)
+    {
+        for (auto const& status : engine.get_status()) {
+            cout << status.name
+                << " samples=" << status.samples
+                << " snapshots=" << status.snapshots
+                << " skipped=" << status.skipped
+                << " failures=" << status.failures
+                << " snapshot_interval=" << status.snapshot_interval.count() << "ms";
+            if (!status.history.empty())
+                cout << " processes=" << status.history.back().process_count
+                    << " private_bytes=" << status.history.back().private_bytes;
+            cout << endl;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4) {
+        cerr << "usage: Console <targets file> <snapshot directory> <snapshot helper> [run seconds] [journal directory]" << endl;
+        cerr << "the helper is run as umdh is, <snapshot helper> -p:<process id> -f:<output file>, and writes umdh text" << endl;
+        return 2;
+    }
+
     try {
-        auto const environment = make_shared_const_environment_repository();
-        auto const processService = make_process_service();
+        std::ifstream targetsFile(argv[1]);
+        if (!targetsFile)
+            throw std::invalid_argument(std::string("unable to open ") + argv[1]);
+        auto targets = read_targets(targetsFile);
+
+        snapshot_archive archive(argv[2]);
+        std::string const helper(argv[3]);
+        // without a run time, or with one of zero, the monitor runs until stopped
+        auto const runFor = std::chrono::seconds(argc > 4 ? std::stoll(argv[4]) : 0);
+        // with a journal a restarted monitor carries on each target's schedule rather than starting it afresh
+        auto const journal = argc > 5
+            ? std::make_shared<tasks::task_journal>(argv[5])
+            : nullptr;
 
-        if (!environment->set_variable("Hello", "World"))
-            cout << "Failed to set environment variable" << endl;
+        std::signal(SIGINT, on_stop_signal);
+        std::signal(SIGTERM, on_stop_signal);
+
+        auto const processService = make_process_service();
+        tasks::executor executor{};
+        monitoring_engine engine(processService, executor,
+            [&archive, &helper, &processService](target_configuration const& target, process const& running) {
+                // the engine waits on the helper, terminating it should it outlive snapshot_timeout
+                auto const arguments = "-p:" + std::to_string(running.get_id()) + " -f:\"" + archive.get_capture_file(target, running).string() + "\"";
+                auto launched = processService->start_process(helper, arguments);
+                if (!launched)
+                    throw std::runtime_error("unable to start snapshot helper " + helper);
+                return launched;
+            },
+            [&archive](target_configuration const& target, process const& running) {
+                archive.append(target, running, std::chrono::system_clock::now());
+            }, 60, std::chrono::milliseconds(1), snapshot_timeout, journal);
+        for (auto& target : targets)
+            engine.add_target(std::move(target));
 
-        auto const process = processService->start_process(R"(c:\windows\system32\cmd.exe)", "/c sleep 5");
-        if (process == nullptr)
-            return -1;
-        process->wait_for_exit();
+        // the archive is thinned in the background, ticks run on the scheduler's own thread so no two overlap
+        snapshot::retention_engine retention(argv[2]);
+        snapshot::retention_task retentionTask(retention);
+        std::optional<tasks::timer_scheduler> retentionTimer{};
+        retentionTimer.emplace([](tasks::task& due, tasks::timer_id const&) {
+            try {
+                due.process();
+            }
+            catch (std::exception const& e) {
+                cerr << "retention failed: " << e.what() << endl;
+            }
+        }, std::chrono::milliseconds(1));
+        static_cast<void>(retentionTimer->schedule_periodic(retentionTask, retention_period));
+        cout << "monitoring " << engine.size() << " targets" << endl;
 
-        auto const envVar = environment->get_variable("Hello");
-        cout << envVar.value_or("no value found") << endl;
+        auto const started = std::chrono::steady_clock::now();
+        auto lastReport = started;
+        while (!stop_requested.load() && (runFor <= std::chrono::seconds::zero() || std::chrono::steady_clock::now() - started < runFor)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (std::chrono::steady_clock::now() - lastReport >= std::chrono::seconds(10)) {
+                print_status(engine);
+                archive.close_idle(std::chrono::system_clock::now() - series_idle_time);
+                lastReport = std::chrono::steady_clock::now();
+            }
+        }
 
-        auto processes = processService->get_processes_by_name("svchost.exe");
-        for (auto const& p : processes)
-            cout << "Process ID: " << p->get_id() << endl;
+        retentionTimer.reset();
+        engine.stop();
+        archive.close();
+        print_status(engine);
     }
     catch (std::exception const& e) {
         cout << "Unexpected error occured: " << e.what() << endl;
+        return 1;
     }
 }
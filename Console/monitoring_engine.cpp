@@ -0,0 +1,520 @@
+#include "monitoring_engine.h"
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include "tasks/process_stop_callback.h"
+#include "tasks/task.h"
+
+using std::function;
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
+using std::shared_ptr;
+using std::size_t;
+using std::vector;
+
+using metrics::adaptive_cadence;
+using metrics::cadence_decision;
+using shared::model::process;
+using shared::model::unique_process;
+using shared::service::shared_process_service;
+using tasks::task;
+using tasks::task_journal;
+using tasks::task_observer;
+using tasks::task_state;
+
+namespace console
+{
+
+namespace
+{
+    /// <summary>FNV-1a of the activity and target, stable across restarts so journalled schedules can be found again</summary>
+    std::uint64_t get_journal_id(std::string_view const activity, target_configuration const& configuration) noexcept
+    {
+        auto hash = 0xCBF29CE484222325ULL;
+        auto const add = [&hash](std::string_view const value) {
+            for (auto const character : value)
+                hash = (hash ^ static_cast<unsigned char>(character)) * 0x100000001B3ULL;
+            hash = (hash ^ 0xFFU) * 0x100000001B3ULL;
+        };
+        add(activity);
+        add(configuration.get_name());
+        add(configuration.arguments);
+        return hash;
+    }
+}
+
+/// <summary>one of the periodic activities of a target, sampling or snapshotting</summary>
+class target_task final : public task
+{
+public:
+    void process() override
+    {
+        m_work();
+    }
+
+    /// <summary>moves to READY unless the previous run has yet to finish, in which case the tick is counted as skipped</summary>
+    [[nodiscard]] bool try_ready()
+    {
+        auto const ready = try_transition(task_state::PENDING, task_state::READY) ||
+            try_transition(task_state::COMPLETE, task_state::READY) ||
+            try_transition(task_state::FAILED, task_state::READY);
+        if (!ready)
+            m_skipped.fetch_add(1U, std::memory_order_relaxed);
+        return ready;
+    }
+
+    void run() noexcept
+    {
+        try {
+            static_cast<void>(try_transition(task_state::READY, task_state::RUNNING));
+            process();
+            static_cast<void>(try_transition(task_state::RUNNING, task_state::COMPLETE));
+        } catch (...) {
+            // whatever was thrown the task has to leave RUNNING, or every later tick would be skipped
+            m_failures.fetch_add(1U, std::memory_order_relaxed);
+            static_cast<void>(try_transition(task_state::RUNNING, task_state::FAILED));
+        }
+    }
+
+    [[nodiscard]] size_t get_skipped() const noexcept
+    {
+        return m_skipped.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] size_t get_failures() const noexcept
+    {
+        return m_failures.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>when the task was scheduled or last fell due, guarded by the engine's mutex</summary>
+    [[nodiscard]] monitoring_engine::clock::time_point get_last_due() const noexcept
+    {
+        return m_last_due;
+    }
+    void set_last_due(monitoring_engine::clock::time_point const last_due) noexcept
+    {
+        m_last_due = last_due;
+    }
+
+    [[nodiscard]] std::uint64_t get_journal_id() const noexcept
+    {
+        return m_journal_id;
+    }
+
+    explicit target_task(std::uint64_t const journal_id, function<void()> work)
+        : m_journal_id{journal_id}
+        , m_work{std::move(work)}
+    {
+    }
+
+private:
+    std::uint64_t m_journal_id;
+    function<void()> m_work;
+    std::atomic<size_t> m_skipped{};
+    std::atomic<size_t> m_failures{};
+    monitoring_engine::clock::time_point m_last_due{};
+};
+
+/// <summary>called with a target whose adaptive cadence has changed its interval or asked for a snapshot now</summary>
+using cadence_handler = function<void(monitored_target&, cadence_decision const&)>;
+
+class monitored_target final
+{
+public:
+    [[nodiscard]] target_task& get_sample_task() noexcept
+    {
+        return m_sample_task;
+    }
+    [[nodiscard]] target_task& get_snapshot_task() noexcept
+    {
+        return m_snapshot_task;
+    }
+    [[nodiscard]] target_configuration const& get_configuration() const noexcept
+    {
+        return m_configuration;
+    }
+
+    /// <summary>the periodic timer of the snapshot task, guarded by the engine's mutex</summary>
+    [[nodiscard]] tasks::timer_id get_snapshot_timer() const noexcept
+    {
+        return m_snapshot_timer;
+    }
+    void set_snapshot_timer(tasks::timer_id const snapshot_timer) noexcept
+    {
+        m_snapshot_timer = snapshot_timer;
+    }
+
+    [[nodiscard]] target_status get_status() const
+    {
+        lock_guard lock(m_mutex);
+        target_status status{
+            m_configuration.get_name(),
+            m_samples,
+            m_snapshots,
+            m_sample_task.get_skipped() + m_snapshot_task.get_skipped(),
+            m_sample_task.get_failures() + m_snapshot_task.get_failures(),
+            m_snapshot_interval,
+            {}};
+        status.history.reserve(m_history.size());
+        // once full the ring's oldest sample is the one due to be overwritten next
+        auto const oldest = m_history.size() < m_history_length ? size_t{0} : m_next;
+        for (size_t offset = 0; offset < m_history.size(); ++offset)
+            status.history.push_back(m_history[(oldest + offset) % m_history.size()]);
+        return status;
+    }
+
+    void terminate_launched() noexcept
+    {
+        lock_guard lock(m_launch_mutex);
+        if (m_launched)
+            m_launched->terminate(1UL);
+        m_launched.reset();
+    }
+
+    /// <remarks>given a journal both tasks are tracked by it, and their transitions journalled, until the target is destroyed</remarks>
+    explicit monitored_target(target_configuration configuration, shared_process_service process_service, snapshot_handler const& on_snapshot,
+        captured_handler const& on_captured, cadence_handler on_cadence, size_t const history_length, shared_ptr<task_journal> journal)
+        : m_configuration{std::move(configuration)}
+        , m_process_service{std::move(process_service)}
+        , m_journal{std::move(journal)}
+        , m_on_cadence{std::move(on_cadence)}
+        , m_history_length{history_length}
+        , m_snapshot_interval{m_configuration.snapshot_interval}
+        , m_sample_task{get_journal_id("sample", m_configuration), [this]() { sample(); }}
+        , m_snapshot_task{get_journal_id("snapshot", m_configuration), [this, &on_snapshot, &on_captured]() { snapshot(on_snapshot, on_captured); }}
+    {
+        m_history.reserve(history_length);
+        if (m_configuration.maximum_snapshot_interval > m_configuration.snapshot_interval)
+            m_cadence.emplace(m_configuration.snapshot_interval, m_configuration.maximum_snapshot_interval);
+        if (!m_journal)
+            return;
+
+        m_journal->track(m_sample_task, m_sample_task.get_journal_id());
+        m_journal->track(m_snapshot_task, m_snapshot_task.get_journal_id());
+        m_sample_task.add_observer(m_journal);
+        m_snapshot_task.add_observer(m_journal);
+    }
+    monitored_target(monitored_target const&) = delete;
+    monitored_target(monitored_target&&) noexcept = delete;
+    monitored_target& operator=(monitored_target const&) = delete;
+    monitored_target& operator=(monitored_target&&) noexcept = delete;
+    ~monitored_target()
+    {
+        if (!m_journal)
+            return;
+        m_journal->untrack(m_sample_task);
+        m_journal->untrack(m_snapshot_task);
+    }
+
+private:
+    target_configuration m_configuration;
+    shared_process_service m_process_service;
+    shared_ptr<task_journal> m_journal;
+    cadence_handler m_on_cadence;
+    size_t m_history_length;
+    /// <summary>only touched by the sample task, which never runs twice at once</summary>
+    std::optional<adaptive_cadence> m_cadence{};
+    tasks::timer_id m_snapshot_timer{};
+
+    mutable mutex m_mutex{};
+    vector<target_sample> m_history{};
+    size_t m_next{};
+    size_t m_samples{};
+    size_t m_snapshots{};
+    std::chrono::milliseconds m_snapshot_interval;
+
+    mutex m_launch_mutex{};
+    unique_process m_launched{};
+
+    target_task m_sample_task;
+    target_task m_snapshot_task;
+
+    void sample()
+    {
+        size_t process_count{};
+        size_t queried{};
+        std::uint64_t private_bytes{};
+        for_each_process([&](process const& running) {
+            ++process_count;
+            auto const bytes = running.get_private_bytes();
+            if (bytes.has_value()) {
+                ++queried;
+                private_bytes += bytes.value();
+            }
+        });
+
+        target_sample const taken{monitoring_engine::clock::now(), process_count, private_bytes};
+        {
+            lock_guard lock(m_mutex);
+            if (m_history.size() < m_history_length)
+                m_history.push_back(taken);
+            else
+                m_history[m_next] = taken;
+            m_next = (m_next + 1U) % m_history_length;
+            ++m_samples;
+        }
+
+        // with nothing running there's no memory to follow, feeding zeros would read a restart as a spike
+        if (!m_cadence.has_value() || queried == 0U)
+            return;
+        auto const decision = m_cadence->add(taken.taken_at, private_bytes);
+        if (!decision.changed && !decision.snapshot_now)
+            return;
+        {
+            lock_guard lock(m_mutex);
+            m_snapshot_interval = std::chrono::duration_cast<std::chrono::milliseconds>(decision.interval);
+        }
+        m_on_cadence(*this, decision);
+    }
+
+    void snapshot(snapshot_handler const& on_snapshot, captured_handler const& on_captured)
+    {
+        auto const stop_token = m_snapshot_task.get_stop_token();
+        for_each_process([this, &on_snapshot, &on_captured, &stop_token](process const& running) {
+            auto const helper = on_snapshot(m_configuration, running);
+            if (!helper)
+                return;
+
+            // a timed out or stopped run terminates the helper, which ends the wait
+            tasks::process_stop_callback const on_stop(stop_token, tasks::terminate_process{*helper});
+            helper->wait_for_exit();
+            if (stop_token.stop_requested())
+                throw std::runtime_error("snapshot of " + m_configuration.get_name() + " was stopped");
+            if (auto const exit_code = helper->exit_code(); exit_code.value_or(0UL) != 0UL)
+                throw std::runtime_error("snapshot helper for " + m_configuration.get_name() + " exited with " + std::to_string(exit_code.value()));
+
+            if (on_captured)
+                on_captured(m_configuration, running);
+        });
+
+        lock_guard lock(m_mutex);
+        ++m_snapshots;
+    }
+
+    template <typename VISITOR>
+    void for_each_process(VISITOR visitor)
+    {
+        switch (m_configuration.kind) {
+        case target_kind::NAME:
+            for (auto const& running : m_process_service->get_processes_by_name(m_configuration.value))
+                if (running->is_running())
+                    visitor(*running);
+            return;
+        case target_kind::PID: {
+            auto const running = m_process_service->get_process_by_id(std::stoul(m_configuration.value));
+            if (running && running->is_running())
+                visitor(*running);
+            return;
+        }
+        case target_kind::LAUNCH: {
+            // launched on first use rather than when added so a slow start delays only this target's run
+            lock_guard lock(m_launch_mutex);
+            if (!m_launched)
+                m_launched = m_process_service->start_process(m_configuration.value, m_configuration.arguments);
+            if (!m_launched)
+                throw std::runtime_error("unable to launch " + m_configuration.value);
+            if (m_launched->is_running())
+                visitor(*m_launched);
+            return;
+        }
+        }
+    }
+};
+
+void monitoring_engine::add_target(target_configuration target)
+{
+    if (target.sample_interval <= std::chrono::milliseconds::zero())
+        throw std::invalid_argument("sample interval must be positive");
+
+    lock_guard lock(m_mutex);
+    if (m_stopping)
+        throw std::invalid_argument("engine has been stopped");
+
+    auto added = make_unique<monitored_target>(std::move(target), m_process_service, m_on_snapshot, m_on_captured,
+        [this](monitored_target& adapted, cadence_decision const& decision) { retime(adapted, decision); }, m_history_length, m_journal);
+    for (auto const& observer : m_observers) {
+        added->get_sample_task().add_observer(observer);
+        added->get_snapshot_task().add_observer(observer);
+    }
+
+    if (m_timeouts) {
+        added->get_snapshot_task().set_timeout(m_snapshot_timeout);
+        added->get_snapshot_task().add_observer(m_timeouts);
+    }
+
+    auto const& configuration = added->get_configuration();
+    auto& sample = added->get_sample_task();
+    static_cast<void>(m_timers->schedule_periodic(sample, configuration.sample_interval, restore_schedule(sample.get_journal_id(), configuration.sample_interval)));
+    if (configuration.snapshot_interval > std::chrono::milliseconds::zero()) {
+        auto& snapshot = added->get_snapshot_task();
+        auto const delay = restore_schedule(snapshot.get_journal_id(), configuration.snapshot_interval);
+        added->set_snapshot_timer(m_timers->schedule_periodic(snapshot, configuration.snapshot_interval, delay));
+        // the time already waited by a resumed schedule counts towards an adaptive retime
+        snapshot.set_last_due(clock::now() + delay - clock::duration(configuration.snapshot_interval));
+    }
+
+    m_targets.push_back(std::move(added));
+}
+
+void monitoring_engine::add_observer(shared_ptr<task_observer> observer)
+{
+    if (!observer)
+        throw std::invalid_argument("observer is null");
+
+    lock_guard lock(m_mutex);
+    for (auto const& target : m_targets) {
+        target->get_sample_task().add_observer(observer);
+        target->get_snapshot_task().add_observer(observer);
+    }
+    m_observers.push_back(std::move(observer));
+}
+
+vector<target_status> monitoring_engine::get_status() const
+{
+    lock_guard lock(m_mutex);
+    vector<target_status> statuses{};
+    statuses.reserve(m_targets.size());
+    for (auto const& target : m_targets)
+        statuses.push_back(target->get_status());
+    return statuses;
+}
+
+size_t monitoring_engine::size() const
+{
+    lock_guard lock(m_mutex);
+    return m_targets.size();
+}
+
+void monitoring_engine::stop()
+{
+    {
+        lock_guard lock(m_mutex);
+        if (m_stopping)
+            return;
+        m_stopping = true;
+    }
+    // outside the lock as the timer thread may be waiting on it, once stopping nothing else touches the timers
+    m_timers.reset();
+
+    // no more runs will be dispatched, those still going are asked to finish and their helpers terminated
+    for (auto const& target : m_targets) {
+        target->get_sample_task().request_stop();
+        target->get_snapshot_task().request_stop();
+    }
+    {
+        std::unique_lock lock(m_mutex);
+        m_idle.wait(lock, [this]() { return m_in_flight == 0U; });
+    }
+    for (auto const& target : m_targets)
+        target->terminate_launched();
+}
+
+monitoring_engine::monitoring_engine(shared_process_service process_service, tasks::executor& executor, snapshot_handler on_snapshot, captured_handler on_captured,
+    size_t const history_length, clock::duration const resolution,
+    std::optional<clock::duration> const snapshot_timeout, shared_ptr<task_journal> journal)
+    : m_process_service{std::move(process_service)}
+    , m_executor{executor}
+    , m_on_snapshot{std::move(on_snapshot)}
+    , m_on_captured{std::move(on_captured)}
+    , m_history_length{history_length}
+    , m_snapshot_timeout{snapshot_timeout}
+    , m_journal{std::move(journal)}
+    , m_resolution{resolution}
+{
+    if (!m_process_service)
+        throw std::invalid_argument("process_service is null");
+    if (!m_on_snapshot)
+        throw std::invalid_argument("on_snapshot is empty");
+    if (m_history_length == 0U)
+        throw std::invalid_argument("history_length must be positive");
+
+    if (m_snapshot_timeout.has_value())
+        m_timeouts = std::make_shared<tasks::timeout_monitor>(resolution);
+    m_timers.emplace([this](task& expired, tasks::timer_id const&) { on_expired(expired); }, resolution);
+}
+
+monitoring_engine::~monitoring_engine()
+{
+    stop();
+}
+
+void monitoring_engine::on_expired(task& expired)
+{
+    lock_guard lock(m_mutex);
+    if (!m_stopping)
+        dispatch(expired);
+}
+
+void monitoring_engine::dispatch(task& expired)
+{
+    auto& due = static_cast<target_task&>(expired);
+    // a task still queued or running keeps its last due time, a skipped spike mustn't push back the next snapshot
+    if (!due.try_ready())
+        return;
+    due.set_last_due(clock::now());
+
+    ++m_in_flight;
+    m_executor.post([this, &due]() {
+        due.run();
+        finished();
+    });
+}
+
+void monitoring_engine::finished()
+{
+    lock_guard lock(m_mutex);
+    --m_in_flight;
+    if (m_in_flight == 0U)
+        m_idle.notify_all();
+}
+
+void monitoring_engine::retime(monitored_target& target, cadence_decision const& decision)
+{
+    lock_guard lock(m_mutex);
+    if (m_stopping)
+        return;
+
+    auto& snapshot = target.get_snapshot_task();
+    if (decision.snapshot_now)
+        dispatch(snapshot);
+
+    // time already waited counts towards the new interval, so tightening brings a snapshot which is overdue forward at once
+    static_cast<void>(m_timers->cancel(target.get_snapshot_timer()));
+    auto const waited = clock::now() - snapshot.get_last_due();
+    auto const delay = waited < decision.interval ? decision.interval - waited : m_resolution;
+    target.set_snapshot_timer(m_timers->schedule_periodic(snapshot, decision.interval, delay));
+    journal_schedule(snapshot.get_journal_id(), delay, decision.interval);
+}
+
+monitoring_engine::clock::duration monitoring_engine::restore_schedule(std::uint64_t const id, clock::duration const period) const
+{
+    if (!m_journal)
+        return period;
+
+    auto const now = task_journal::clock::now();
+    auto const recovered = m_journal->get_recovered().find(id);
+    if (recovered != m_journal->get_recovered().end() && recovered->second.period == std::chrono::duration_cast<task_journal::clock::duration>(period)) {
+        auto const next_due = recovered->second.get_next_due(now);
+        if (next_due.has_value())
+            return std::chrono::duration_cast<clock::duration>(next_due.value() - now);
+    }
+
+    // new, or with a changed interval, so the schedule starts afresh from now
+    journal_schedule(id, period, period);
+    return period;
+}
+
+void monitoring_engine::journal_schedule(std::uint64_t const id, clock::duration const delay, clock::duration const period) const noexcept
+{
+    if (!m_journal)
+        return;
+    try {
+        auto const anchor = task_journal::clock::now() + std::chrono::duration_cast<task_journal::clock::duration>(delay);
+        static_cast<void>(m_journal->append_schedule(id, anchor, std::chrono::duration_cast<task_journal::clock::duration>(period)));
+    } catch (std::exception const&) {
+        // a failed journal only costs the schedule being restored after a restart, monitoring carries on
+    }
+}
+
+}
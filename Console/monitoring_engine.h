@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "metrics/adaptive_cadence.h"
+#include "shared/process.h"
+#include "shared/process_service.h"
+#include "tasks/executor.h"
+#include "tasks/task_journal.h"
+#include "tasks/task_observer.h"
+#include "tasks/timeout_monitor.h"
+#include "tasks/timer_scheduler.h"
+#include "target_configuration.h"
+
+namespace console
+{
+
+    struct target_sample final
+    {
+        tasks::timer_scheduler::clock::time_point taken_at{};
+        /// <summary>number of running processes matching the target</summary>
+        std::size_t process_count{};
+        /// <summary>private bytes summed over those processes which could be queried</summary>
+        std::uint64_t private_bytes{};
+    };
+
+    struct target_status final
+    {
+        std::string name{};
+        std::size_t samples{};
+        std::size_t snapshots{};
+        /// <summary>ticks dropped because the previous run for the target had yet to finish</summary>
+        std::size_t skipped{};
+        std::size_t failures{};
+        /// <summary>current snapshot interval, which moves within the configured range for an adaptive target</summary>
+        std::chrono::milliseconds snapshot_interval{};
+        /// <summary>most recent samples, oldest first</summary>
+        std::vector<target_sample> history{};
+    };
+
+    /// <summary>called for each running process of a target whenever its snapshot interval elapses</summary>
+    /// <returns>
+    /// the helper launched to capture the snapshot, if any, which the engine waits on and terminates should the
+    /// run time out or the engine stop
+    /// </returns>
+    using snapshot_handler = std::function<shared::model::unique_process(target_configuration const&, shared::model::process const&)>;
+
+    /// <summary>called once the helper returned by a snapshot_handler has exited successfully, to collect what it captured</summary>
+    /// <remarks>not called for a run which was stopped or timed out or whose helper failed, anything thrown fails the run</remarks>
+    using captured_handler = std::function<void(target_configuration const&, shared::model::process const&)>;
+
+    class monitored_target;
+
+    /// <summary>
+    /// samples and snapshots any number of targets from a single timer_scheduler, with the work itself run on
+    /// a shared executor
+    /// </summary>
+    /// <remarks>
+    /// each target holds at most one queued or running sample and one snapshot, a tick which arrives while
+    /// the previous run is still going is counted and dropped, so together with a fixed length sample
+    /// history memory stays bounded by the number of targets however far behind the executor falls.
+    /// an adaptive target's samples drive an adaptive_cadence, which retimes its snapshots as memory moves
+    /// and brings one forward when memory jumps. given a task_journal every transition and schedule is
+    /// journalled under an id derived from the target, so a restarted engine resumes each schedule from its anchor
+    /// </remarks>
+    class monitoring_engine final
+    {
+    public:
+        using clock = tasks::timer_scheduler::clock;
+
+        /// <summary>
+        /// schedules target, its first sample is taken one sample interval from now unless the journal holds a
+        /// schedule for it with the same interval, in which case that schedule carries on
+        /// </summary>
+        /// <exception cref="std::invalid_argument">if the sample interval isn't positive or the engine has been stopped</exception>
+        void add_target(target_configuration target);
+        /// <summary>observer added to the sample and snapshot tasks of every current and future target</summary>
+        void add_observer(std::shared_ptr<tasks::task_observer> observer);
+
+        [[nodiscard]] std::vector<target_status> get_status() const;
+        [[nodiscard]] std::size_t size() const;
+
+        /// <summary>cancels every timer, stops runs in progress, terminating their helpers, then terminates launched processes</summary>
+        void stop();
+
+        /// <remarks>executor must outlive the engine, a snapshot run taking longer than snapshot_timeout is stopped</remarks>
+        /// <param name="on_captured">may be empty if on_snapshot needs nothing done once its helper exits</param>
+        /// <exception cref="std::invalid_argument">if process_service or on_snapshot is empty, or history_length is zero</exception>
+        explicit monitoring_engine(shared::service::shared_process_service process_service, tasks::executor& executor,
+            snapshot_handler on_snapshot, captured_handler on_captured, std::size_t const history_length = 60, clock::duration const resolution = std::chrono::milliseconds(1),
+            std::optional<clock::duration> const snapshot_timeout = std::nullopt, std::shared_ptr<tasks::task_journal> journal = nullptr);
+        monitoring_engine(monitoring_engine const&) = delete;
+        monitoring_engine(monitoring_engine&&) noexcept = delete;
+        monitoring_engine& operator=(monitoring_engine const&) = delete;
+        monitoring_engine& operator=(monitoring_engine&&) noexcept = delete;
+        ~monitoring_engine();
+
+    private:
+        shared::service::shared_process_service m_process_service;
+        tasks::executor& m_executor;
+        snapshot_handler m_on_snapshot;
+        captured_handler m_on_captured;
+        std::size_t m_history_length;
+        std::optional<clock::duration> m_snapshot_timeout;
+        std::shared_ptr<tasks::timeout_monitor> m_timeouts{};
+        std::shared_ptr<tasks::task_journal> m_journal;
+
+        clock::duration m_resolution;
+
+        mutable std::mutex m_mutex{};
+        std::condition_variable m_idle{};
+        std::vector<std::unique_ptr<monitored_target>> m_targets{};
+        std::vector<std::shared_ptr<tasks::task_observer>> m_observers{};
+        std::size_t m_in_flight{};
+        bool m_stopping{};
+
+        /// <summary>reset by stop, which waits for its thread, only touched under m_mutex before then</summary>
+        std::optional<tasks::timer_scheduler> m_timers{};
+
+        void on_expired(tasks::task& expired);
+        void dispatch(tasks::task& expired);
+        void finished();
+        void retime(monitored_target& target, metrics::cadence_decision const& decision);
+        /// <returns>delay until the first run, resuming the journalled schedule of id if its period is unchanged</returns>
+        [[nodiscard]] clock::duration restore_schedule(std::uint64_t const id, clock::duration const period) const;
+        void journal_schedule(std::uint64_t const id, clock::duration const delay, clock::duration const period) const noexcept;
+    };
+
+}
@@ -0,0 +1,128 @@
+#include "snapshot_archive.h"
+#include <cctype>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "snapshot/heap_snapshot.h"
+#include "snapshot/mapped_file.h"
+
+using std::lock_guard;
+using std::shared_ptr;
+using std::string;
+using std::filesystem::path;
+using shared::model::process;
+
+namespace console
+{
+
+namespace
+{
+    constexpr char const* CAPTURE_FILENAME = "capture.umdh";
+
+    /// <summary>target name with anything but letters, digits, '.' and '-' replaced so it's usable as a directory name</summary>
+    [[nodiscard]] string to_directory_name(string const& name)
+    {
+        string directory_name{name};
+        for (auto& character : directory_name)
+            if (!std::isalnum(static_cast<unsigned char>(character)) && character != '.' && character != '-')
+                character = '_';
+        return directory_name;
+    }
+
+    /// <summary>yyyymmddThhmmss.mmmZ.snap, names sort in time order which retention_engine relies on</summary>
+    [[nodiscard]] string get_segment_name(snapshot_archive::clock::time_point const started)
+    {
+        auto const day = std::chrono::floor<std::chrono::days>(started);
+        std::chrono::year_month_day const date{day};
+        std::chrono::hh_mm_ss const time{std::chrono::floor<std::chrono::milliseconds>(started - day)};
+        char name[32]{};
+        std::snprintf(name, sizeof(name), "%04d%02u%02uT%02d%02d%02d.%03dZ.snap",
+            static_cast<int>(date.year()), static_cast<unsigned int>(date.month()), static_cast<unsigned int>(date.day()),
+            static_cast<int>(time.hours().count()), static_cast<int>(time.minutes().count()), static_cast<int>(time.seconds().count()),
+            static_cast<int>(time.subseconds().count()));
+        return name;
+    }
+}
+
+path snapshot_archive::get_capture_file(target_configuration const& target, process const& running) const
+{
+    auto const directory = get_series_directory(target, running);
+    std::filesystem::create_directories(directory);
+    return directory / CAPTURE_FILENAME;
+}
+
+void snapshot_archive::append(target_configuration const& target, process const& running, clock::time_point const taken_at)
+{
+    auto const directory = get_series_directory(target, running);
+    auto const capture = directory / CAPTURE_FILENAME;
+    auto const appending = get_series(directory);
+
+    lock_guard lock(appending->mutex);
+    {
+        snapshot::mapped_file const text(capture);
+        auto const parsed = snapshot::read_heap_snapshot(text.get_view(), appending->traces);
+        if (!appending->writer.has_value())
+            appending->writer.emplace(directory / get_segment_name(taken_at));
+        appending->writer->append(parsed, taken_at, appending->traces);
+    }
+    std::filesystem::remove(capture);
+    appending->last_appended = clock::now();
+
+    // a new segment writes every trace it uses again, so the table starts afresh with it and stays bounded
+    if (++appending->written < m_segment_length)
+        return;
+    appending->writer.reset();
+    appending->written = 0U;
+    appending->traces.clear();
+}
+
+void snapshot_archive::close_idle(clock::time_point const before)
+{
+    std::vector<shared_ptr<series>> idle{};
+    {
+        lock_guard lock(m_mutex);
+        std::erase_if(m_series, [&before, &idle](auto const& entry) {
+            lock_guard series_lock(entry.second->mutex);
+            if (entry.second->last_appended >= before)
+                return false;
+            idle.push_back(entry.second);
+            return true;
+        });
+    }
+    // closed outside the archive lock, writing an index shouldn't hold up appends to other series
+    for (auto const& closing : idle) {
+        lock_guard lock(closing->mutex);
+        closing->writer.reset();
+    }
+}
+
+void snapshot_archive::close()
+{
+    close_idle(clock::time_point::max());
+}
+
+snapshot_archive::snapshot_archive(path directory, std::size_t const segment_length)
+    : m_directory{std::move(directory)}
+    , m_segment_length{segment_length}
+{
+    if (m_segment_length == 0U)
+        throw std::invalid_argument("segment_length must be positive");
+    std::filesystem::create_directories(m_directory);
+}
+
+path snapshot_archive::get_series_directory(target_configuration const& target, process const& running) const
+{
+    return m_directory / (to_directory_name(target.get_name()) + "." + std::to_string(running.get_id()));
+}
+
+shared_ptr<snapshot_archive::series> snapshot_archive::get_series(path const& directory)
+{
+    lock_guard lock(m_mutex);
+    auto& found = m_series[directory];
+    if (!found)
+        found = std::make_shared<series>();
+    return found;
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "shared/process.h"
+#include "snapshot/snapshot_file.h"
+#include "snapshot/trace_table.h"
+#include "target_configuration.h"
+
+namespace console
+{
+
+    /// <summary>
+    /// writes the snapshots captured of each target process to a series of its own, a directory of segment files
+    /// beneath the archive directory which retention_engine thins as they age
+    /// </summary>
+    /// <remarks>
+    /// a series directory is named for the target and process id, its segments are named for the UTC time of
+    /// their first snapshot, yyyymmddThhmmss.mmmZ.snap, so they sort in the order they were written. a segment is
+    /// closed once it holds segment_length snapshots and a new one started, until then it has no index and
+    /// retention leaves it alone, or recovers it once a crash has left it unwritten for retention's full_window.
+    /// appends to different series run concurrently
+    /// </remarks>
+    class snapshot_archive final
+    {
+    public:
+        using clock = std::chrono::system_clock;
+
+        /// <summary>file the snapshot helper writes the umdh text of running to, its series directory is created if need be</summary>
+        /// <exception cref="std::filesystem::filesystem_error">if the series directory can't be created</exception>
+        [[nodiscard]] std::filesystem::path get_capture_file(target_configuration const& target, shared::model::process const& running) const;
+
+        /// <summary>parses the capture of running, appends it to the open segment of its series then removes the capture</summary>
+        /// <exception cref="std::system_error">if the capture can't be read</exception>
+        /// <exception cref="std::ios_base::failure">if the segment can't be written</exception>
+        void append(target_configuration const& target, shared::model::process const& running, clock::time_point const taken_at);
+
+        /// <summary>closes the open segment of every series not appended to since before, and forgets the series</summary>
+        void close_idle(clock::time_point const before);
+        /// <summary>closes every open segment</summary>
+        void close();
+
+        /// <exception cref="std::invalid_argument">if segment_length is zero</exception>
+        /// <exception cref="std::filesystem::filesystem_error">if directory can't be created</exception>
+        explicit snapshot_archive(std::filesystem::path directory, std::size_t const segment_length = 60U);
+        snapshot_archive(snapshot_archive const&) = delete;
+        snapshot_archive(snapshot_archive&&) noexcept = delete;
+        snapshot_archive& operator=(snapshot_archive const&) = delete;
+        snapshot_archive& operator=(snapshot_archive&&) noexcept = delete;
+        ~snapshot_archive() = default;
+
+    private:
+        struct series final
+        {
+            std::mutex mutex{};
+            snapshot::trace_table traces{};
+            std::optional<snapshot::snapshot_file_writer> writer{};
+            std::size_t written{};
+            clock::time_point last_appended{};
+        };
+
+        std::filesystem::path m_directory;
+        std::size_t m_segment_length;
+        mutable std::mutex m_mutex{};
+        // held by an append in progress as well, a series forgotten meanwhile closes its segment once that append ends
+        std::map<std::filesystem::path, std::shared_ptr<series>> m_series{};
+
+        [[nodiscard]] std::filesystem::path get_series_directory(target_configuration const& target, shared::model::process const& running) const;
+        [[nodiscard]] std::shared_ptr<series> get_series(std::filesystem::path const& directory);
+    };
+
+}
@@ -0,0 +1,118 @@
+#include "target_configuration.h"
+#include <sstream>
+#include <stdexcept>
+
+using std::chrono::milliseconds;
+using std::istream;
+using std::string;
+using std::vector;
+
+namespace console
+{
+
+namespace
+{
+    [[noreturn]] void throw_malformed(std::size_t const line_number, string const& reason)
+    {
+        throw std::invalid_argument("line " + std::to_string(line_number) + ": " + reason);
+    }
+
+    target_kind parse_kind(string const& kind, std::size_t const line_number)
+    {
+        if (kind == "name")
+            return target_kind::NAME;
+        if (kind == "pid")
+            return target_kind::PID;
+        if (kind == "launch")
+            return target_kind::LAUNCH;
+        throw_malformed(line_number, "unknown target kind " + kind);
+    }
+
+    milliseconds parse_interval(std::istringstream& fields, std::size_t const line_number)
+    {
+        long long interval{};
+        if (!(fields >> interval) || interval < 0)
+            throw_malformed(line_number, "expected an interval in milliseconds");
+        return milliseconds(interval);
+    }
+
+    void parse_snapshot_intervals(std::istringstream& fields, std::size_t const line_number, target_configuration& target)
+    {
+        string intervals{};
+        fields >> intervals;
+        auto const separator = intervals.find(':');
+        std::istringstream minimum(intervals.substr(0U, separator));
+        target.snapshot_interval = parse_interval(minimum, line_number);
+        if (separator == string::npos)
+            return;
+
+        std::istringstream maximum(intervals.substr(separator + 1U));
+        target.maximum_snapshot_interval = parse_interval(maximum, line_number);
+        if (target.snapshot_interval == milliseconds::zero() || target.maximum_snapshot_interval < target.snapshot_interval)
+            throw_malformed(line_number, "adaptive snapshot interval must be minimum:maximum with 0 < minimum <= maximum");
+    }
+
+    string trim(string const& value)
+    {
+        auto const first = value.find_first_not_of(" \t\r");
+        if (first == string::npos)
+            return string();
+        auto const last = value.find_last_not_of(" \t\r");
+        return value.substr(first, last - first + 1U);
+    }
+}
+
+string target_configuration::get_name() const
+{
+    switch (kind) {
+    case target_kind::NAME:
+        return "name:" + value;
+    case target_kind::PID:
+        return "pid:" + value;
+    case target_kind::LAUNCH:
+        return "launch:" + value;
+    }
+    return value;
+}
+
+vector<target_configuration> read_targets(istream& source)
+{
+    vector<target_configuration> targets{};
+    string line{};
+    std::size_t line_number{};
+    while (std::getline(source, line)) {
+        ++line_number;
+        line = trim(line);
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        std::istringstream fields(line);
+        string kind{};
+        fields >> kind;
+
+        target_configuration target{};
+        target.kind = parse_kind(kind, line_number);
+        target.sample_interval = parse_interval(fields, line_number);
+        parse_snapshot_intervals(fields, line_number, target);
+        if (target.sample_interval == milliseconds::zero())
+            throw_malformed(line_number, "sample interval must be positive");
+
+        fields >> target.value;
+        if (target.value.empty())
+            throw_malformed(line_number, "missing target");
+        if (target.kind == target_kind::PID && target.value.find_first_not_of("0123456789") != string::npos)
+            throw_malformed(line_number, "process id must be numeric");
+
+        string arguments{};
+        std::getline(fields, arguments);
+        arguments = trim(arguments);
+        if (!arguments.empty() && target.kind != target_kind::LAUNCH)
+            throw_malformed(line_number, "only launch targets take arguments");
+        target.arguments = std::move(arguments);
+
+        targets.push_back(std::move(target));
+    }
+    return targets;
+}
+
+}
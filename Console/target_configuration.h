@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace console
+{
+
+    enum class target_kind
+    {
+        /// <summary>every running process with a matching executable name</summary>
+        NAME,
+        /// <summary>a single already running process</summary>
+        PID,
+        /// <summary>a process launched, and owned, by the monitor</summary>
+        LAUNCH,
+    };
+
+    /// <summary>process, or set of processes, to be sampled and snapshotted periodically</summary>
+    struct target_configuration final
+    {
+        target_kind kind{};
+        /// <summary>process name, process id or executable to launch depending on kind</summary>
+        std::string value{};
+        /// <summary>command line arguments of a launched executable</summary>
+        std::string arguments{};
+        std::chrono::milliseconds sample_interval{};
+        /// <summary>zero if the target is only sampled, the shortest interval if it adapts</summary>
+        std::chrono::milliseconds snapshot_interval{};
+        /// <summary>
+        /// zero for a fixed interval, otherwise the snapshot interval follows the growth of the target's private
+        /// bytes between snapshot_interval and this
+        /// </summary>
+        std::chrono::milliseconds maximum_snapshot_interval{};
+
+        /// <summary>kind and value, used to identify the target in output</summary>
+        [[nodiscard]] std::string get_name() const;
+    };
+
+    /// <summary>
+    /// reads one target per line in the form "kind sample_ms snapshot_ms value [arguments]" where kind is one
+    /// of name, pid or launch and snapshot_ms is either fixed or an adaptive range "minimum_ms:maximum_ms";
+    /// blank lines and lines starting with # are ignored
+    /// </summary>
+    /// <exception cref="std::invalid_argument">on the first malformed line, naming its line number</exception>
+    [[nodiscard]] std::vector<target_configuration> read_targets(std::istream& source);
+
+}
@@ -0,0 +1,87 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <metrics/metrics_export.h>
+#include <metrics/time_series.h>
+
+namespace metrics
+{
+
+    struct cadence_thresholds final
+    {
+        /// <summary>number of most recent samples the growth rate is fitted over</summary>
+        std::size_t window{8U};
+        /// <summary>growth in bytes per second at or above which the interval is halved, about 1MiB a minute</summary>
+        double tighten_slope{16.0 * 1024.0};
+        /// <summary>growth in bytes per second at or below which the interval is doubled, shrinking counts as idle</summary>
+        double relax_slope{1024.0};
+        /// <summary>growth between consecutive samples, as a fraction of the earlier one, which is a spike</summary>
+        double spike_fraction{0.2};
+        /// <summary>least growth between consecutive samples counted as a spike, so a small process can't trip spike_fraction</summary>
+        std::uint64_t spike_minimum_bytes{16U << 20U};
+    };
+
+    struct cadence_decision final
+    {
+        std::chrono::steady_clock::duration interval{};
+        /// <summary>interval differs from the one before the sample</summary>
+        bool changed{};
+        /// <summary>memory jumped, a snapshot should be taken immediately rather than when the interval next elapses</summary>
+        bool snapshot_now{};
+    };
+
+    /// <summary>
+    /// chooses how often to take a heavy snapshot of a target from a cheap metric sampled far more often, such
+    /// as private bytes: the interval halves towards minimum while memory grows and doubles towards maximum
+    /// while it is flat or shrinking
+    /// </summary>
+    /// <remarks>
+    /// growth is the least squares slope over the last few samples so a single noisy sample moves nothing, a
+    /// jump between two consecutive samples asks for a snapshot at once. the interval starts at minimum so a
+    /// baseline snapshot is taken promptly. not thread safe, intended to be fed by a single sampling task
+    /// </remarks>
+    class adaptive_cadence final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        /// <summary>adds a sample taken at taken_at, which must not be earlier than the previous one</summary>
+        [[nodiscard]] METRICS_DLL cadence_decision add(clock::time_point const taken_at, std::uint64_t const bytes);
+
+        [[nodiscard]] clock::duration get_interval() const noexcept
+        {
+            return m_interval;
+        }
+        /// <summary>growth in bytes per second over the window, empty until it holds at least 3 samples</summary>
+        [[nodiscard]] METRICS_DLL std::optional<double> get_slope() const noexcept;
+
+        /// <exception cref="std::invalid_argument">if minimum isn't positive, maximum is less than minimum or the window is under 3 samples</exception>
+        METRICS_DLL explicit adaptive_cadence(clock::duration const minimum, clock::duration const maximum, cadence_thresholds const& thresholds = {});
+
+    private:
+        clock::duration m_minimum;
+        clock::duration m_maximum;
+        cadence_thresholds m_thresholds;
+        clock::duration m_interval;
+        /// <summary>ring of the most recent samples, timestamps in clock ticks</summary>
+        std::vector<sample> m_window{};
+        std::size_t m_next{};
+    };
+
+}
@@ -0,0 +1,90 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <metrics/metrics_export.h>
+
+namespace metrics
+{
+
+    struct sample final
+    {
+        std::int64_t timestamp{};
+        double value{};
+    };
+
+    /// <summary>
+    /// single metric compressed as in Facebook's Gorilla, timestamps as delta of deltas and values as the xor
+    /// of their predecessor, packed into a chain of fixed size blocks each of which can be decoded on its own
+    /// </summary>
+    /// <remarks>
+    /// one thread may append while any number read; appending never blocks or allocates except when a block
+    /// fills, readers see a prefix of the series as it was when the last sample they decode was published.
+    /// timestamps are integers in whatever unit the caller samples at, seconds for 1 second sampling keeps a
+    /// regular cadence down to a single bit per sample
+    /// </remarks>
+    class time_series final
+    {
+    public:
+        /// <summary>bytes allocated per block, header included</summary>
+        static constexpr std::size_t BLOCK_SIZE = 4096U;
+
+        /// <summary>appends a sample, only ever to be called from one thread at a time</summary>
+        /// <returns>false if timestamp is earlier than the last appended</returns>
+        [[nodiscard]] METRICS_DLL bool append(std::int64_t const timestamp, double const value);
+
+        /// <summary>appends every sample with a timestamp in [from, to] to destination in timestamp order</summary>
+        METRICS_DLL void read(std::int64_t const from, std::int64_t const to, std::vector<sample>& destination) const;
+        /// <summary>most recently published sample, empty if there are none</summary>
+        [[nodiscard]] METRICS_DLL std::optional<sample> get_last() const noexcept;
+
+        [[nodiscard]] METRICS_DLL std::size_t size() const noexcept;
+        /// <summary>bytes held by the series including partially filled blocks</summary>
+        [[nodiscard]] METRICS_DLL std::size_t get_memory_usage() const noexcept;
+
+        METRICS_DLL time_series() = default;
+        time_series(time_series const&) = delete;
+        time_series(time_series&&) noexcept = delete;
+        time_series& operator=(time_series const&) = delete;
+        time_series& operator=(time_series&&) noexcept = delete;
+        METRICS_DLL ~time_series();
+
+    private:
+        struct block;
+
+        /// <summary>encoder state, only touched by the appending thread</summary>
+        struct writer_state final
+        {
+            std::uint32_t bit_position{};
+            std::int64_t previous_timestamp{};
+            std::int64_t previous_delta{};
+            std::uint64_t previous_value{};
+            std::uint32_t previous_leading{};
+            std::uint32_t previous_trailing{};
+        };
+
+        std::atomic<block*> m_head{};
+        std::atomic<block*> m_tail{};
+        std::atomic<std::size_t> m_size{};
+        std::atomic<std::size_t> m_block_count{};
+        writer_state m_writer{};
+
+        void start_block(std::int64_t const timestamp, double const value);
+    };
+
+}
@@ -0,0 +1,83 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <metrics/metrics_export.h>
+#include <metrics/time_series.h>
+
+namespace metrics
+{
+
+    struct series_key final
+    {
+        std::uint64_t process_id{};
+        /// <summary>name of the sampled metric such as rss or cpu</summary>
+        std::string metric{};
+
+        [[nodiscard]] friend bool operator==(series_key const&, series_key const&) = default;
+    };
+
+    struct series_key_hash final
+    {
+        [[nodiscard]] METRICS_DLL std::size_t operator()(series_key const& key) const noexcept;
+    };
+
+    /// <summary>time_series for each sampled metric of each process</summary>
+    /// <remarks>
+    /// the lock is only taken to find, add or remove a series, a sampler which holds on to the series it appends
+    /// to never contends with readers; references remain valid until the series is removed, so whoever removes a
+    /// series must know nothing still appends to or reads it, as when its process has exited
+    /// </remarks>
+    class time_series_store final
+    {
+    public:
+        /// <summary>series for key, added if this is the first time key has been seen</summary>
+        [[nodiscard]] METRICS_DLL time_series& get_or_add(series_key const& key);
+        [[nodiscard]] METRICS_DLL time_series const* find(series_key const& key) const;
+        [[nodiscard]] METRICS_DLL std::vector<series_key> get_keys() const;
+
+        /// <summary>drops the series for key, invalidating any reference to it</summary>
+        /// <returns>true if there was a series for key</returns>
+        [[maybe_unused]] METRICS_DLL bool remove(series_key const& key);
+        /// <summary>drops every series of process_id, such as once the process has exited</summary>
+        /// <returns>number of series removed</returns>
+        [[maybe_unused]] METRICS_DLL std::size_t remove_process(std::uint64_t const process_id);
+        /// <summary>drops every series whose last sample is older than last_before, keeping those yet to be appended to</summary>
+        /// <remarks>for a sampler which can't tell when a process exits, a series that stops being appended to ages out</remarks>
+        /// <returns>number of series removed</returns>
+        [[maybe_unused]] METRICS_DLL std::size_t remove_idle(std::int64_t const last_before);
+
+        [[nodiscard]] METRICS_DLL std::size_t size() const;
+        /// <summary>bytes held by every series</summary>
+        [[nodiscard]] METRICS_DLL std::size_t get_memory_usage() const;
+
+        METRICS_DLL time_series_store() = default;
+        time_series_store(time_series_store const&) = delete;
+        time_series_store(time_series_store&&) noexcept = delete;
+        time_series_store& operator=(time_series_store const&) = delete;
+        time_series_store& operator=(time_series_store&&) noexcept = delete;
+        METRICS_DLL ~time_series_store() = default;
+
+    private:
+        mutable std::shared_mutex m_mutex{};
+        std::unordered_map<series_key, std::unique_ptr<time_series>, series_key_hash> m_series{};
+    };
+
+}
@@ -0,0 +1,105 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <sys/epoll.h>
+#include "shared/eventfd.h"
+#include "shared/posix_fd.h"
+#include "shared/shared_export.h"
+
+namespace shared::infrastructure
+{
+
+    /// <summary>
+    /// single threaded readiness loop over epoll, owns every registered descriptor and invokes its callback
+    /// when the descriptor becomes ready
+    /// </summary>
+    /// <remarks>
+    /// callbacks are stored once on registration, dispatching an event performs no allocation.
+    /// with the exception of stop() all members must be called from the thread running the loop
+    /// (or before it is started)
+    /// </remarks>
+    class epoll_reactor final
+    {
+    public:
+        using callback = std::function<void(int fd, std::uint32_t events)>;
+
+        /// <summary>identifies a registered descriptor, stale after remove()</summary>
+        struct registration final
+        {
+            std::uint32_t slot{};
+            std::uint32_t generation{};
+
+            bool operator==(registration const&) const noexcept = default;
+        };
+
+        template <typename TRAITS>
+        [[nodiscard]] std::optional<registration> add(unique_handle<TRAITS> handle, std::uint32_t const events, callback on_ready)
+        {
+            static_assert(std::is_same_v<typename TRAITS::Pointer, int>, "epoll_reactor only accepts file descriptor handles");
+            return add_descriptor(posix_fd(handle.Release()), events, std::move(on_ready));
+        }
+
+        [[nodiscard]] SHARED_DLL bool modify(registration const& id, std::uint32_t const events) noexcept;
+        /// <summary>unregisters and closes the descriptor, safe to call from within any callback</summary>
+        [[maybe_unused]] SHARED_DLL bool remove(registration const& id) noexcept;
+        [[nodiscard]] SHARED_DLL std::optional<int> get_descriptor(registration const& id) const noexcept;
+        [[nodiscard]] SHARED_DLL std::size_t size() const noexcept;
+
+        /// <summary>waits at most timeout for events and dispatches them, returns the number of callbacks invoked</summary>
+        [[maybe_unused]] SHARED_DLL std::size_t run_once(std::optional<std::chrono::milliseconds> const timeout = std::nullopt);
+        /// <summary>dispatches events until stop() is called</summary>
+        SHARED_DLL void run();
+        /// <summary>requests run() to return, may be called from any thread</summary>
+        SHARED_DLL void stop() noexcept;
+
+        SHARED_DLL explicit epoll_reactor(std::size_t const max_events_per_wait = 64);
+        epoll_reactor(epoll_reactor const&) = delete;
+        epoll_reactor(epoll_reactor&&) noexcept = delete;
+        epoll_reactor& operator=(epoll_reactor const&) = delete;
+        epoll_reactor& operator=(epoll_reactor&&) noexcept = delete;
+        SHARED_DLL ~epoll_reactor() = default;
+
+    private:
+        struct slot final
+        {
+            posix_fd descriptor{};
+            callback on_ready{};
+            std::uint32_t generation{};
+            bool release_after_dispatch{false};
+        };
+
+        posix_fd m_epoll;
+        eventfd m_wake;
+        std::vector<epoll_event> m_events;
+        std::deque<slot> m_slots{}; // deque so a running callback is never relocated by a registration made from within it
+        std::vector<std::uint32_t> m_free_slots{};
+        std::size_t m_registered{};
+        std::optional<std::uint32_t> m_dispatching{};
+        std::atomic<bool> m_stop_requested{false};
+
+        [[nodiscard]] SHARED_DLL std::optional<registration> add_descriptor(posix_fd descriptor, std::uint32_t const events, callback on_ready);
+        [[nodiscard]] slot* find(registration const& id) noexcept;
+        [[nodiscard]] slot const* find(registration const& id) const noexcept;
+        void release(std::uint32_t const index) noexcept;
+    };
+
+}
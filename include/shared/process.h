@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include "shared/shared_export.h"
@@ -25,7 +26,13 @@ namespace shared::model
         [[nodiscard]] SHARED_DLL virtual bool is_running() const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::optional<unsigned long> exit_code() const noexcept = 0;
         SHARED_DLL virtual void wait_for_exit() const noexcept = 0;
+        /// <summary>forcibly ends the process, used to stop a helper which has been cancelled or timed out</summary>
+        /// <returns>true if the process was running and has been told to terminate</returns>
+        [[maybe_unused]] SHARED_DLL virtual bool terminate(unsigned long const exit_code) noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& processName) const noexcept = 0;
+        /// <summary>memory committed to the process alone, cheap enough to sample every second</summary>
+        /// <returns>empty if the process has exited or can't be queried</returns>
+        [[nodiscard]] SHARED_DLL virtual std::optional<std::uint64_t> get_private_bytes() const noexcept = 0;
 
         SHARED_DLL process() = default;
         process(const process&) = delete;
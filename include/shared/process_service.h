@@ -28,6 +28,8 @@ namespace shared::service
 
         [[nodiscard]] SHARED_DLL virtual unique_process start_process(std::string_view const& filename, std::string_view const& arguments) const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::vector<unique_process> get_processes_by_name(std::string_view const& processName) const noexcept = 0;
+        /// <returns>the running process with process_id, or null if there is none or it can't be opened</returns>
+        [[nodiscard]] SHARED_DLL virtual unique_process get_process_by_id(unsigned long const process_id) const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& processName) const noexcept = 0;
 
         process_service() = default;
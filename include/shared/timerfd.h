@@ -0,0 +1,34 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <ctime>
+#include <sys/timerfd.h>
+#include "shared/posix_fd.h"
+
+namespace shared::infrastructure
+{
+
+    struct timerfd_traits : posix_fd_traits
+    {
+    };
+
+    using timerfd = unique_handle<timerfd_traits>;
+
+    [[nodiscard]] inline timerfd make_timerfd(clockid_t const clock = CLOCK_MONOTONIC, int const flags = TFD_NONBLOCK | TFD_CLOEXEC) noexcept
+    {
+        return timerfd(::timerfd_create(clock, flags));
+    }
+
+}
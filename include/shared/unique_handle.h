@@ -14,6 +14,7 @@
 #pragma once
 
 #include <new>
+#include <utility>
 
 namespace shared::infrastructure
 {
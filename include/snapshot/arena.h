@@ -0,0 +1,71 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <snapshot/snapshot_export.h>
+
+namespace snapshot
+{
+
+    /// <summary>
+    /// bump allocator handing out memory from large blocks which are only ever released together, so
+    /// everything allocated keeps its address until clear or destruction
+    /// </summary>
+    class arena final
+    {
+    public:
+        [[nodiscard]] SNAPSHOT_DLL void* allocate(std::size_t const size, std::size_t const alignment);
+
+        /// <summary>uninitialised storage for count objects which need no destruction</summary>
+        template <typename T>
+        [[nodiscard]] T* allocate_array(std::size_t const count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "arena never runs destructors");
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /// <summary>copy of text which remains valid for the lifetime of the arena's current contents</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::string_view copy(std::string_view const& text);
+
+        /// <summary>frees every block, invalidating all memory handed out</summary>
+        SNAPSHOT_DLL void clear() noexcept;
+
+        /// <summary>bytes held in blocks, used or not</summary>
+        [[nodiscard]] std::size_t get_memory_usage() const noexcept
+        {
+            return m_reserved;
+        }
+
+        /// <param name="block_size">size of each block, requests larger than this get a block of their own</param>
+        SNAPSHOT_DLL explicit arena(std::size_t const block_size = std::size_t{1} << 20U);
+        arena(arena const&) = delete;
+        SNAPSHOT_DLL arena(arena&& other) noexcept;
+        arena& operator=(arena const&) = delete;
+        SNAPSHOT_DLL arena& operator=(arena&& other) noexcept;
+        ~arena() = default;
+
+    private:
+        std::size_t m_block_size;
+        std::vector<std::unique_ptr<std::byte[]>> m_blocks{};
+        std::byte* m_next{};
+        std::size_t m_remaining{};
+        std::size_t m_reserved{};
+    };
+
+}
@@ -0,0 +1,112 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <snapshot/heap_snapshot.h>
+#include <snapshot/snapshot_diff.h>
+#include <snapshot/snapshot_export.h>
+#include <snapshot/trace_table.h>
+
+namespace snapshot
+{
+
+    /// <summary>
+    /// prefix tree of the frames of every trace, outermost frame first, with each node weighted by the bytes
+    /// outstanding beneath it; built once from a snapshot and then kept current by applying the diffs which follow
+    /// </summary>
+    /// <remarks>
+    /// the leaf of each trace is remembered once its path has been built, so applying a diff costs the depth
+    /// of each changed trace rather than a rebuild. nodes are never removed, those whose bytes fall to zero
+    /// are left out of the output instead. applying diffs to an empty graph gives a graph of growth alone;
+    /// output weighs each node by the positive bytes of the traces beneath it, so a stack that grew still
+    /// shows when shrinking stacks beside it cancel out its parent's net bytes
+    /// </remarks>
+    class flame_graph final
+    {
+    public:
+        /// <summary>adds the bytes of every site of snapshot</summary>
+        SNAPSHOT_DLL void add(heap_snapshot const& snapshot);
+        /// <summary>adds the change in bytes of every site of diff</summary>
+        /// <exception cref="std::invalid_argument">if diff was cut short by a top limit</exception>
+        SNAPSHOT_DLL void apply(snapshot_diff const& diff);
+
+        /// <summary>
+        /// Brendan Gregg's folded stacks, as read by flamegraph.pl: a line per stack of its frames separated by ';'
+        /// followed by the bytes allocated directly by it, only stacks with a positive weight are written
+        /// </summary>
+        /// <remarks>';' and control characters within a frame are written as '_', either would split the stack</remarks>
+        /// <param name="minimum_bytes">subtrees weighing less are left out, too narrow to be seen they only add to the output</param>
+        SNAPSHOT_DLL void write_folded(std::ostream& output, std::int64_t const minimum_bytes = 1) const;
+        /// <summary>nested {"name","value","children"} objects as read by d3-flame-graph, only nodes with a positive weight are written</summary>
+        /// <param name="minimum_bytes">subtrees weighing less are left out</param>
+        SNAPSHOT_DLL void write_json(std::ostream& output, std::int64_t const minimum_bytes = 1) const;
+
+        [[nodiscard]] std::int64_t get_total_bytes() const noexcept
+        {
+            return m_nodes.front().bytes;
+        }
+        /// <summary>number of nodes, the root aside</summary>
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_nodes.size() - 1U;
+        }
+
+        /// <remarks>traces must outlive the graph, and hold the traces of every snapshot and diff added to it</remarks>
+        SNAPSHOT_DLL explicit flame_graph(trace_table const& traces);
+
+    private:
+        static constexpr std::uint32_t NONE = 0xFFFFFFFFU;
+        /// <summary>frame of the leaf given to traces without frames, never an id of the trace_table, written as [unknown]</summary>
+        static constexpr frame_id UNKNOWN_FRAME = 0xFFFFFFFFU;
+
+        struct node final
+        {
+            frame_id frame{};
+            std::uint32_t parent{NONE};
+            std::uint32_t first_child{NONE};
+            std::uint32_t next_sibling{NONE};
+            /// <summary>bytes of this node and every node beneath it</summary>
+            std::int64_t bytes{};
+            /// <summary>bytes of the traces ending at this node</summary>
+            std::int64_t self_bytes{};
+            /// <summary>bytes of this node and every node beneath it counting only those with positive self_bytes, what the output is weighed by</summary>
+            std::int64_t grown_bytes{};
+        };
+
+        /// <summary>open addressing slot finding the child of a node by frame</summary>
+        struct child_slot final
+        {
+            std::uint64_t key{};
+            std::uint32_t node{NONE};
+        };
+
+        trace_table const& m_traces;
+        std::vector<node> m_nodes;
+        std::vector<child_slot> m_children;
+        std::vector<std::uint32_t> m_leaves{};
+
+        void add_bytes(trace_id const trace, std::int64_t const bytes);
+        [[nodiscard]] std::uint32_t get_leaf(trace_id const trace);
+        [[nodiscard]] std::uint32_t get_child(std::uint32_t const parent, frame_id const frame);
+        [[nodiscard]] std::string_view get_name(node const& current) const;
+        void write_folded(std::ostream& output, std::uint32_t const index, std::int64_t const minimum_bytes, std::string& path, std::string& buffer) const;
+        void write_json(std::ostream& output, std::uint32_t const index, std::int64_t const minimum_bytes, std::string& buffer) const;
+    };
+
+}
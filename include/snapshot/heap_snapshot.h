@@ -0,0 +1,71 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <snapshot/snapshot_export.h>
+#include <snapshot/trace_table.h>
+
+namespace snapshot
+{
+
+    /// <summary>outstanding allocations of one stack trace</summary>
+    struct allocation_site final
+    {
+        trace_id trace{};
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+
+        [[nodiscard]] friend bool operator==(allocation_site const&, allocation_site const&) = default;
+    };
+
+    /// <summary>heap of one process at one point in time, a flat array of sites ordered by trace id</summary>
+    class heap_snapshot final
+    {
+    public:
+        /// <summary>sites ordered by trace with each trace present at most once</summary>
+        [[nodiscard]] std::span<allocation_site const> get_sites() const noexcept
+        {
+            return m_sites;
+        }
+        [[nodiscard]] std::uint64_t get_total_bytes() const noexcept
+        {
+            return m_total_bytes;
+        }
+        [[nodiscard]] std::uint64_t get_total_count() const noexcept
+        {
+            return m_total_count;
+        }
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_sites.size();
+        }
+
+        SNAPSHOT_DLL heap_snapshot() = default;
+        /// <summary>sites in any order, those sharing a trace (umdh lists each heap separately) are summed</summary>
+        SNAPSHOT_DLL explicit heap_snapshot(std::vector<allocation_site> sites);
+
+    private:
+        std::vector<allocation_site> m_sites{};
+        std::uint64_t m_total_bytes{};
+        std::uint64_t m_total_count{};
+    };
+
+    /// <summary>parses umdh text into a snapshot, interning its traces into traces</summary>
+    [[nodiscard]] SNAPSHOT_DLL heap_snapshot read_heap_snapshot(std::string_view const& text, trace_table& traces);
+
+}
@@ -0,0 +1,52 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <snapshot/snapshot_export.h>
+
+namespace snapshot
+{
+
+    /// <summary>read only view of an entire file mapped into memory</summary>
+    class mapped_file final
+    {
+    public:
+        [[nodiscard]] std::string_view get_view() const noexcept
+        {
+            return std::string_view(static_cast<char const*>(m_data), m_size);
+        }
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        /// <exception cref="std::system_error">if the file can't be opened or mapped</exception>
+        SNAPSHOT_DLL explicit mapped_file(std::filesystem::path const& filename);
+        mapped_file(mapped_file const&) = delete;
+        SNAPSHOT_DLL mapped_file(mapped_file&& other) noexcept;
+        mapped_file& operator=(mapped_file const&) = delete;
+        SNAPSHOT_DLL mapped_file& operator=(mapped_file&& other) noexcept;
+        SNAPSHOT_DLL ~mapped_file();
+
+    private:
+        void const* m_data{};
+        std::size_t m_size{};
+
+        void unmap() noexcept;
+    };
+
+}
@@ -0,0 +1,79 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <future>
+#include <string_view>
+#include <vector>
+#include <snapshot/snapshot_export.h>
+#include <snapshot/umdh_parser.h>
+#include <tasks/executor.h>
+
+namespace snapshot
+{
+
+    /// <summary>
+    /// splits text into at most chunk_count pieces of roughly equal size, each at least minimum_size unless
+    /// text is smaller, every piece ends just before a line that isn't a frame so no record spans two
+    /// </summary>
+    [[nodiscard]] SNAPSHOT_DLL std::vector<std::string_view> split_records(std::string_view const& text, std::size_t const chunk_count,
+        std::size_t const minimum_size = std::size_t{1} << 20U);
+
+    /// <summary>
+    /// parses text in chunks on executor, each chunk accumulating into its own RESULT through
+    /// visitor(RESULT&, allocation_record const&) so the chunks share nothing while they run
+    /// </summary>
+    /// <returns>one RESULT per chunk in the order the chunks appear in text, for the caller to merge</returns>
+    /// <remarks>
+    /// visitor is called concurrently from several workers.  Called from one of executor's own workers the
+    /// chunks are parsed inline instead, waiting there on work queued behind the caller could never finish
+    /// </remarks>
+    template <typename RESULT, typename VISITOR>
+    [[nodiscard]] std::vector<RESULT> parse_parallel(tasks::executor& executor, std::string_view const& text, VISITOR const& visitor, std::size_t chunk_count = 0U)
+    {
+        if (chunk_count == 0U)
+            chunk_count = executor.get_worker_count() * 4U;
+
+        auto const parse_chunk = [&visitor](std::string_view const& chunk) {
+            RESULT result{};
+            umdh_reader reader(chunk);
+            allocation_record record{};
+            while (reader.next(record))
+                visitor(result, static_cast<allocation_record const&>(record));
+            return result;
+        };
+
+        auto const chunks = split_records(text, chunk_count);
+        std::vector<RESULT> results{};
+        results.reserve(chunks.size());
+        if (executor.is_worker_thread()) {
+            for (auto const& chunk : chunks)
+                results.push_back(parse_chunk(chunk));
+            return results;
+        }
+
+        std::vector<std::future<RESULT>> pending{};
+        pending.reserve(chunks.size());
+        for (auto const& chunk : chunks)
+            pending.push_back(executor.submit([&parse_chunk, chunk]() { return parse_chunk(chunk); }));
+
+        // every chunk refers to visitor and text, so all must finish before an exception is allowed out
+        for (auto const& chunk : pending)
+            chunk.wait();
+        for (auto& chunk : pending)
+            results.push_back(chunk.get());
+        return results;
+    }
+
+}
@@ -0,0 +1,94 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include <snapshot/snapshot_export.h>
+
+namespace snapshot
+{
+
+    struct retention_policy final
+    {
+        /// <summary>snapshots younger than this are all kept</summary>
+        std::chrono::system_clock::duration full_window{std::chrono::hours(24)};
+        /// <summary>snapshots younger than this, beyond full_window, are thinned to one an hour and older ones to one a day</summary>
+        std::chrono::system_clock::duration hourly_window{std::chrono::hours(24 * 30)};
+        /// <summary>bytes read and written rewriting segments per tick, the first segment of a tick is rewritten whatever its size</summary>
+        std::uint64_t bytes_per_tick{64U << 20U};
+        /// <summary>segments whose index is read per tick</summary>
+        std::size_t segments_per_tick{32U};
+    };
+
+    struct retention_report final
+    {
+        std::size_t segments_checked{};
+        std::size_t segments_rewritten{};
+        /// <summary>segments deleted as none of their snapshots were kept</summary>
+        std::size_t segments_removed{};
+        std::size_t snapshots_removed{};
+        std::uint64_t bytes_rewritten{};
+        /// <summary>every segment has been checked since the pass began, the next tick starts another</summary>
+        bool pass_complete{};
+    };
+
+    /// <summary>
+    /// thins an archive of snapshot files, each a segment of one series, down to a full resolution recent
+    /// window, hourly representatives beyond it and daily ones beyond that
+    /// </summary>
+    /// <remarks>
+    /// each tick continues a pass over the segments oldest first, reading only the index of a segment
+    /// which has nothing to drop; a segment which does is rewritten with just the snapshots it keeps, and
+    /// only the traces they reference, then renamed over the original so the rest of the archive is never
+    /// touched. the representative of an hour or day is its earliest snapshot, so the first snapshot of
+    /// the series, its baseline, is always kept.
+    /// a series is the *.snap files of the archive directory itself or of one of its subdirectories. within a
+    /// series a segment's name must sort after those of every segment written before it, naming each for the
+    /// UTC time of its first snapshot with fixed width fields, yyyymmddThhmmss.mmmZ.snap, does so; the pass
+    /// relies on it to carry buckets from one segment on to the next.
+    /// a segment without an index is left alone while it may still be written, once it hasn't been written
+    /// for full_window its writer is taken to have died and it's recovered block by block and rewritten whole
+    /// </remarks>
+    class retention_engine final
+    {
+    public:
+        /// <summary>checks and rewrites segments until the policy's budget for a tick is spent</summary>
+        /// <exception cref="std::runtime_error">if a segment is damaged</exception>
+        /// <exception cref="std::filesystem::filesystem_error">if the archive can't be listed or a segment replaced</exception>
+        [[nodiscard]] SNAPSHOT_DLL retention_report tick(std::chrono::system_clock::time_point const now);
+
+        /// <exception cref="std::invalid_argument">if a window isn't positive, hourly_window is shorter than full_window or segments_per_tick is zero</exception>
+        SNAPSHOT_DLL explicit retention_engine(std::filesystem::path directory, retention_policy const& policy = {});
+
+    private:
+        std::filesystem::path m_directory;
+        retention_policy m_policy;
+        /// <summary>segments left in the current pass, newest first so the next is taken from the back</summary>
+        std::vector<std::filesystem::path> m_pending{};
+        /// <summary>directory of the series the pass is in, the buckets of a series start afresh</summary>
+        std::filesystem::path m_series{};
+        /// <summary>last snapshot kept by the pass so far, the buckets of the next segment of the series continue from it</summary>
+        std::optional<std::chrono::system_clock::time_point> m_last_kept{};
+
+        void start_pass();
+        /// <summary>true if segment has its index, or hasn't been written to since full_window before now so never will</summary>
+        [[nodiscard]] bool is_finished(std::filesystem::path const& segment, std::chrono::system_clock::time_point const now) const;
+        [[nodiscard]] std::chrono::system_clock::duration get_resolution(std::chrono::system_clock::duration const age) const noexcept;
+    };
+
+}
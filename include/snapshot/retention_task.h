@@ -0,0 +1,41 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <snapshot/retention_engine.h>
+#include <tasks/task.h>
+
+namespace snapshot
+{
+
+    /// <summary>task running a tick of a retention_engine, schedule it periodically on a timer_scheduler to thin an archive in the background</summary>
+    class retention_task final : public tasks::task
+    {
+    public:
+        void process() override
+        {
+            static_cast<void>(m_engine.tick(std::chrono::system_clock::now()));
+        }
+
+        explicit retention_task(retention_engine& engine)
+            : m_engine{engine}
+        {
+        }
+
+    private:
+        retention_engine& m_engine;
+    };
+
+}
@@ -0,0 +1,65 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <snapshot/heap_snapshot.h>
+#include <snapshot/snapshot_export.h>
+
+namespace snapshot
+{
+
+    enum class site_change : std::uint8_t
+    {
+        CHANGED,
+        /// <summary>trace has no allocations in the earlier snapshot</summary>
+        NEW,
+        /// <summary>trace has no allocations in the later snapshot</summary>
+        VANISHED,
+    };
+
+    struct site_delta final
+    {
+        trace_id trace{};
+        site_change change{};
+        std::int64_t bytes_delta{};
+        std::int64_t count_delta{};
+        /// <summary>bytes outstanding in the later snapshot</summary>
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+    };
+
+    struct snapshot_diff final
+    {
+        /// <summary>sites whose bytes or count changed, largest growth first, ties in trace order</summary>
+        std::vector<site_delta> deltas{};
+        std::int64_t bytes_delta{};
+        std::int64_t count_delta{};
+        /// <summary>every site which differs, new and vanished included, whether or not a top limit cut it from deltas</summary>
+        std::size_t changed_sites{};
+        std::size_t new_sites{};
+        std::size_t vanished_sites{};
+    };
+
+    /// <summary>
+    /// compares two snapshots of one series by trace with a single merge join over their sorted sites
+    /// </summary>
+    /// <param name="top">if present only this many of the largest growths are kept, and only they are sorted</param>
+    /// <remarks>both snapshots must have interned their traces into the same trace_table</remarks>
+    [[nodiscard]] SNAPSHOT_DLL snapshot_diff diff_snapshots(heap_snapshot const& before, heap_snapshot const& after,
+        std::optional<std::size_t> const top = std::nullopt);
+
+}
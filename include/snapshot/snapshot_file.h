@@ -0,0 +1,167 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+#include <snapshot/heap_snapshot.h>
+#include <snapshot/mapped_file.h>
+#include <snapshot/snapshot_export.h>
+#include <snapshot/trace_table.h>
+
+namespace snapshot
+{
+
+    struct snapshot_info final
+    {
+        std::chrono::system_clock::time_point taken_at{};
+        std::uint64_t total_bytes{};
+        std::uint64_t total_count{};
+        std::size_t sites{};
+    };
+
+    enum class block_type : std::uint32_t
+    {
+        /// <summary>frames and traces first referenced by the snapshots which follow</summary>
+        DICTIONARY = 1,
+        /// <summary>keyframe, every site of a snapshot</summary>
+        SNAPSHOT = 2,
+        /// <summary>sites which changed, appeared or vanished since the previous snapshot</summary>
+        DELTA = 3,
+    };
+
+    /// <summary>where a block lives within a snapshot file, with the totals of a snapshot block</summary>
+    struct block_entry final
+    {
+        block_type type{};
+        std::uint32_t length{};
+        std::uint64_t offset{};
+        std::uint32_t checksum{};
+        snapshot_info info{};
+    };
+
+    /// <summary>
+    /// writes a series of snapshots as one file: a dictionary of frames and traces grows as traces are first
+    /// seen, each snapshot is stored as columns of delta encoded trace ids and varint bytes and counts, and
+    /// an index of every block with its checksum and the totals of each snapshot closes the file
+    /// </summary>
+    /// <remarks>
+    /// every keyframe_interval'th snapshot is a keyframe holding every site, those between hold only the sites
+    /// which differ from the snapshot before, which for a long running process is a small fraction of them.
+    /// blocks are written as snapshots are appended, nothing beyond the index and the previous snapshot's
+    /// sites is held in memory; a file whose index was never written is still readable block by block up to
+    /// its first damaged block
+    /// </remarks>
+    class snapshot_file_writer final
+    {
+    public:
+        /// <summary>appends snapshot, preceded by a dictionary block if it references traces not yet written</summary>
+        /// <param name="traces">table the snapshot's traces were interned into, the same for every append</param>
+        /// <exception cref="std::invalid_argument">if the writer has been closed</exception>
+        /// <exception cref="std::ios_base::failure">if the write fails</exception>
+        SNAPSHOT_DLL void append(heap_snapshot const& snapshot, std::chrono::system_clock::time_point const taken_at, trace_table const& traces);
+
+        /// <summary>writes the index, appending is no longer possible afterwards</summary>
+        SNAPSHOT_DLL void close();
+
+        [[nodiscard]] std::uint64_t get_size() const noexcept
+        {
+            return m_offset;
+        }
+
+        /// <summary>creates filename, replacing any existing file</summary>
+        /// <param name="keyframe_interval">snapshots per keyframe, 1 writes every snapshot in full</param>
+        /// <exception cref="std::invalid_argument">if keyframe_interval is zero</exception>
+        /// <exception cref="std::ios_base::failure">if the file can't be created</exception>
+        SNAPSHOT_DLL explicit snapshot_file_writer(std::filesystem::path const& filename, std::size_t const keyframe_interval = 16U);
+        snapshot_file_writer(snapshot_file_writer const&) = delete;
+        snapshot_file_writer(snapshot_file_writer&&) noexcept = delete;
+        snapshot_file_writer& operator=(snapshot_file_writer const&) = delete;
+        snapshot_file_writer& operator=(snapshot_file_writer&&) noexcept = delete;
+        /// <summary>closes the file if close hasn't been called, errors are discarded</summary>
+        SNAPSHOT_DLL ~snapshot_file_writer();
+
+    private:
+        std::ofstream m_file;
+        std::size_t m_keyframe_interval;
+        std::uint64_t m_offset{};
+        std::vector<block_entry> m_index{};
+        std::size_t m_frames_written{};
+        std::size_t m_traces_written{};
+        std::string m_buffer{};
+        std::vector<allocation_site> m_previous{};
+        std::size_t m_since_keyframe{};
+        bool m_closed{};
+
+        void write_dictionary(trace_table const& traces);
+        void write_delta(std::span<allocation_site const> const sites);
+        void write_block(block_type const type, snapshot_info const& info);
+    };
+
+    /// <summary>reads a file written by snapshot_file_writer through a read only mapping</summary>
+    class snapshot_file_reader final
+    {
+    public:
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_snapshots.size();
+        }
+        /// <summary>totals of a snapshot, read from the index without touching the snapshot itself</summary>
+        /// <exception cref="std::invalid_argument">if index is out of range</exception>
+        [[nodiscard]] SNAPSHOT_DLL snapshot_info const& get_info(std::size_t const index) const;
+
+        /// <summary>decodes the nearest keyframe at or before index and applies the deltas which follow it</summary>
+        /// <exception cref="std::invalid_argument">if index is out of range</exception>
+        /// <exception cref="std::runtime_error">if a block is damaged</exception>
+        [[nodiscard]] SNAPSHOT_DLL heap_snapshot read_snapshot(std::size_t const index) const;
+
+        /// <summary>interns every trace in the file into traces so their ids match those of the snapshots read</summary>
+        /// <exception cref="std::invalid_argument">if traces isn't empty</exception>
+        /// <exception cref="std::runtime_error">if a dictionary block is damaged</exception>
+        SNAPSHOT_DLL void read_traces(trace_table& traces) const;
+
+        /// <summary>true if the index was missing or damaged and the blocks were found by scanning instead</summary>
+        [[nodiscard]] bool was_recovered() const noexcept
+        {
+            return m_recovered;
+        }
+
+        /// <summary>true if filename ends in the trailer written by snapshot_file_writer::close</summary>
+        /// <remarks>
+        /// reads only the trailer and doesn't map the file, so it's safe on a segment whose writer is still
+        /// appending; windows won't map a file open for writing and scanning one would read all of it
+        /// </remarks>
+        [[nodiscard]] SNAPSHOT_DLL static bool is_closed(std::filesystem::path const& filename);
+
+        /// <exception cref="std::system_error">if the file can't be mapped</exception>
+        /// <exception cref="std::runtime_error">if the file isn't a snapshot file</exception>
+        SNAPSHOT_DLL explicit snapshot_file_reader(std::filesystem::path const& filename);
+
+    private:
+        mapped_file m_file;
+        std::vector<block_entry> m_snapshots{};
+        std::vector<block_entry> m_dictionaries{};
+        bool m_recovered{};
+
+        [[nodiscard]] bool read_index();
+        void scan_blocks();
+        [[nodiscard]] std::string_view get_payload(block_entry const& entry) const;
+    };
+
+}
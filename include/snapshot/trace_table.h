@@ -0,0 +1,125 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <snapshot/arena.h>
+#include <snapshot/snapshot_export.h>
+#include <snapshot/umdh_parser.h>
+
+namespace snapshot
+{
+
+    using frame_id = std::uint32_t;
+    /// <summary>identifies a distinct stack trace, equal traces within one table always have equal ids</summary>
+    using trace_id = std::uint32_t;
+
+    /// <summary>
+    /// interns the frames and stack traces of a series of snapshots, each distinct frame and trace is stored
+    /// once in an arena and given a dense id so traces compare as integers
+    /// </summary>
+    /// <remarks>
+    /// ids are allocated sequentially from zero and never reused, views returned stay valid until clear or
+    /// destruction, which release everything at once.  Not thread safe, interning is expected to happen
+    /// on the thread which owns the series
+    /// </remarks>
+    class trace_table final
+    {
+    public:
+        /// <summary>
+        /// interns the trace of record, its umdh backtrace id is remembered so later snapshots of the same
+        /// process find the trace without hashing its frames again
+        /// </summary>
+        /// <remarks>
+        /// umdh ids are only unique within one run of a process, a restarted process needs a new table or clear
+        /// </remarks>
+        [[nodiscard]] SNAPSHOT_DLL trace_id intern(allocation_record const& record);
+        [[nodiscard]] SNAPSHOT_DLL trace_id intern(frame_list const& frames);
+        [[nodiscard]] SNAPSHOT_DLL trace_id intern(std::span<std::string_view const> const frames);
+
+        /// <exception cref="std::invalid_argument">if id was not returned by this table</exception>
+        [[nodiscard]] SNAPSHOT_DLL std::span<frame_id const> get_trace(trace_id const id) const;
+        /// <exception cref="std::invalid_argument">if id was not returned by this table</exception>
+        [[nodiscard]] SNAPSHOT_DLL std::string_view get_frame(frame_id const id) const;
+
+        /// <summary>number of distinct traces</summary>
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_traces.size();
+        }
+        [[nodiscard]] std::size_t get_frame_count() const noexcept
+        {
+            return m_frames.size();
+        }
+        [[nodiscard]] SNAPSHOT_DLL std::size_t get_memory_usage() const noexcept;
+
+        /// <summary>forgets every frame and trace, releasing their memory in bulk</summary>
+        /// <exception cref="std::bad_alloc">if the emptied hash tables can't be allocated, the table is left unchanged</exception>
+        SNAPSHOT_DLL void clear();
+
+        SNAPSHOT_DLL trace_table();
+        trace_table(trace_table const&) = delete;
+        /// <remarks>other is left empty with hash tables of its own, ready to intern again</remarks>
+        /// <exception cref="std::bad_alloc">if other's emptied hash tables can't be allocated, other is left unchanged</exception>
+        SNAPSHOT_DLL trace_table(trace_table&& other);
+        trace_table& operator=(trace_table const&) = delete;
+        /// <remarks>other is left empty with hash tables of its own, ready to intern again</remarks>
+        /// <exception cref="std::bad_alloc">if other's emptied hash tables can't be allocated, both tables are left unchanged</exception>
+        SNAPSHOT_DLL trace_table& operator=(trace_table&& other);
+        ~trace_table() = default;
+
+    private:
+        /// <summary>open addressing slot, the hash is kept so most mismatches and every rehash avoid the key</summary>
+        struct slot final
+        {
+            std::uint32_t hash{};
+            std::uint32_t id{};
+        };
+        /// <summary>frames are compared in place so a lookup touches only the slot and the arena</summary>
+        struct frame_slot final
+        {
+            std::uint32_t hash{};
+            std::uint32_t id{};
+            std::string_view text{};
+        };
+        struct backtrace_slot final
+        {
+            std::uint32_t hash{};
+            std::uint32_t id{};
+            std::uint64_t backtrace_id{};
+        };
+        struct trace final
+        {
+            frame_id const* frames{};
+            std::uint32_t length{};
+        };
+
+        arena m_arena{};
+        std::vector<std::string_view> m_frames{};
+        std::vector<frame_slot> m_frame_slots{};
+        std::vector<trace> m_traces{};
+        std::vector<slot> m_trace_slots{};
+        std::vector<backtrace_slot> m_backtrace_slots{};
+        std::size_t m_backtrace_count{};
+        std::vector<frame_id> m_scratch{};
+
+        void swap(trace_table& other) noexcept;
+        [[nodiscard]] frame_id intern_frame(std::string_view const& frame);
+        [[nodiscard]] trace_id intern_trace();
+    };
+
+}
@@ -0,0 +1,117 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <snapshot/heap_snapshot.h>
+#include <snapshot/snapshot_diff.h>
+#include <snapshot/snapshot_export.h>
+
+namespace snapshot
+{
+
+    struct trend_thresholds final
+    {
+        /// <summary>number of most recent snapshots the regression is fitted over</summary>
+        std::size_t window{16U};
+        /// <summary>bytes per snapshot</summary>
+        double minimum_slope{1.0};
+        double minimum_r_squared{0.8};
+        /// <summary>consecutive snapshots in which the site grew, snapshots where it didn't change don't break a streak</summary>
+        std::uint32_t minimum_growth_streak{3U};
+        /// <summary>snapshots which must have been seen before anything is flagged</summary>
+        std::size_t minimum_samples{4U};
+    };
+
+    struct site_trend final
+    {
+        trace_id trace{};
+        /// <summary>least squares growth in bytes per snapshot over the window</summary>
+        double slope{};
+        double r_squared{};
+        std::uint64_t bytes{};
+        std::uint32_t growth_streak{};
+        std::uint32_t increases{};
+        std::uint32_t decreases{};
+    };
+
+    /// <summary>
+    /// per trace growth trends over the last few snapshots of a series, the leak detector alerts are raised from
+    /// </summary>
+    /// <remarks>
+    /// each trace's history is held as the runs of snapshots over which its bytes didn't change, so the
+    /// regression sums come from closed forms rather than stored samples.  A trace which hasn't changed
+    /// within the window is flat and needs no work, so each snapshot costs time in the number of traces
+    /// which changed within the window rather than the size of the heap
+    /// </remarks>
+    class trend_engine final
+    {
+    public:
+        /// <summary>advances by one snapshot</summary>
+        /// <param name="diff">complete diff of the new snapshot against the previous one</param>
+        /// <exception cref="std::invalid_argument">if diff was cut short by a top limit</exception>
+        SNAPSHOT_DLL void add(snapshot_diff const& diff);
+
+        /// <summary>trend of trace as of the latest snapshot, empty if its id is beyond any seen so far</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::optional<site_trend> get_trend(trace_id const trace) const;
+        /// <summary>sites currently meeting every threshold, steepest first</summary>
+        [[nodiscard]] std::vector<site_trend> const& get_flagged() const noexcept
+        {
+            return m_flagged;
+        }
+        /// <summary>snapshots seen, the baseline included</summary>
+        [[nodiscard]] std::size_t get_snapshot_count() const noexcept
+        {
+            return static_cast<std::size_t>(m_current) + 1U;
+        }
+
+        /// <exception cref="std::invalid_argument">if the window is shorter than 2 snapshots</exception>
+        SNAPSHOT_DLL explicit trend_engine(heap_snapshot const& baseline, trend_thresholds const& thresholds = trend_thresholds{});
+
+    private:
+        /// <summary>
+        /// run of snapshots, from start until the next run begins, over which a trace held value bytes; every
+        /// trace begins with a run from the baseline, of zero bytes if it wasn't in it
+        /// </summary>
+        struct run final
+        {
+            std::uint32_t start{};
+            std::uint64_t value{};
+        };
+        struct trace_state final
+        {
+            /// <summary>earlier runs still overlapping the window, oldest first</summary>
+            std::vector<run> history{};
+            run current{};
+            std::uint32_t growth_streak{};
+            std::uint32_t increases{};
+            std::uint32_t decreases{};
+            bool active{};
+        };
+
+        trend_thresholds m_thresholds;
+        std::vector<trace_state> m_traces{};
+        /// <summary>traces with a change inside the window, the only ones whose trend can be anything but flat</summary>
+        std::vector<trace_id> m_active{};
+        std::vector<site_trend> m_flagged{};
+        std::uint32_t m_current{};
+
+        [[nodiscard]] std::uint32_t get_window_start() const noexcept;
+        [[nodiscard]] site_trend evaluate(trace_id const trace, trace_state const& state) const noexcept;
+        [[nodiscard]] bool is_flagged(site_trend const& trend) const noexcept;
+    };
+
+}
@@ -0,0 +1,183 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <snapshot/snapshot_export.h>
+
+namespace snapshot
+{
+
+    /// <summary>forward iterator over the frame lines of a record, each trimmed of surrounding whitespace</summary>
+    class frame_iterator final
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::string_view const*;
+        using reference = std::string_view const&;
+
+        [[nodiscard]] reference operator*() const noexcept
+        {
+            return m_frame;
+        }
+        [[nodiscard]] pointer operator->() const noexcept
+        {
+            return &m_frame;
+        }
+        SNAPSHOT_DLL frame_iterator& operator++() noexcept;
+        frame_iterator operator++(int) noexcept
+        {
+            auto const previous = *this;
+            ++*this;
+            return previous;
+        }
+        [[nodiscard]] friend bool operator==(frame_iterator const& left, frame_iterator const& right) noexcept
+        {
+            return left.m_remaining.data() == right.m_remaining.data() && left.m_frame.data() == right.m_frame.data();
+        }
+
+        frame_iterator() noexcept = default;
+        explicit frame_iterator(std::string_view const& frames) noexcept
+            : m_remaining{frames}
+        {
+            ++*this;
+        }
+
+    private:
+        std::string_view m_remaining{};
+        std::string_view m_frame{};
+    };
+
+    /// <summary>the frame lines of a record exactly as they appear in the snapshot</summary>
+    struct frame_list final
+    {
+        std::string_view text{};
+
+        [[nodiscard]] frame_iterator begin() const noexcept
+        {
+            return frame_iterator(text);
+        }
+        [[nodiscard]] frame_iterator end() const noexcept
+        {
+            return frame_iterator();
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return begin() == end();
+        }
+    };
+
+    /// <summary>one allocation site of a heap snapshot, views refer into the buffer which was parsed</summary>
+    struct allocation_record final
+    {
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+        std::uint64_t backtrace_id{};
+        frame_list frames{};
+    };
+
+    /// <summary>
+    /// pull parser for the text written by umdh -p, records are read in place without copying or allocating
+    /// </summary>
+    /// <remarks>
+    /// both the summarised form, "BYTES bytes in 0xCOUNT allocations (@ ...) by: BackTraceID", and the per
+    /// allocation form, "BYTES bytes + OVERHEAD at ADDRESS by BackTraceID", are recognised; each is followed
+    /// by indented frame lines.  Anything else, comments, heap banners and symbol loading noise, is skipped
+    /// </remarks>
+    class umdh_reader final
+    {
+    public:
+        /// <summary>reads the next record</summary>
+        /// <returns>
+        /// false once text is exhausted or, when text isn't final, when the next record might continue past it
+        /// </returns>
+        [[nodiscard]] SNAPSHOT_DLL bool next(allocation_record& record) noexcept;
+
+        /// <summary>length of the prefix of text which has been read, everything after it is yet to be seen</summary>
+        [[nodiscard]] std::size_t get_consumed() const noexcept
+        {
+            return m_position;
+        }
+
+        /// <param name="text">snapshot text, must outlive every record read from it</param>
+        /// <param name="final">false if text may be followed by more, in which case a record or line at its end is left unread</param>
+        explicit umdh_reader(std::string_view const& text, bool const final = true) noexcept
+            : m_text{text}
+            , m_final{final}
+        {
+        }
+
+    private:
+        std::string_view m_text;
+        bool m_final;
+        std::size_t m_position{};
+    };
+
+    /// <summary>
+    /// parses umdh output as it arrives in arbitrary chunks, such as from a pipe to the child process
+    /// </summary>
+    /// <remarks>
+    /// records are read from the chunk itself where possible, only the one record straddling two chunks is
+    /// copied.  Records passed to the visitor are only valid for the duration of the call
+    /// </remarks>
+    class umdh_stream_parser final
+    {
+    public:
+        template <typename VISITOR>
+        void feed(std::string_view chunk, VISITOR&& visitor)
+        {
+            if (!m_pending.empty()) {
+                // the pending record ends at the first line which isn't a frame, only that much is copied
+                auto const boundary = find_record_boundary(chunk);
+                if (boundary == std::string_view::npos) {
+                    m_pending.append(chunk);
+                    return;
+                }
+                m_pending.append(chunk.substr(0U, boundary));
+                chunk.remove_prefix(boundary);
+                finish(visitor);
+            }
+
+            umdh_reader reader(chunk, false);
+            allocation_record record{};
+            while (reader.next(record))
+                visitor(static_cast<allocation_record const&>(record));
+            m_pending.assign(chunk.substr(reader.get_consumed()));
+        }
+
+        /// <summary>parses whatever remains once the stream has ended</summary>
+        template <typename VISITOR>
+        void finish(VISITOR&& visitor)
+        {
+            std::string_view const pending(m_pending);
+            umdh_reader reader(pending);
+            allocation_record record{};
+            while (reader.next(record))
+                visitor(static_cast<allocation_record const&>(record));
+            m_pending.clear();
+        }
+
+    private:
+        std::string m_pending{};
+
+        /// <summary>length of the prefix of chunk which completes the pending text, npos if all of it may be needed</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::size_t find_record_boundary(std::string_view const& chunk) const noexcept;
+    };
+
+}
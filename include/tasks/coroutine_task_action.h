@@ -0,0 +1,82 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <memory>
+#include <stop_token>
+#include <type_traits>
+#include <tasks/executor.h>
+#include <tasks/lazy.h>
+#include <tasks/task_action.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>
+    /// coroutine counterpart of task_action; process returns a lazily started awaitable so a multi step action
+    /// can suspend between steps rather than holding a thread while it waits
+    /// </summary>
+    /// <remarks>
+    /// an action overriding only one of the process overloads should bring the other into scope with
+    /// using coroutine_task_action::process, otherwise it is hidden from callers holding the derived type
+    /// </remarks>
+    class coroutine_task_action
+    {
+    public:
+        virtual lazy<action_result> process() = 0;
+        /// <summary>as process, finishing early once stop_token is signalled</summary>
+        /// <remarks>the default ignores stop_token</remarks>
+        virtual lazy<action_result> process(std::stop_token stop_token)
+        {
+            static_cast<void>(stop_token);
+            return process();
+        }
+
+        coroutine_task_action(coroutine_task_action const&) = default;
+        coroutine_task_action(coroutine_task_action&&) noexcept = default;
+        coroutine_task_action& operator=(coroutine_task_action const&) = default;
+        coroutine_task_action& operator=(coroutine_task_action&&) noexcept = default;
+        virtual ~coroutine_task_action() = default;
+
+    protected:
+        coroutine_task_action() = default;
+    };
+
+    template<typename COROUTINE_TASK_ACTION>
+    concept CoroutineTaskAction = requires(COROUTINE_TASK_ACTION a) {
+        requires std::is_same<lazy<action_result>, decltype(std::declval<COROUTINE_TASK_ACTION>().process())>::value;
+    };
+
+    /// <summary>exposes a coroutine_task_action through the future based task_action interface</summary>
+    /// <remarks>each call to process_async starts the coroutine on a worker of the provided executor</remarks>
+    class coroutine_action_adapter final : public task_action
+    {
+    public:
+        TASKS_DLL std::future<action_result> process_async() override;
+        TASKS_DLL std::future<action_result> process_async(std::stop_token stop_token) override;
+
+        TASKS_DLL explicit coroutine_action_adapter(std::shared_ptr<coroutine_task_action> action, executor& executor);
+        TASKS_DLL coroutine_action_adapter(coroutine_action_adapter const&) = default;
+        TASKS_DLL coroutine_action_adapter(coroutine_action_adapter&&) noexcept = default;
+        coroutine_action_adapter& operator=(coroutine_action_adapter const&) = delete;
+        coroutine_action_adapter& operator=(coroutine_action_adapter&&) noexcept = delete;
+        TASKS_DLL ~coroutine_action_adapter() override = default;
+
+    private:
+        std::shared_ptr<coroutine_task_action> m_action;
+        executor& m_executor;
+    };
+
+}
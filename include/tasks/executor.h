@@ -0,0 +1,115 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <tasks/tasks_export.h>
+#include <tasks/work_item.h>
+
+namespace tasks
+{
+
+    /// <summary>point in time counters of an executor</summary>
+    struct executor_statistics final
+    {
+        std::uint64_t submitted{};
+        /// <summary>work taken from a queue to run, including any still running</summary>
+        std::uint64_t executed{};
+        std::uint64_t stolen{};
+        std::vector<std::size_t> queue_depths{};
+    };
+
+    /// <summary>
+    /// fixed pool of worker threads, each owning a deque of work; owners work from the front of their
+    /// deque while idle workers steal from the back of the others
+    /// </summary>
+    /// <remarks>
+    /// intended to be the single place task_action implementations run their work so that process_async
+    /// doesn't spawn a thread per call via std::async
+    /// </remarks>
+    class executor final
+    {
+    public:
+        /// <summary>queues work and returns a future completed with its result (or exception)</summary>
+        template <typename CALLABLE>
+        [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<CALLABLE>&>> submit(CALLABLE&& work)
+        {
+            using result_type = std::invoke_result_t<std::decay_t<CALLABLE>&>;
+
+            std::promise<result_type> promise;
+            auto future = promise.get_future();
+            post([promise = std::move(promise), work = std::forward<CALLABLE>(work)]() mutable {
+                try {
+                    if constexpr (std::is_void_v<result_type>) {
+                        work();
+                        promise.set_value();
+                    } else {
+                        promise.set_value(work());
+                    }
+                } catch (...) {
+                    promise.set_exception(std::current_exception());
+                }
+            });
+            return future;
+        }
+
+        /// <summary>queues work without a means of observing completion, exceptions thrown by item are discarded</summary>
+        /// <remarks>work posted from a worker thread is queued on that worker, otherwise workers are chosen round robin</remarks>
+        TASKS_DLL void post(work_item item);
+
+        [[nodiscard]] TASKS_DLL std::size_t get_worker_count() const noexcept;
+        /// <summary>number of queued items which have yet to start</summary>
+        [[nodiscard]] TASKS_DLL std::size_t get_queue_depth() const noexcept;
+        [[nodiscard]] TASKS_DLL std::uint64_t get_steal_count() const noexcept;
+        [[nodiscard]] TASKS_DLL executor_statistics get_statistics() const;
+
+        /// <summary>true if the calling thread is one of this executors workers</summary>
+        [[nodiscard]] TASKS_DLL bool is_worker_thread() const noexcept;
+
+        TASKS_DLL explicit executor(std::size_t const worker_count = std::thread::hardware_concurrency());
+        executor(executor const&) = delete;
+        executor(executor&&) noexcept = delete;
+        executor& operator=(executor const&) = delete;
+        executor& operator=(executor&&) noexcept = delete;
+        /// <summary>runs all remaining queued work then joins the workers</summary>
+        TASKS_DLL ~executor();
+
+    private:
+        struct worker;
+
+        std::vector<std::unique_ptr<worker>> m_workers{};
+        std::atomic<std::size_t> m_pending{};
+        std::atomic<std::size_t> m_next_worker{};
+        std::atomic<std::uint64_t> m_submitted{};
+        std::atomic<std::uint64_t> m_executed{};
+        std::atomic<std::uint64_t> m_stolen{};
+        std::atomic<bool> m_stopping{false};
+        std::mutex m_idle_mutex{};
+        std::condition_variable m_idle{};
+
+        void run_worker(std::size_t const index);
+        [[nodiscard]] bool try_pop(std::size_t const index, work_item& item);
+        [[nodiscard]] bool try_steal(std::size_t const thief, work_item& item);
+        void wake_one();
+    };
+
+}
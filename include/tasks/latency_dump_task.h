@@ -0,0 +1,44 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <ostream>
+#include <tasks/latency_recorder.h>
+#include <tasks/task.h>
+
+namespace tasks
+{
+
+    /// <summary>task writing a latency_recorder's summaries to a stream, schedule it periodically on a timer_scheduler for a regular dump</summary>
+    class latency_dump_task final : public task
+    {
+    public:
+        void process() override
+        {
+            m_recorder.dump(m_output);
+            m_output.flush();
+        }
+
+        explicit latency_dump_task(latency_recorder const& recorder, std::ostream& output)
+            : m_recorder{recorder}
+            , m_output{output}
+        {
+        }
+
+    private:
+        latency_recorder const& m_recorder;
+        std::ostream& m_output;
+    };
+
+}
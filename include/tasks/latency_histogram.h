@@ -0,0 +1,82 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>
+    /// HDR style histogram of durations; buckets are linear within each power of two so every recorded value is
+    /// kept to within 1/64 (about 1.6%) of its true value while the whole range up to an hour fits in a fixed array
+    /// </summary>
+    /// <remarks>not thread safe, latency_recorder shards these per thread and merges them on read</remarks>
+    class latency_histogram final
+    {
+    public:
+        static constexpr std::uint32_t SUB_BUCKET_BITS = 7U;
+        static constexpr std::uint32_t SUB_BUCKETS = 1U << SUB_BUCKET_BITS;
+        static constexpr std::uint32_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2U;
+        /// <summary>largest value kept exactly, larger values are clamped; 2^42 nanoseconds is a little over an hour</summary>
+        static constexpr std::uint64_t MAXIMUM_VALUE = (std::uint64_t{1} << 42U) - 1U;
+        static constexpr std::uint32_t BUCKETS = SUB_BUCKETS + (42U - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+
+        TASKS_DLL void record(std::chrono::nanoseconds const value) noexcept;
+        /// <summary>adds count values to bucket, those values are then only known to the precision of the bucket</summary>
+        TASKS_DLL void add_to_bucket(std::uint32_t const bucket, std::uint64_t const count) noexcept;
+        /// <summary>adds every value recorded in other to this</summary>
+        TASKS_DLL void merge(latency_histogram const& other) noexcept;
+        TASKS_DLL void reset() noexcept;
+
+        /// <summary>smallest recorded value such that percentile percent of values are at or below it</summary>
+        [[nodiscard]] TASKS_DLL std::chrono::nanoseconds get_percentile(double const percentile) const noexcept;
+        [[nodiscard]] TASKS_DLL std::chrono::nanoseconds get_minimum() const noexcept;
+        [[nodiscard]] TASKS_DLL std::chrono::nanoseconds get_maximum() const noexcept;
+        [[nodiscard]] TASKS_DLL std::chrono::nanoseconds get_mean() const noexcept;
+        [[nodiscard]] TASKS_DLL std::uint64_t get_count() const noexcept;
+
+        [[nodiscard]] static constexpr std::uint32_t bucket_of(std::uint64_t value) noexcept
+        {
+            if (value > MAXIMUM_VALUE)
+                value = MAXIMUM_VALUE;
+            if (value < SUB_BUCKETS)
+                return static_cast<std::uint32_t>(value);
+
+            auto const shift = static_cast<std::uint32_t>(std::bit_width(value)) - SUB_BUCKET_BITS;
+            return SUB_BUCKETS + (shift - 1U) * HALF_SUB_BUCKETS + static_cast<std::uint32_t>((value >> shift) - HALF_SUB_BUCKETS);
+        }
+        /// <summary>largest value which is recorded in bucket</summary>
+        [[nodiscard]] static constexpr std::uint64_t highest_in_bucket(std::uint32_t const bucket) noexcept
+        {
+            if (bucket < SUB_BUCKETS)
+                return bucket;
+            auto const shift = (bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1U;
+            auto const sub_bucket = static_cast<std::uint64_t>((bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS);
+            return ((sub_bucket + 1U) << shift) - 1U;
+        }
+
+    private:
+        std::array<std::uint64_t, BUCKETS> m_counts{};
+        std::uint64_t m_count{};
+        std::uint64_t m_total{};
+        std::uint64_t m_minimum{UINT64_MAX};
+        std::uint64_t m_maximum{};
+    };
+
+}
@@ -0,0 +1,125 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include <tasks/latency_histogram.h>
+#include <tasks/task.h>
+#include <tasks/task_observer.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>which interval of a task run a latency covers</summary>
+    enum class latency_metric
+    {
+        /// <summary>from becoming ready to starting to run</summary>
+        QUEUE,
+        /// <summary>from starting to run to completing or failing</summary>
+        RUN,
+        /// <summary>from becoming ready to completing or failing</summary>
+        END_TO_END,
+    };
+
+    [[nodiscard]] TASKS_DLL char const* to_string(latency_metric const metric) noexcept;
+
+    /// <summary>headline figures of one metric of one task type</summary>
+    struct latency_summary final
+    {
+        std::type_index task_type;
+        latency_metric metric;
+        std::uint64_t count;
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p90;
+        std::chrono::nanoseconds p99;
+        std::chrono::nanoseconds maximum;
+    };
+
+    /// <summary>
+    /// records queue, run and end to end latency histograms per concrete task type; added as an observer it
+    /// records every run of the tasks it observes
+    /// </summary>
+    /// <remarks>
+    /// each thread records into its own histograms using plain relaxed stores, so recording takes no lock once a
+    /// thread has seen a task type; the per thread histograms are merged whenever they are read
+    /// </remarks>
+    class latency_recorder final : public task_observer
+    {
+    public:
+        TASKS_DLL void on_transition(task& source, task_state const previous, task_state const current) noexcept override;
+
+        TASKS_DLL void record(std::type_index const& task_type, latency_metric const metric, std::chrono::nanoseconds const value) noexcept;
+
+        /// <summary>every value recorded for metric of task_type, merged across threads</summary>
+        [[nodiscard]] TASKS_DLL latency_histogram get_histogram(std::type_index const& task_type, latency_metric const metric) const;
+        template <Task TASK>
+        [[nodiscard]] latency_histogram get_histogram(latency_metric const metric) const
+        {
+            return get_histogram(std::type_index(typeid(TASK)), metric);
+        }
+        [[nodiscard]] TASKS_DLL std::vector<latency_summary> get_summaries() const;
+        /// <summary>writes one line per task type and metric with its count, p50, p90, p99 and maximum in microseconds</summary>
+        /// <remarks>intended to be called periodically, for example from a latency_dump_task on a timer_scheduler</remarks>
+        TASKS_DLL void dump(std::ostream& output) const;
+
+        TASKS_DLL explicit latency_recorder();
+        latency_recorder(latency_recorder const&) = delete;
+        latency_recorder(latency_recorder&&) noexcept = delete;
+        latency_recorder& operator=(latency_recorder const&) = delete;
+        latency_recorder& operator=(latency_recorder&&) noexcept = delete;
+        TASKS_DLL ~latency_recorder() override;
+
+    private:
+        static constexpr std::size_t METRICS = 3;
+
+        /// <summary>histogram written by a single thread and read by any</summary>
+        struct shard_histogram final
+        {
+            std::array<std::atomic<std::uint64_t>, latency_histogram::BUCKETS> counts{};
+        };
+        using shard_histograms = std::array<shard_histogram, METRICS>;
+        struct thread_shard final
+        {
+            // only taken by the owning thread when it first sees a task type, and by readers
+            mutable std::mutex mutex{};
+            std::unordered_map<std::type_index, std::unique_ptr<shard_histograms>> types{};
+        };
+        struct cached_shard final
+        {
+            std::uint64_t recorder_id{};
+            thread_shard* shard{};
+        };
+
+        /// <summary>never reused, tells a thread's cached shard apart from one left by an earlier recorder in the same slot</summary>
+        std::uint64_t m_id;
+        /// <summary>index of this recorder in each thread's shard cache, reused once the recorder is destroyed</summary>
+        std::size_t m_slot;
+        mutable std::mutex m_mutex{};
+        std::vector<std::unique_ptr<thread_shard>> m_shards{};
+
+        [[nodiscard]] thread_shard& get_thread_shard();
+    };
+
+}
@@ -0,0 +1,284 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <utility>
+#include <variant>
+#include <tasks/executor.h>
+
+namespace tasks
+{
+
+    template <typename T>
+    class lazy;
+
+    namespace detail
+    {
+        /// <summary>resumes whoever awaited the coroutine once it completes, by symmetric transfer rather than a nested resume</summary>
+        struct continuation_awaiter final
+        {
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+            template <typename PROMISE>
+            [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<PROMISE> completed) const noexcept
+            {
+                auto const continuation = completed.promise().continuation;
+                return continuation
+                    ? continuation
+                    : std::noop_coroutine();
+            }
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        struct lazy_promise_base
+        {
+            std::coroutine_handle<> continuation{};
+
+            [[nodiscard]] std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+            [[nodiscard]] continuation_awaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+        };
+
+        /// <summary>coroutine which starts immediately and destroys itself on completion, used to bridge into non-coroutine code</summary>
+        struct detached final
+        {
+            struct promise_type final
+            {
+                [[nodiscard]] detached get_return_object() const noexcept
+                {
+                    return {};
+                }
+                [[nodiscard]] std::suspend_never initial_suspend() const noexcept
+                {
+                    return {};
+                }
+                [[nodiscard]] std::suspend_never final_suspend() const noexcept
+                {
+                    return {};
+                }
+                void return_void() const noexcept
+                {
+                }
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+            };
+        };
+    }
+
+    /// <summary>
+    /// lazily started coroutine producing a T; nothing runs until the lazy is awaited, at which point it runs
+    /// on the awaiting thread until its first suspension
+    /// </summary>
+    template <typename T>
+    class [[nodiscard]] lazy final
+    {
+    public:
+        struct promise_type final : detail::lazy_promise_base
+        {
+            std::variant<std::monostate, T, std::exception_ptr> result{};
+
+            [[nodiscard]] lazy get_return_object() noexcept
+            {
+                return lazy(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            template <typename VALUE>
+            void return_value(VALUE&& value) noexcept(std::is_nothrow_constructible_v<T, VALUE&&>)
+            {
+                result.template emplace<1>(std::forward<VALUE>(value));
+            }
+            void unhandled_exception() noexcept
+            {
+                result.template emplace<2>(std::current_exception());
+            }
+        };
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return !m_handle || m_handle.done();
+        }
+        [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<> const awaiting) noexcept
+        {
+            m_handle.promise().continuation = awaiting;
+            return m_handle;
+        }
+        T await_resume()
+        {
+            auto& result = m_handle.promise().result;
+            if (result.index() == 2)
+                std::rethrow_exception(std::get<2>(result));
+            return std::move(std::get<1>(result));
+        }
+
+        lazy(lazy const&) = delete;
+        lazy(lazy&& other) noexcept
+            : m_handle{std::exchange(other.m_handle, {})}
+        {
+        }
+        lazy& operator=(lazy const&) = delete;
+        lazy& operator=(lazy&& other) noexcept
+        {
+            if (this != &other) {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+        ~lazy()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+
+        explicit lazy(std::coroutine_handle<promise_type> const handle) noexcept
+            : m_handle{handle}
+        {
+        }
+    };
+
+    template <>
+    class [[nodiscard]] lazy<void> final
+    {
+    public:
+        struct promise_type final : detail::lazy_promise_base
+        {
+            std::exception_ptr exception{};
+
+            [[nodiscard]] lazy get_return_object() noexcept
+            {
+                return lazy(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            void return_void() const noexcept
+            {
+            }
+            void unhandled_exception() noexcept
+            {
+                exception = std::current_exception();
+            }
+        };
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return !m_handle || m_handle.done();
+        }
+        [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<> const awaiting) noexcept
+        {
+            m_handle.promise().continuation = awaiting;
+            return m_handle;
+        }
+        void await_resume() const
+        {
+            if (m_handle.promise().exception)
+                std::rethrow_exception(m_handle.promise().exception);
+        }
+
+        lazy(lazy const&) = delete;
+        lazy(lazy&& other) noexcept
+            : m_handle{std::exchange(other.m_handle, {})}
+        {
+        }
+        lazy& operator=(lazy const&) = delete;
+        lazy& operator=(lazy&& other) noexcept
+        {
+            if (this != &other) {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+        ~lazy()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+
+        explicit lazy(std::coroutine_handle<promise_type> const handle) noexcept
+            : m_handle{handle}
+        {
+        }
+    };
+
+    /// <summary>suspends the awaiting coroutine and resumes it on one of target's workers</summary>
+    [[nodiscard]] inline auto schedule_on(executor& target) noexcept
+    {
+        struct awaiter final
+        {
+            executor& target;
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+            void await_suspend(std::coroutine_handle<> const awaiting) const
+            {
+                target.post([awaiting]() { awaiting.resume(); });
+            }
+            void await_resume() const noexcept
+            {
+            }
+        };
+        return awaiter{target};
+    }
+
+    /// <summary>starts work on the calling thread and completes promise with its outcome</summary>
+    template <typename T>
+    void start_detached(lazy<T> work, std::promise<T> promise)
+    {
+        [](lazy<T> owned, std::promise<T> completion) -> detail::detached {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await std::move(owned);
+                    completion.set_value();
+                } else {
+                    completion.set_value(co_await std::move(owned));
+                }
+            } catch (...) {
+                completion.set_exception(std::current_exception());
+            }
+        }(std::move(work), std::move(promise));
+    }
+
+    /// <summary>blocks the calling thread until work completes, returning its result</summary>
+    /// <remarks>must not be called from a thread work itself needs to make progress, such as the only executor worker</remarks>
+    template <typename T>
+    T sync_wait(lazy<T> work)
+    {
+        std::promise<T> promise;
+        auto future = promise.get_future();
+        start_detached(std::move(work), std::move(promise));
+        return future.get();
+    }
+
+}
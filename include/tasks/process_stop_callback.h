@@ -0,0 +1,38 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <stop_token>
+#include <shared/process.h>
+
+namespace tasks
+{
+
+    /// <summary>stop callback terminating a launched helper process, so that cancelling a task also ends the tool it is waiting on</summary>
+    struct terminate_process final
+    {
+        shared::model::process& target;
+        unsigned long exit_code{1UL};
+
+        void operator()() const noexcept
+        {
+            static_cast<void>(target.terminate(exit_code));
+        }
+    };
+
+    /// <summary>terminates the process when the token is stopped for as long as the callback is in scope</summary>
+    /// <example>process_stop_callback const on_stop(stop_token, terminate_process{*helper});</example>
+    using process_stop_callback = std::stop_callback<terminate_process>;
+
+}
@@ -0,0 +1,94 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <tasks/task.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>orders tasks which are ready to run, a scheduler pushes tasks as they become ready and pops the next one to start</summary>
+    /// <remarks>implementations are not thread safe, the owning scheduler is expected to serialise access</remarks>
+    class ready_queue
+    {
+    public:
+        using clock = task::clock;
+
+        /// <param name="now">time at which ready became ready</param>
+        virtual void push(task& ready, clock::time_point const now) = 0;
+        /// <summary>removes and returns the next task to run, or nullptr if the queue is empty</summary>
+        [[nodiscard]] virtual task* pop() = 0;
+        [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+
+        ready_queue(ready_queue const&) = default;
+        ready_queue(ready_queue&&) noexcept = default;
+        ready_queue& operator=(ready_queue const&) = default;
+        ready_queue& operator=(ready_queue&&) noexcept = default;
+        virtual ~ready_queue() = default;
+
+    protected:
+        ready_queue() = default;
+    };
+
+    /// <summary>runs tasks in the order they became ready</summary>
+    class fifo_ready_queue final : public ready_queue
+    {
+    public:
+        TASKS_DLL void push(task& ready, clock::time_point const now) override;
+        [[nodiscard]] TASKS_DLL task* pop() override;
+        [[nodiscard]] TASKS_DLL std::size_t size() const noexcept override;
+
+    private:
+        std::deque<task*> m_tasks{};
+    };
+
+    /// <summary>
+    /// earliest deadline first ordered by slack, the latest time a task can start and still meet its deadline
+    /// given its estimated time remaining; a short task close to its deadline therefore runs ahead of a
+    /// long job whose deadline is further away
+    /// </summary>
+    /// <remarks>
+    /// slack is computed when a task is pushed. tasks without a deadline are given one of default_deadline
+    /// after they became ready, so they age ahead of later arrivals rather than starving
+    /// </remarks>
+    class slack_ready_queue final : public ready_queue
+    {
+    public:
+        TASKS_DLL void push(task& ready, clock::time_point const now) override;
+        [[nodiscard]] TASKS_DLL task* pop() override;
+        [[nodiscard]] TASKS_DLL std::size_t size() const noexcept override;
+
+        TASKS_DLL explicit slack_ready_queue(clock::duration const default_deadline = std::chrono::seconds(60));
+
+    private:
+        struct entry final
+        {
+            clock::time_point latest_start;
+            std::uint64_t sequence;
+            task* target;
+        };
+
+        clock::duration m_default_deadline;
+        std::vector<entry> m_heap{};
+        std::uint64_t m_sequence{};
+
+        [[nodiscard]] static bool runs_after(entry const& first, entry const& second) noexcept;
+    };
+
+}
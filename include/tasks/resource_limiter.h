@@ -0,0 +1,172 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <tasks/executor.h>
+#include <tasks/task.h>
+#include <tasks/tasks_export.h>
+#include <tasks/work_item.h>
+
+namespace tasks
+{
+
+    /// <summary>point in time view of a single resource class</summary>
+    struct resource_class_statistics final
+    {
+        std::string name{};
+        std::size_t limit{};
+        std::size_t in_use{};
+        std::size_t queued{};
+        std::uint64_t rejected{};
+    };
+
+    /// <summary>
+    /// limits how much work using a named resource, such as "snapshot-tool" or "disk-io", runs at once; work
+    /// declaring one or more classes is only handed to the executor once it holds a permit for each of them
+    /// </summary>
+    /// <remarks>
+    /// work waiting for a permit is parked in the class's queue rather than blocking a worker thread, and is
+    /// posted by whichever work releases the permit. permits for several classes are taken in name order so
+    /// two pieces of work can't each hold a permit the other is waiting for. the try_ variants refuse work
+    /// once a class has max_queued items waiting so producers can slow down rather than queue without bound
+    /// </remarks>
+    class resource_limiter final
+    {
+    public:
+        /// <exception cref="std::invalid_argument">if name is already in use or limit is zero</exception>
+        TASKS_DLL void add_class(std::string_view const name, std::size_t const limit, std::size_t const max_queued = std::numeric_limits<std::size_t>::max());
+
+        /// <summary>queues work to run once permits for every class in classes are held</summary>
+        /// <remarks>the permits are released before the returned future is made ready</remarks>
+        /// <exception cref="std::invalid_argument">if a class has not been added</exception>
+        template <typename CALLABLE>
+        [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<CALLABLE>&>> submit(std::vector<std::string> const& classes, CALLABLE&& work)
+        {
+            auto pending = make_request(classes);
+            auto future = package(*pending, std::forward<CALLABLE>(work));
+            enqueue(std::move(pending));
+            return future;
+        }
+
+        /// <summary>as submit, but returns nullopt rather than queue behind a class which is at its max_queued</summary>
+        template <typename CALLABLE>
+        [[nodiscard]] std::optional<std::future<std::invoke_result_t<std::decay_t<CALLABLE>&>>> try_submit(std::vector<std::string> const& classes, CALLABLE&& work)
+        {
+            auto pending = make_request(classes);
+            auto future = package(*pending, std::forward<CALLABLE>(work));
+            if (!try_enqueue(std::move(pending)))
+                return std::nullopt;
+            return std::optional(std::move(future));
+        }
+
+        /// <summary>runs target.process() holding the classes target declares through task::get_resource_classes</summary>
+        [[nodiscard]] TASKS_DLL std::future<void> submit(task& target);
+
+        TASKS_DLL void post(std::vector<std::string> const& classes, work_item item);
+        [[nodiscard]] TASKS_DLL bool try_post(std::vector<std::string> const& classes, work_item item);
+
+        /// <summary>number of items waiting for a permit of name</summary>
+        [[nodiscard]] TASKS_DLL std::size_t get_queue_length(std::string_view const name) const;
+        [[nodiscard]] TASKS_DLL std::size_t get_in_use(std::string_view const name) const;
+        [[nodiscard]] TASKS_DLL std::vector<resource_class_statistics> get_statistics() const;
+
+        TASKS_DLL explicit resource_limiter(executor& executor);
+        resource_limiter(resource_limiter const&) = delete;
+        resource_limiter(resource_limiter&&) noexcept = delete;
+        resource_limiter& operator=(resource_limiter const&) = delete;
+        resource_limiter& operator=(resource_limiter&&) noexcept = delete;
+        /// <summary>work still waiting for a permit is discarded, breaking the promise of anything submitted</summary>
+        TASKS_DLL ~resource_limiter() = default;
+
+    private:
+        struct request;
+        struct resource_class final
+        {
+            std::string name;
+            std::size_t limit;
+            std::size_t max_queued;
+            std::size_t in_use{};
+            std::uint64_t rejected{};
+            std::deque<std::unique_ptr<request>> waiting{};
+        };
+        struct request final
+        {
+            std::vector<resource_class*> classes{};
+            std::size_t acquired{};
+            work_item work{};
+        };
+
+        executor& m_executor;
+        mutable std::mutex m_mutex{};
+        std::map<std::string, std::unique_ptr<resource_class>, std::less<>> m_classes{};
+
+        template <typename CALLABLE>
+        [[nodiscard]] auto package(request& pending, CALLABLE&& work)
+        {
+            using result_type = std::invoke_result_t<std::decay_t<CALLABLE>&>;
+
+            std::promise<result_type> promise;
+            auto future = promise.get_future();
+            pending.work = work_item([this, classes = &pending.classes, promise = std::move(promise), work = std::forward<CALLABLE>(work)]() mutable {
+                // permits are handed back before completing the promise so that whoever is waiting on it sees them free
+                std::exception_ptr error;
+                std::optional<std::conditional_t<std::is_void_v<result_type>, bool, result_type>> result;
+                try {
+                    if constexpr (std::is_void_v<result_type>) {
+                        work();
+                        result.emplace(true);
+                    } else {
+                        result.emplace(work());
+                    }
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                release(*classes);
+
+                if (error) {
+                    promise.set_exception(error);
+                } else if constexpr (std::is_void_v<result_type>) {
+                    promise.set_value();
+                } else {
+                    promise.set_value(std::move(result.value()));
+                }
+            });
+            return future;
+        }
+
+        [[nodiscard]] std::unique_ptr<request> make_request(std::vector<std::string> const& classes) const;
+        [[nodiscard]] resource_class& find_class(std::string_view const name) const;
+        /// <summary>takes as many permits as are free, returns the request if it now holds all of them or parks it and returns null</summary>
+        [[nodiscard]] std::unique_ptr<request> acquire(std::unique_ptr<request> pending);
+        void enqueue(std::unique_ptr<request> pending);
+        [[nodiscard]] bool try_enqueue(std::unique_ptr<request> pending);
+        void dispatch(std::unique_ptr<request> ready);
+        [[nodiscard]] work_item wrap(std::vector<resource_class*> const& classes, work_item item);
+        void release(std::vector<resource_class*> const& classes);
+    };
+
+}
@@ -0,0 +1,63 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <memory>
+#include <shared_mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <tasks/runtime_model.h>
+#include <tasks/task.h>
+#include <tasks/task_observer.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>
+    /// keeps a runtime_model per concrete task type and, added as an observer, keeps each task's estimated
+    /// time remaining up to date: set from the model when the task becomes ready and again when it starts,
+    /// and recorded into the model when it completes
+    /// </summary>
+    /// <remarks>failed runs are not recorded since how quickly something fails says little about how long it takes to succeed</remarks>
+    class runtime_estimator final : public task_observer
+    {
+    public:
+        TASKS_DLL void on_transition(task& source, task_state const previous, task_state const current) noexcept override;
+
+        /// <summary>model learned for TASK, or nullptr if no TASK has been seen</summary>
+        template <Task TASK>
+        [[nodiscard]] std::shared_ptr<runtime_model const> find_model() const
+        {
+            return find_model(std::type_index(typeid(TASK)));
+        }
+        [[nodiscard]] TASKS_DLL std::shared_ptr<runtime_model const> find_model(std::type_index const& task_type) const;
+
+        /// <param name="smoothing">weight given to the newest sample by each model's moving average</param>
+        TASKS_DLL explicit runtime_estimator(double const smoothing = 0.2);
+        runtime_estimator(runtime_estimator const&) = delete;
+        runtime_estimator(runtime_estimator&&) noexcept = delete;
+        runtime_estimator& operator=(runtime_estimator const&) = delete;
+        runtime_estimator& operator=(runtime_estimator&&) noexcept = delete;
+        TASKS_DLL ~runtime_estimator() override = default;
+
+    private:
+        double m_smoothing;
+        mutable std::shared_mutex m_mutex{};
+        std::unordered_map<std::type_index, std::shared_ptr<runtime_model>> m_models{};
+
+        [[nodiscard]] std::shared_ptr<runtime_model> get_or_add_model(std::type_index const& task_type);
+    };
+
+}
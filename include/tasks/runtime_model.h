@@ -0,0 +1,83 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <tasks/streaming_quantile.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>point in time summary of a runtime_model</summary>
+    struct runtime_statistics final
+    {
+        std::uint64_t count{};
+        std::chrono::nanoseconds average{};
+        std::chrono::nanoseconds median{};
+        std::chrono::nanoseconds p90{};
+        std::chrono::nanoseconds p99{};
+        /// <summary>nanoseconds per unit of input size, present once enough sized samples have been recorded</summary>
+        std::optional<double> slope{};
+        std::optional<double> intercept{};
+    };
+
+    /// <summary>
+    /// learns how long one kind of task takes from its past runs; an exponentially weighted moving average,
+    /// streaming quantiles and, for runs which report an input size, a least squares fit of duration against size
+    /// </summary>
+    /// <remarks>every operation is constant time and thread safe</remarks>
+    class runtime_model final
+    {
+    public:
+        TASKS_DLL void record(std::chrono::nanoseconds const duration, std::optional<double> const input_size) noexcept;
+        /// <summary>
+        /// expected duration of a run; the size regression is used when input_size is known and the fit is
+        /// established, otherwise the moving average
+        /// </summary>
+        [[nodiscard]] TASKS_DLL std::chrono::nanoseconds estimate(std::optional<double> const input_size) const noexcept;
+        [[nodiscard]] TASKS_DLL runtime_statistics get_statistics() const;
+
+        /// <param name="smoothing">weight given to the newest sample by the moving average</param>
+        /// <exception cref="std::invalid_argument">if smoothing is not in (0, 1]</exception>
+        TASKS_DLL explicit runtime_model(double const smoothing = 0.2);
+        runtime_model(runtime_model const&) = delete;
+        runtime_model(runtime_model&&) noexcept = delete;
+        runtime_model& operator=(runtime_model const&) = delete;
+        runtime_model& operator=(runtime_model&&) noexcept = delete;
+        TASKS_DLL ~runtime_model() = default;
+
+    private:
+        mutable std::mutex m_mutex{};
+        double m_smoothing;
+        std::uint64_t m_count{};
+        double m_average{};
+        streaming_quantile m_median{0.5};
+        streaming_quantile m_p90{0.9};
+        streaming_quantile m_p99{0.99};
+
+        // running means and co-moments of (size, duration), updated with Welford's method for stability
+        std::uint64_t m_sized_count{};
+        double m_mean_size{};
+        double m_mean_duration{};
+        double m_size_variance{};
+        double m_covariance{};
+
+        [[nodiscard]] bool has_fit() const noexcept;
+    };
+
+}
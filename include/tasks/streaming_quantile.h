@@ -0,0 +1,53 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>
+    /// estimates a single quantile of a stream in constant space and time using the P-squared algorithm
+    /// (Jain and Chlamtac), five markers are kept and adjusted by piecewise parabolic interpolation
+    /// </summary>
+    class streaming_quantile final
+    {
+    public:
+        TASKS_DLL void add(double const value) noexcept;
+        /// <summary>current estimate, 0 if nothing has been added</summary>
+        [[nodiscard]] TASKS_DLL double get_value() const noexcept;
+        [[nodiscard]] TASKS_DLL double get_probability() const noexcept;
+        [[nodiscard]] TASKS_DLL std::uint64_t get_count() const noexcept;
+
+        /// <exception cref="std::invalid_argument">if probability is not between 0 and 1 exclusive</exception>
+        TASKS_DLL explicit streaming_quantile(double const probability);
+
+    private:
+        static constexpr std::size_t MARKERS = 5;
+
+        double m_probability;
+        std::uint64_t m_count{};
+        std::array<double, MARKERS> m_heights{};
+        std::array<double, MARKERS> m_positions{};
+        std::array<double, MARKERS> m_desired{};
+        std::array<double, MARKERS> m_increments{};
+
+        [[nodiscard]] double parabolic(std::size_t const index, double const direction) const noexcept;
+        [[nodiscard]] double linear(std::size_t const index, double const direction) const noexcept;
+    };
+
+}
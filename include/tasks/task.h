@@ -13,7 +13,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+#include <tasks/task_observer.h>
 #include <tasks/task_state.h>
 #include <tasks/tasks_export.h>
 #include <future>
@@ -22,31 +30,85 @@ namespace tasks
 {
 
     /// <summary>Represents a repeatble asynchronous operation with state that determines whether the operation can be run</summary>
-    /// <remarks>not intended for direct use but serving as a base class and basis for a task concept</remarks>
+    /// <remarks>
+    /// not intended for direct use but serving as a base class and basis for a task concept.
+    /// state changes are lock-free and validated against is_valid_transition, observers are notified of each
+    /// successful transition so a scheduler need not poll get_current_state
+    /// </remarks>
     class task  
     {
     public:
-        TASKS_DLL task(task const&) = default;
-        TASKS_DLL task(task&&) noexcept = default;
+        using clock = std::chrono::steady_clock;
+
+        TASKS_DLL task(task const&) = delete;
+        TASKS_DLL task(task&&) noexcept = delete;
         TASKS_DLL virtual ~task() = default;
 
-        TASKS_DLL task& operator=(task const&) = default;
-        TASKS_DLL task& operator=(task&&) noexcept = default;
+        TASKS_DLL task& operator=(task const&) = delete;
+        TASKS_DLL task& operator=(task&&) noexcept = delete;
 
         TASKS_DLL virtual void process() = 0;
 
         [[nodiscard]] TASKS_DLL task_state get_current_state() const noexcept;
+        /// <summary>latest estimate of the time needed to finish, while running this counts down from when the estimate was made</summary>
         [[nodiscard]] TASKS_DLL std::chrono::milliseconds get_estimated_time_remaining() const noexcept;
+        TASKS_DLL void update_time_remaining(std::chrono::milliseconds const value) noexcept;
+        /// <summary>time the task last moved to READY, if it ever has</summary>
+        [[nodiscard]] TASKS_DLL std::optional<clock::time_point> get_ready_at() const noexcept;
+        /// <summary>time the task last moved to RUNNING, if it ever has</summary>
+        [[nodiscard]] TASKS_DLL std::optional<clock::time_point> get_started_at() const noexcept;
+        /// <summary>size of the input this run will process, such as snapshot bytes, used to refine runtime estimates</summary>
+        [[nodiscard]] TASKS_DLL virtual std::optional<double> get_input_size() const noexcept;
+        /// <summary>names of the resource classes a run holds a permit for, see resource_limiter</summary>
+        [[nodiscard]] TASKS_DLL virtual std::vector<std::string> get_resource_classes() const;
+        /// <summary>time by which the task should have completed, used by deadline aware ready queues</summary>
+        [[nodiscard]] TASKS_DLL std::optional<clock::time_point> get_deadline() const noexcept;
+        TASKS_DLL void set_deadline(std::optional<clock::time_point> const value) noexcept;
+        /// <summary>how long a single run may take before it is asked to stop, see timeout_monitor</summary>
+        [[nodiscard]] TASKS_DLL std::optional<clock::duration> get_timeout() const noexcept;
+        TASKS_DLL void set_timeout(std::optional<clock::duration> const value) noexcept;
+
+        /// <summary>token for the current run, to be passed on to task_action::process_async</summary>
+        /// <remarks>each run after the task has completed or failed is given a new token so a stop only ever applies to one run</remarks>
+        [[nodiscard]] TASKS_DLL std::stop_token get_stop_token() const;
+        /// <summary>asks the current run to stop, any stop callbacks registered against its token run on the calling thread</summary>
+        [[maybe_unused]] TASKS_DLL bool request_stop() noexcept;
+
+        /// <summary>moves from expected to desired if the task is still in expected</summary>
+        /// <returns>true if this call made the transition, false if the task was no longer in expected</returns>
+        /// <exception cref="std::invalid_argument">if desired cannot be reached from expected</exception>
+        [[nodiscard]] TASKS_DLL bool try_transition(task_state const expected, task_state const desired);
+
+        /// <exception cref="std::invalid_argument">if observer is null</exception>
+        TASKS_DLL void add_observer(std::shared_ptr<task_observer> observer);
+        [[maybe_unused]] TASKS_DLL bool remove_observer(task_observer const& observer) noexcept;
 
     protected:
         TASKS_DLL explicit task() = default;
 
+        /// <summary>moves from whatever the current state is to value</summary>
+        /// <exception cref="std::invalid_argument">if value cannot be reached from the current state</exception>
         TASKS_DLL void update_task_state(task_state const value);
-        TASKS_DLL void update_time_remaining(task_state const value);
 
     private:
-        task_state m_current_state{task_state::PENDING};
-        std::chrono::milliseconds m_time_remaining{};
+        using observer_list = std::vector<std::shared_ptr<task_observer>>;
+
+        std::atomic<task_state> m_current_state{task_state::PENDING};
+        std::atomic<std::chrono::milliseconds> m_time_remaining{};
+        std::atomic<clock::time_point> m_estimated_at{};
+        std::atomic<clock::time_point> m_ready_at{clock::time_point::max()};
+        std::atomic<clock::time_point> m_started_at{clock::time_point::max()};
+        std::atomic<clock::time_point> m_deadline{clock::time_point::max()};
+        std::atomic<clock::duration> m_timeout{clock::duration::zero()};
+        mutable std::mutex m_stop_mutex{};
+        std::stop_source m_stop_source{};
+        // copy on write, readers only take a reference to the current list
+        std::atomic<std::shared_ptr<observer_list const>> m_observers{};
+
+        /// <summary>a fresh stop_source if a run leaving previous needs one, made before the transition since it allocates</summary>
+        [[nodiscard]] static std::stop_source get_replacement(task_state const previous);
+        /// <param name="replacement">from get_replacement, swapped in for the current stop_source if it has a stop state</param>
+        void on_transition(task_state const previous, task_state const current, std::stop_source replacement) noexcept;
     };
     
     template <typename TASK>
@@ -15,25 +15,44 @@
 
 #include <chrono>
 #include <future>
+#include <stop_token>
 #include <tasks/task_state.h>
 
 namespace tasks
 {
+    /// <summary>outcome of a single task_action step, the next state and the estimated time until it completes</summary>
+    using action_result = std::pair<task_state, std::chrono::milliseconds>;
+
     /// <summary>worker method for task, represents a current state and provides process used to transition to the next state (if ready)</summary>
+    /// <remarks>
+    /// an action overriding only one of the process_async overloads should bring the other into scope with
+    /// using task_action::process_async, otherwise it is hidden from callers holding the derived type
+    /// </remarks>
     class task_action
     {
+    public:
+        virtual std::future<action_result> process_async() = 0;
+        /// <summary>as process_async, finishing early once stop_token is signalled, typically with task_state::FAILED</summary>
+        /// <remarks>the default ignores stop_token, any action which may run for some time should override it</remarks>
+        virtual std::future<action_result> process_async(std::stop_token stop_token)
+        {
+            static_cast<void>(stop_token);
+            return process_async();
+        }
+
         task_action(task_action const&) = default;
         task_action(task_action&&) noexcept = default;
         task_action& operator=(task_action const&) = default;
         task_action& operator=(task_action&&) noexcept = default;
-
         virtual ~task_action() = default;
-        virtual std::future<std::pair<task_state, std::chrono::milliseconds>> process_async() = 0;
+
+    protected:
+        task_action() = default;
     };
 
     template<typename TASK_ACTION>
     concept TaskAction = requires(TASK_ACTION a) {
-        requires std::is_same<std::future<std::pair<task_state, std::chrono::milliseconds>>, decltype(std::declval<TASK_ACTION>().process_async())>::value;
+        requires std::is_same<std::future<action_result>, decltype(std::declval<TASK_ACTION>().process_async())>::value;
     };
 
     
@@ -13,16 +13,121 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <future>
+#include <optional>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <tasks/task_action.h>
 
 namespace tasks
 {
-    template <Action action>
+    /// <summary>compile time list of types</summary>
+    template <typename... TYPES>
+    struct type_list final
+    {
+        static constexpr std::size_t size = sizeof...(TYPES);
+    };
+
+    template <typename>
+    inline constexpr bool dependent_false = false;
+
+    template <typename ACTIONS>
     class task_action_factory
     {
+        static_assert(dependent_false<ACTIONS>, "task_action_factory expects a type_list of types satisfying TaskAction");
+    };
+
+    /// <summary>
+    /// closed set of task actions fixed at compile time; an action is held by value in a std::variant and
+    /// dispatched with std::visit so running one needs neither a heap allocation nor a virtual call
+    /// </summary>
+    /// <remarks>every type in the list is checked against TaskAction, the list may not contain duplicates</remarks>
+    template <TaskAction... ACTIONS>
+    class task_action_factory<type_list<ACTIONS...>> final
+    {
+        template <typename ACTION>
+        static constexpr std::size_t occurrences = (std::size_t{std::is_same_v<ACTION, ACTIONS>} + ...);
+        static_assert(((occurrences<ACTIONS> == 1U) && ...), "each action may only be registered once");
+
     public:
-        
+        using action = std::variant<ACTIONS...>;
+
+        static constexpr std::size_t size = sizeof...(ACTIONS);
+
+        /// <summary>position of ACTION in the list, which is also its index in action</summary>
+        template <typename ACTION>
+        [[nodiscard]] static constexpr std::size_t index_of() noexcept
+        {
+            static_assert(contains<ACTION>(), "ACTION is not registered with this factory");
+            constexpr std::array<bool, size> matches{std::is_same_v<ACTION, ACTIONS>...};
+            std::size_t index{};
+            while (!matches[index])
+                ++index;
+            return index;
+        }
+
+        template <typename ACTION>
+        [[nodiscard]] static constexpr bool contains() noexcept
+        {
+            return (std::is_same_v<ACTION, ACTIONS> || ...);
+        }
+
+        /// <summary>constructs ACTION in place from arguments</summary>
+        template <typename ACTION, typename... ARGUMENTS>
+            requires (contains<ACTION>())
+        [[nodiscard]] static action create(ARGUMENTS&&... arguments)
+        {
+            return action(std::in_place_type<ACTION>, std::forward<ARGUMENTS>(arguments)...);
+        }
+
+        /// <summary>default constructs the action at index through a constexpr table of constructors</summary>
+        /// <returns>nullopt if index is out of range or that action is not default constructible</returns>
+        [[nodiscard]] static std::optional<action> create(std::size_t const index)
+        {
+            if (index >= size)
+                return std::nullopt;
+            return constructors[index]();
+        }
+
+        /// <summary>runs whichever action is held</summary>
+        [[nodiscard]] static std::future<action_result> process_async(action& current)
+        {
+            return std::visit([](auto& held) { return held.process_async(); }, current);
+        }
+
+        /// <summary>as process_async, passing stop_token on to actions which accept one</summary>
+        [[nodiscard]] static std::future<action_result> process_async(action& current, std::stop_token stop_token)
+        {
+            return std::visit([&stop_token](auto& held) {
+                if constexpr (requires { held.process_async(stop_token); })
+                    return held.process_async(std::move(stop_token));
+                else
+                    return held.process_async();
+            }, current);
+        }
+
+    private:
+        template <std::size_t INDEX>
+        static std::optional<action> construct_at()
+        {
+            using selected = std::variant_alternative_t<INDEX, action>;
+            if constexpr (std::is_default_constructible_v<selected>)
+                return std::optional<action>(std::in_place, std::in_place_index<INDEX>);
+            else
+                return std::nullopt;
+        }
+
+        template <std::size_t... INDICES>
+        static constexpr auto make_constructors(std::index_sequence<INDICES...>) noexcept
+        {
+            return std::array<std::optional<action>(*)(), size>{&construct_at<INDICES>...};
+        }
+
+        static constexpr auto constructors = make_constructors(std::index_sequence_for<ACTIONS...>{});
     };
 
-    
 }
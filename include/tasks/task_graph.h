@@ -0,0 +1,111 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <any>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+#include <tasks/executor.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>how a node of a task_graph run finished</summary>
+    enum class node_outcome
+    {
+        /// <summary>ran and returned a value</summary>
+        COMPLETE,
+        /// <summary>ran and threw</summary>
+        FAILED,
+        /// <summary>never ran because a node it depends on failed or was cancelled</summary>
+        CANCELLED,
+    };
+
+    /// <summary>outcome of every node of a task_graph run, indexed by node id</summary>
+    struct task_graph_result final
+    {
+        std::vector<node_outcome> outcomes{};
+        /// <summary>values returned by nodes without dependents, the values of other nodes are moved to their dependents</summary>
+        std::vector<std::any> outputs{};
+        /// <summary>exception thrown by each failed node, null for every other node</summary>
+        std::vector<std::exception_ptr> errors{};
+
+        [[nodiscard]] bool succeeded() const noexcept
+        {
+            for (auto const outcome : outcomes)
+                if (outcome != node_outcome::COMPLETE)
+                    return false;
+            return true;
+        }
+    };
+
+    /// <summary>
+    /// directed acyclic graph of work in which each node runs on an executor as soon as every node it
+    /// depends on has completed, receiving their return values as its inputs
+    /// </summary>
+    /// <remarks>
+    /// nodes may only depend on nodes added before them so a graph is acyclic by construction. a node which
+    /// throws fails, and every node downstream of it is cancelled rather than run
+    /// </remarks>
+    class task_graph final
+    {
+    public:
+        using node_id = std::size_t;
+        /// <summary>receives the values of its dependencies in the order they were given to add_node</summary>
+        using node_function = std::function<std::any(std::vector<std::any> inputs)>;
+
+        /// <exception cref="std::invalid_argument">if work is empty or a dependency has not been added</exception>
+        [[nodiscard]] TASKS_DLL node_id add_node(node_function work, std::vector<node_id> const& dependencies = {});
+
+        /// <summary>starts every node without dependencies and returns a future completed once all nodes have finished</summary>
+        /// <remarks>the graph must not be modified or destroyed until the returned future is ready</remarks>
+        [[nodiscard]] TASKS_DLL std::future<task_graph_result> run(executor& executor) const;
+
+        [[nodiscard]] TASKS_DLL std::size_t size() const noexcept;
+
+        TASKS_DLL explicit task_graph() = default;
+        TASKS_DLL task_graph(task_graph const&) = default;
+        TASKS_DLL task_graph(task_graph&&) noexcept = default;
+        TASKS_DLL task_graph& operator=(task_graph const&) = default;
+        TASKS_DLL task_graph& operator=(task_graph&&) noexcept = default;
+        TASKS_DLL ~task_graph() = default;
+
+    private:
+        struct successor final
+        {
+            node_id target;
+            std::size_t input_index;
+        };
+        struct node final
+        {
+            node_function work;
+            std::size_t dependency_count;
+            std::vector<successor> successors;
+        };
+        struct run_state;
+
+        std::vector<node> m_nodes{};
+
+        void execute(std::shared_ptr<run_state> const& state, node_id const id) const;
+        void finish(std::shared_ptr<run_state> const& state, node_id const id, bool const succeeded) const;
+        void release_successors(std::shared_ptr<run_state> const& state, node_id const id, bool const succeeded, std::vector<node_id>& cancelled) const;
+        void post(std::shared_ptr<run_state> const& state, node_id const id) const;
+    };
+
+}
@@ -0,0 +1,177 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#include <shared/invalid_handle.h>
+#else
+#include <shared/posix_fd.h>
+#endif
+#include <tasks/task.h>
+#include <tasks/task_observer.h>
+#include <tasks/task_state.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    enum class journal_record_type : std::uint8_t
+    {
+        /// <summary>task moved to a new state</summary>
+        TRANSITION = 1,
+        /// <summary>task is run periodically, anchored at a given time</summary>
+        SCHEDULE = 2,
+        /// <summary>task is no longer tracked, its state and schedule are forgotten</summary>
+        REMOVE = 3,
+    };
+
+    /// <summary>single entry of a task_journal, stored as 32 little endian bytes guarded by a crc32</summary>
+    struct journal_record final
+    {
+        journal_record_type type{};
+        task_state state{};
+        std::uint64_t id{};
+        /// <summary>nanoseconds since the system_clock epoch, the time of a transition or the anchor of a schedule</summary>
+        std::int64_t timestamp{};
+        /// <summary>nanoseconds between runs of a schedule</summary>
+        std::int64_t value{};
+    };
+
+    /// <summary>what the journal knows about a single task once every record has been applied</summary>
+    struct journal_entry final
+    {
+        using clock = std::chrono::system_clock;
+
+        std::optional<task_state> state{};
+        clock::time_point updated_at{};
+        /// <summary>first due time of the schedule, later runs are due at whole periods after it</summary>
+        clock::time_point anchor{};
+        std::optional<clock::duration> period{};
+
+        /// <summary>earliest due time of the schedule strictly after now, so a restarted monitor keeps the same series</summary>
+        [[nodiscard]] TASKS_DLL std::optional<clock::time_point> get_next_due(clock::time_point const now) const noexcept;
+    };
+
+    using journal_state = std::unordered_map<std::uint64_t, journal_entry>;
+
+    /// <summary>
+    /// write ahead journal of task state transitions and schedules, kept as an append only log of fixed size
+    /// records in a directory alongside a checkpoint the log is periodically compacted into
+    /// </summary>
+    /// <remarks>
+    /// appends are buffered and written by a single writer thread, every record buffered while the previous
+    /// write was being synced goes out with the next one so concurrent appenders share an fsync.
+    /// as an observer only tasks registered with track are journalled, the task itself carries no identity
+    /// which survives a restart
+    /// </remarks>
+    class task_journal final : public task_observer
+    {
+    public:
+        using clock = journal_entry::clock;
+        using sequence = std::uint64_t;
+
+        TASKS_DLL void on_transition(task& source, task_state const previous, task_state const current) noexcept override;
+
+        /// <summary>journals transitions of target under id until untracked</summary>
+        TASKS_DLL void track(task const& target, std::uint64_t const id);
+        [[maybe_unused]] TASKS_DLL bool untrack(task const& target);
+
+        /// <summary>buffers a record for the writer thread, the returned sequence may be passed to wait_durable</summary>
+        /// <exception cref="std::system_error">if an earlier write or sync failed</exception>
+        TASKS_DLL sequence append_transition(std::uint64_t const id, task_state const state);
+        /// <exception cref="std::invalid_argument">if period is not positive</exception>
+        TASKS_DLL sequence append_schedule(std::uint64_t const id, clock::time_point const anchor, clock::duration const period);
+        TASKS_DLL sequence append_remove(std::uint64_t const id);
+
+        /// <summary>blocks until every record up to and including value has been synced</summary>
+        /// <exception cref="std::system_error">if the write or sync failed</exception>
+        TASKS_DLL void wait_durable(sequence const value);
+        /// <summary>blocks until everything appended so far has been synced</summary>
+        TASKS_DLL void flush();
+        /// <summary>writes the current state to the checkpoint and empties the log, blocking until done</summary>
+        TASKS_DLL void compact();
+
+        /// <summary>state read from the directory when the journal was opened</summary>
+        [[nodiscard]] TASKS_DLL journal_state const& get_recovered() const noexcept;
+        /// <summary>number of records in the log since it was last compacted</summary>
+        [[nodiscard]] TASKS_DLL std::size_t get_log_size() const;
+        /// <summary>number of fsyncs issued for appended records, excluding those made by compaction</summary>
+        [[nodiscard]] TASKS_DLL std::size_t get_sync_count() const;
+
+        /// <summary>reads the checkpoint and then the log in directory, stopping at the first torn or corrupt record</summary>
+        [[nodiscard]] TASKS_DLL static journal_state replay(std::filesystem::path const& directory);
+
+        /// <summary>opens, or creates, the journal in directory and replays it</summary>
+        /// <param name="compact_after">log size, in records, at which the writer compacts</param>
+        /// <exception cref="std::system_error">if the directory or its files can't be opened</exception>
+        TASKS_DLL explicit task_journal(std::filesystem::path directory, std::size_t const compact_after = 1'000'000);
+        task_journal(task_journal const&) = delete;
+        task_journal(task_journal&&) noexcept = delete;
+        task_journal& operator=(task_journal const&) = delete;
+        task_journal& operator=(task_journal&&) noexcept = delete;
+        /// <summary>syncs anything still buffered before closing</summary>
+        TASKS_DLL ~task_journal() override;
+
+    private:
+        std::filesystem::path m_directory;
+        std::size_t m_compact_after;
+#if defined(_WIN32)
+        shared::infrastructure::invalid_handle m_log{};
+#else
+        shared::infrastructure::posix_fd m_log{};
+#endif
+        journal_state m_recovered{};
+
+        mutable std::shared_mutex m_tracked_mutex{};
+        std::unordered_map<task const*, std::uint64_t> m_tracked{};
+
+        mutable std::mutex m_mutex{};
+        std::condition_variable m_work_available{};
+        std::condition_variable m_durable_changed{};
+        std::vector<journal_record> m_pending{};
+        sequence m_appended{};
+        sequence m_durable{};
+        bool m_compact_requested{};
+        bool m_stopping{};
+        std::exception_ptr m_failure{};
+        std::size_t m_log_size{};
+        std::size_t m_sync_count{};
+        std::size_t m_compactions{};
+
+        // owned by the writer thread
+        journal_state m_state{};
+        std::vector<journal_record> m_writing{};
+        std::vector<char> m_encoded{};
+
+        std::thread m_writer;
+
+        sequence append(journal_record const& value);
+        void write_pending();
+        void write_records(std::vector<journal_record> const& records);
+        void write_checkpoint();
+    };
+
+}
@@ -0,0 +1,41 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <tasks/task_state.h>
+
+namespace tasks
+{
+
+    class task;
+
+    /// <summary>notified of every state transition of the tasks it has been added to</summary>
+    class task_observer
+    {
+    public:
+        /// <summary>invoked on the thread which made the transition, after it has taken effect</summary>
+        /// <remarks>must not block, for any lengthy work post it to an executor</remarks>
+        virtual void on_transition(task& source, task_state const previous, task_state const current) noexcept = 0;
+
+        task_observer(task_observer const&) = default;
+        task_observer(task_observer&&) noexcept = default;
+        task_observer& operator=(task_observer const&) = default;
+        task_observer& operator=(task_observer&&) noexcept = default;
+        virtual ~task_observer() = default;
+
+    protected:
+        task_observer() = default;
+    };
+
+}
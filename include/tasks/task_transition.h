@@ -0,0 +1,43 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <tasks/complete_task.h>
+#include <tasks/failed_task.h>
+#include <tasks/pending_task.h>
+#include <tasks/ready_task.h>
+#include <tasks/running_task.h>
+
+namespace tasks
+{
+
+    /// <summary>returns true if a task in the from state may move directly to the to state</summary>
+    [[nodiscard]] constexpr bool is_valid_transition(task_state const from, task_state const to) noexcept
+    {
+        switch (from) {
+        case task_state::PENDING:
+            return pending_task::can_transition_to(to);
+        case task_state::READY:
+            return ready_task::can_transition_to(to);
+        case task_state::RUNNING:
+            return running_task::can_transition_to(to);
+        case task_state::COMPLETE:
+            return complete_task::can_transition_to(to);
+        case task_state::FAILED:
+            return failed_task::can_transition_to(to);
+        }
+        return false;
+    }
+
+}
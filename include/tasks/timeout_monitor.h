@@ -0,0 +1,62 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#if defined(__linux__)
+#include <shared/epoll_reactor.h>
+#endif
+#include <tasks/task.h>
+#include <tasks/task_observer.h>
+#include <tasks/timer_scheduler.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>
+    /// observer enforcing task::get_timeout; a timer is armed on a shared timer_scheduler when a task starts
+    /// running and cancelled when it finishes, if it fires first the task is asked to stop via task::request_stop
+    /// </summary>
+    /// <remarks>stopping is cooperative, the task's action is expected to observe its stop token and finish</remarks>
+    class timeout_monitor final : public task_observer
+    {
+    public:
+        TASKS_DLL void on_transition(task& source, task_state const previous, task_state const current) noexcept override;
+
+        /// <summary>number of running tasks with an armed timeout</summary>
+        [[nodiscard]] TASKS_DLL std::size_t size() const;
+
+#if defined(__linux__)
+        /// <summary>arms timeouts on a timer_scheduler driven by reactor</summary>
+        TASKS_DLL explicit timeout_monitor(shared::infrastructure::epoll_reactor& reactor, timer_scheduler::clock::duration const resolution = std::chrono::milliseconds(1));
+#endif
+        /// <summary>arms timeouts on a timer_scheduler running on a thread of its own</summary>
+        TASKS_DLL explicit timeout_monitor(timer_scheduler::clock::duration const resolution = std::chrono::milliseconds(1));
+        timeout_monitor(timeout_monitor const&) = delete;
+        timeout_monitor(timeout_monitor&&) noexcept = delete;
+        timeout_monitor& operator=(timeout_monitor const&) = delete;
+        timeout_monitor& operator=(timeout_monitor&&) noexcept = delete;
+        TASKS_DLL ~timeout_monitor() override = default;
+
+    private:
+        mutable std::mutex m_mutex{};
+        std::unordered_map<task*, timer_id> m_armed{};
+        timer_scheduler m_timers;
+
+        void on_expired(task& expired, timer_id const& id);
+    };
+
+}
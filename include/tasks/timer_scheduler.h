@@ -0,0 +1,99 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <shared/epoll_reactor.h>
+#include <shared/timerfd.h>
+#elif defined(_WIN32)
+#include <shared/null_handle.h>
+#endif
+#include <tasks/timer_wheel.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>
+    /// drives a timer_wheel from a single OS timer, a timerfd registered on an epoll_reactor on Linux and a
+    /// high resolution waitable timer on Windows; the timer is only ever armed for the wheel's next event so an
+    /// idle scheduler causes no wakeups
+    /// </summary>
+    /// <remarks>
+    /// scheduling and cancellation may be done from any thread, on_expired is invoked on the reactor thread, or
+    /// the scheduler's own thread, without the scheduler lock held. a cancel racing with an expiry may still
+    /// see that expiry reported
+    /// </remarks>
+    class timer_scheduler final
+    {
+    public:
+        using clock = timer_wheel::clock;
+        using expired_callback = std::function<void(task&, timer_id const&)>;
+
+        [[nodiscard]] TASKS_DLL timer_id schedule_once(task& target, clock::duration const delay);
+        [[nodiscard]] TASKS_DLL timer_id schedule_periodic(task& target, clock::duration const period, std::optional<clock::duration> const initial_delay = std::nullopt);
+        [[maybe_unused]] TASKS_DLL bool cancel(timer_id const& id) noexcept;
+        [[nodiscard]] TASKS_DLL bool is_scheduled(timer_id const& id) const noexcept;
+        [[nodiscard]] TASKS_DLL std::size_t size() const noexcept;
+
+#if defined(__linux__)
+        /// <summary>runs the scheduler on reactor, on_expired is invoked on the thread running it</summary>
+        /// <exception cref="std::invalid_argument">if on_expired is empty</exception>
+        /// <exception cref="std::system_error">if the timer can't be created</exception>
+        TASKS_DLL explicit timer_scheduler(shared::infrastructure::epoll_reactor& reactor, expired_callback on_expired, clock::duration const resolution = std::chrono::microseconds(250));
+#endif
+        /// <summary>runs the scheduler on a thread of its own, on_expired is invoked on that thread</summary>
+        /// <exception cref="std::invalid_argument">if on_expired is empty</exception>
+        /// <exception cref="std::system_error">if the timer or thread can't be created</exception>
+        TASKS_DLL explicit timer_scheduler(expired_callback on_expired, clock::duration const resolution = std::chrono::microseconds(250));
+        timer_scheduler(timer_scheduler const&) = delete;
+        timer_scheduler(timer_scheduler&&) noexcept = delete;
+        timer_scheduler& operator=(timer_scheduler const&) = delete;
+        timer_scheduler& operator=(timer_scheduler&&) noexcept = delete;
+        TASKS_DLL ~timer_scheduler();
+
+    private:
+        mutable std::mutex m_mutex{};
+        timer_wheel m_wheel;
+        expired_callback m_on_expired;
+        std::optional<clock::time_point> m_armed_for{};
+        std::vector<timer_wheel::expiration> m_expired{};
+        std::vector<timer_wheel::expiration> m_dispatching{};
+#if defined(__linux__)
+        std::unique_ptr<shared::infrastructure::epoll_reactor> m_owned_reactor{};
+        shared::infrastructure::epoll_reactor* m_reactor{};
+        std::optional<shared::infrastructure::epoll_reactor::registration> m_registration{};
+        int m_timer_descriptor{-1};
+#elif defined(_WIN32)
+        shared::infrastructure::null_handle m_timer{};
+        shared::infrastructure::null_handle m_stop_requested{};
+#endif
+        std::thread m_worker{};
+
+        void open_timer();
+#if defined(_WIN32)
+        void wait_for_timer();
+#endif
+        void on_timer_ready();
+        [[nodiscard]] clock::duration relative_to_wheel(clock::duration const delay) const noexcept;
+        void rearm(bool const force) noexcept;
+    };
+
+}
@@ -0,0 +1,126 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <tasks/task.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+
+    /// <summary>identifies a scheduled timer, stale once a one shot timer fires or any timer is cancelled</summary>
+    struct timer_id final
+    {
+        std::uint32_t index{};
+        std::uint32_t generation{};
+
+        bool operator==(timer_id const&) const noexcept = default;
+    };
+
+    /// <summary>
+    /// hashed hierarchical timer wheel holding one shot and periodic schedules for tasks; 7 levels of 64 slots
+    /// with an occupancy bitmap per level so the next expiry is found with a handful of bit scans
+    /// </summary>
+    /// <remarks>
+    /// schedule and cancel are O(1), timers are stored in a slab and linked intrusively so steady state use
+    /// performs no allocation. not thread safe, see timer_scheduler for the timerfd driven, locked wrapper
+    /// </remarks>
+    class timer_wheel final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        struct expiration final
+        {
+            task* target{};
+            timer_id id{};
+        };
+
+        static constexpr std::size_t LEVELS = 7;
+        static constexpr std::size_t SLOTS = 64;
+
+        /// <summary>schedules target to expire once after delay</summary>
+        /// <exception cref="std::out_of_range">if delay exceeds get_maximum_delay()</exception>
+        [[nodiscard]] TASKS_DLL timer_id schedule_once(task& target, clock::duration const delay);
+        /// <summary>schedules target to expire every period, first after initial_delay (or period if not provided)</summary>
+        /// <exception cref="std::out_of_range">if period or initial_delay exceeds get_maximum_delay()</exception>
+        [[nodiscard]] TASKS_DLL timer_id schedule_periodic(task& target, clock::duration const period, std::optional<clock::duration> const initial_delay = std::nullopt);
+        [[maybe_unused]] TASKS_DLL bool cancel(timer_id const& id) noexcept;
+        [[nodiscard]] TASKS_DLL bool is_scheduled(timer_id const& id) const noexcept;
+
+        /// <summary>moves the wheel forward to now, appending every timer which has expired to expired</summary>
+        /// <remarks>periodic timers are rescheduled before being reported; if more than one period was missed they fire once</remarks>
+        [[maybe_unused]] TASKS_DLL std::size_t advance(clock::time_point const now, std::vector<expiration>& expired);
+        /// <summary>time of the earliest tick with work (an expiry or a cascade), empty if nothing is scheduled</summary>
+        [[nodiscard]] TASKS_DLL std::optional<clock::time_point> get_next_expiry() const noexcept;
+
+        /// <summary>the time the wheel was last advanced to, delays passed to schedule_once or schedule_periodic are relative to it</summary>
+        [[nodiscard]] TASKS_DLL clock::time_point get_current_time() const noexcept;
+        [[nodiscard]] TASKS_DLL std::size_t size() const noexcept;
+        [[nodiscard]] TASKS_DLL clock::duration get_resolution() const noexcept;
+        [[nodiscard]] TASKS_DLL clock::duration get_maximum_delay() const noexcept;
+
+        TASKS_DLL explicit timer_wheel(clock::duration const resolution = std::chrono::microseconds(250), clock::time_point const origin = clock::now());
+        TASKS_DLL timer_wheel(timer_wheel const&) = default;
+        TASKS_DLL timer_wheel(timer_wheel&&) noexcept = default;
+        TASKS_DLL timer_wheel& operator=(timer_wheel const&) = default;
+        TASKS_DLL timer_wheel& operator=(timer_wheel&&) noexcept = default;
+        TASKS_DLL ~timer_wheel() = default;
+
+    private:
+        static constexpr std::uint32_t NONE = 0xFFFFFFFFU;
+
+        struct node final
+        {
+            task* target{};
+            std::uint64_t deadline{};
+            std::uint64_t period{};
+            std::uint32_t previous{NONE};
+            std::uint32_t next{NONE};
+            std::uint32_t generation{};
+            std::uint8_t level{};
+            std::uint8_t slot{};
+            bool active{false};
+        };
+
+        struct level final
+        {
+            std::uint64_t occupied{};
+            std::array<std::uint32_t, SLOTS> heads{};
+        };
+
+        clock::duration m_resolution;
+        clock::time_point m_origin;
+        std::uint64_t m_current{};
+        std::vector<node> m_nodes{};
+        std::vector<std::uint32_t> m_free{};
+        std::array<level, LEVELS> m_levels{};
+        std::size_t m_active{};
+
+        [[nodiscard]] timer_id add(task& target, std::uint64_t const deadline, std::uint64_t const period);
+        void insert(std::uint32_t const index) noexcept;
+        void unlink(std::uint32_t const index) noexcept;
+        void release(std::uint32_t const index) noexcept;
+        void cascade(std::size_t const level_index, std::size_t const slot) noexcept;
+        [[nodiscard]] std::optional<std::uint64_t> next_event_tick() const noexcept;
+        [[nodiscard]] std::uint64_t to_ticks(clock::duration const delay, bool const round_up) const;
+        [[nodiscard]] std::uint64_t tick_at(clock::time_point const time) const noexcept;
+    };
+
+}
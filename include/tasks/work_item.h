@@ -0,0 +1,78 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tasks
+{
+
+    /// <summary>move only, type erased unit of work queued on an executor</summary>
+    /// <remarks>exists because std::function requires a copyable target which rules out capturing a std::promise</remarks>
+    class work_item final
+    {
+    public:
+        void operator()()
+        {
+            m_callable->invoke();
+        }
+        explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(m_callable);
+        }
+
+        template <typename CALLABLE>
+            requires (!std::is_same_v<std::decay_t<CALLABLE>, work_item> && std::is_invocable_v<std::decay_t<CALLABLE>&>)
+        work_item(CALLABLE&& callable)
+            : m_callable{std::make_unique<model<std::decay_t<CALLABLE>>>(std::forward<CALLABLE>(callable))}
+        {
+        }
+        work_item() noexcept = default;
+        work_item(work_item const&) = delete;
+        work_item(work_item&&) noexcept = default;
+        work_item& operator=(work_item const&) = delete;
+        work_item& operator=(work_item&&) noexcept = default;
+        ~work_item() = default;
+
+    private:
+        struct concept_type
+        {
+            virtual void invoke() = 0;
+            virtual ~concept_type() = default;
+        };
+
+        template <typename CALLABLE>
+        struct model final : concept_type
+        {
+            explicit model(CALLABLE&& callable)
+                : callable{std::move(callable)}
+            {
+            }
+            explicit model(CALLABLE const& callable)
+                : callable{callable}
+            {
+            }
+            void invoke() override
+            {
+                callable();
+            }
+            CALLABLE callable;
+        };
+
+        std::unique_ptr<concept_type> m_callable{};
+    };
+
+}
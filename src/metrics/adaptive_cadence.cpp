@@ -0,0 +1,105 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <metrics/adaptive_cadence.h>
+#include <algorithm>
+#include <stdexcept>
+
+using std::optional;
+using std::size_t;
+using std::uint64_t;
+
+namespace metrics
+{
+
+cadence_decision adaptive_cadence::add(clock::time_point const taken_at, uint64_t const bytes)
+{
+    // a plain value rather than optional<sample>, gcc can't see the copy is only read once set
+    auto const has_previous = !m_window.empty();
+    auto const previous = has_previous
+        ? m_window[(m_next + m_window.size() - 1U) % m_window.size()]
+        : sample{};
+
+    sample const taken{taken_at.time_since_epoch().count(), static_cast<double>(bytes)};
+    if (m_window.size() < m_thresholds.window)
+        m_window.push_back(taken);
+    else
+        m_window[m_next] = taken;
+    m_next = (m_next + 1U) % m_thresholds.window;
+
+    cadence_decision decision{m_interval, false, false};
+    if (has_previous) {
+        auto const growth = taken.value - previous.value;
+        decision.snapshot_now = growth >= static_cast<double>(m_thresholds.spike_minimum_bytes) &&
+            growth >= previous.value * m_thresholds.spike_fraction;
+    }
+
+    auto const slope = get_slope();
+    if (decision.snapshot_now)
+        m_interval = m_minimum;
+    else if (slope.has_value() && slope.value() >= m_thresholds.tighten_slope)
+        m_interval = std::max(m_minimum, m_interval / 2);
+    else if (slope.has_value() && slope.value() <= m_thresholds.relax_slope)
+        m_interval = std::min(m_maximum, m_interval * 2);
+
+    decision.changed = m_interval != decision.interval;
+    decision.interval = m_interval;
+    return decision;
+}
+
+optional<double> adaptive_cadence::get_slope() const noexcept
+{
+    if (m_window.size() < 3U)
+        return std::nullopt;
+
+    // times relative to the oldest sample, in seconds, keep the sums well within a double's precision
+    auto const oldest = m_window.size() < m_thresholds.window ? size_t{0} : m_next;
+    auto const origin = m_window[oldest].timestamp;
+    auto const count = static_cast<double>(m_window.size());
+    double sum_x{};
+    double sum_y{};
+    for (auto const& taken : m_window) {
+        sum_x += std::chrono::duration<double>(clock::duration(taken.timestamp - origin)).count();
+        sum_y += taken.value;
+    }
+    auto const mean_x = sum_x / count;
+    auto const mean_y = sum_y / count;
+    double covariance{};
+    double variance{};
+    for (auto const& taken : m_window) {
+        auto const x = std::chrono::duration<double>(clock::duration(taken.timestamp - origin)).count() - mean_x;
+        covariance += x * (taken.value - mean_y);
+        variance += x * x;
+    }
+    if (variance == 0.0)
+        return std::nullopt;
+    return covariance / variance;
+}
+
+adaptive_cadence::adaptive_cadence(clock::duration const minimum, clock::duration const maximum, cadence_thresholds const& thresholds)
+    : m_minimum{minimum}
+    , m_maximum{maximum}
+    , m_thresholds{thresholds}
+    , m_interval{minimum}
+{
+    if (m_minimum <= clock::duration::zero())
+        throw std::invalid_argument("minimum must be positive");
+    if (m_maximum < m_minimum)
+        throw std::invalid_argument("maximum must not be less than minimum");
+    if (m_thresholds.window < 3U)
+        throw std::invalid_argument("window must hold at least 3 samples");
+    m_window.reserve(m_thresholds.window);
+}
+
+}
@@ -0,0 +1,321 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <metrics/time_series.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+
+using std::array;
+using std::atomic;
+using std::int64_t;
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace metrics
+{
+
+namespace
+{
+    constexpr size_t BLOCK_HEADER_SIZE = 32U;
+    constexpr size_t WORDS_PER_BLOCK = (time_series::BLOCK_SIZE - BLOCK_HEADER_SIZE) / sizeof(uint64_t);
+    constexpr uint32_t CAPACITY_BITS = static_cast<uint32_t>(WORDS_PER_BLOCK * 64U);
+
+    // worst case: '1111' and a raw 64 bit delta of delta, then '11', 5 bits leading zeros, 6 bits length
+    // and 64 meaningful bits
+    constexpr uint32_t MAXIMUM_SAMPLE_BITS = 4U + 64U + 2U + 5U + 6U + 64U;
+    // larger than any real leading zero count so the first xor of a block always writes its window
+    constexpr uint32_t NO_WINDOW = 64U;
+    constexpr uint32_t MAXIMUM_LEADING = 31U;
+
+    [[nodiscard]] constexpr int64_t wrapping_subtract(int64_t const left, int64_t const right) noexcept
+    {
+        return static_cast<int64_t>(static_cast<uint64_t>(left) - static_cast<uint64_t>(right));
+    }
+    [[nodiscard]] constexpr int64_t wrapping_add(int64_t const left, int64_t const right) noexcept
+    {
+        return static_cast<int64_t>(static_cast<uint64_t>(left) + static_cast<uint64_t>(right));
+    }
+    [[nodiscard]] constexpr uint64_t low_bits(uint64_t const value, uint32_t const count) noexcept
+    {
+        return count >= 64U ? value : value & ((uint64_t{1} << count) - 1U);
+    }
+
+    // bits are packed most significant first; only the appending thread writes so a relaxed load and
+    // store stands in for a read-modify-write, the count published after them orders them for readers
+    void write_bits(atomic<uint64_t>* words, uint32_t& position, uint64_t const value, uint32_t const count) noexcept
+    {
+        auto const bits = low_bits(value, count);
+        auto const index = position / 64U;
+        auto const available = 64U - position % 64U;
+        if (count <= available) {
+            words[index].store(words[index].load(std::memory_order_relaxed) | bits << (available - count), std::memory_order_relaxed);
+        } else {
+            auto const spill = count - available;
+            words[index].store(words[index].load(std::memory_order_relaxed) | bits >> spill, std::memory_order_relaxed);
+            words[index + 1U].store(bits << (64U - spill), std::memory_order_relaxed);
+        }
+        position += count;
+    }
+
+    class bit_reader final
+    {
+    public:
+        [[nodiscard]] uint64_t read(uint32_t const count) noexcept
+        {
+            auto const index = m_position / 64U;
+            auto const offset = m_position % 64U;
+            auto const available = 64U - offset;
+            auto const word = m_words[index].load(std::memory_order_relaxed);
+            m_position += count;
+            if (count <= available)
+                return (word << offset) >> (64U - count);
+
+            auto const spill = count - available;
+            return low_bits(word, available) << spill | m_words[index + 1U].load(std::memory_order_relaxed) >> (64U - spill);
+        }
+        [[nodiscard]] bool read_bit() noexcept
+        {
+            return read(1U) != 0U;
+        }
+
+        explicit bit_reader(atomic<uint64_t> const* words) noexcept
+            : m_words{words}
+        {
+        }
+
+    private:
+        atomic<uint64_t> const* m_words;
+        uint32_t m_position{};
+    };
+
+    [[nodiscard]] int64_t to_signed(uint64_t const value, uint32_t const bits) noexcept
+    {
+        // buckets are stored offset so their lowest value is zero, see time_series::append
+        return static_cast<int64_t>(value) - ((int64_t{1} << (bits - 1U)) - 1);
+    }
+
+    /// visits the first count samples of a block until visitor returns false
+    template <typename VISITOR>
+    void decode(atomic<uint64_t> const* words, uint32_t const count, VISITOR visitor)
+    {
+        if (count == 0U)
+            return;
+
+        bit_reader reader(words);
+        auto timestamp = static_cast<int64_t>(reader.read(64U));
+        auto value = reader.read(64U);
+        if (!visitor(sample{timestamp, std::bit_cast<double>(value)}))
+            return;
+
+        int64_t delta{};
+        uint32_t leading{};
+        uint32_t length{};
+        for (uint32_t decoded = 1U; decoded < count; ++decoded) {
+            int64_t delta_of_delta{};
+            if (!reader.read_bit())
+                delta_of_delta = 0;
+            else if (!reader.read_bit())
+                delta_of_delta = to_signed(reader.read(7U), 7U);
+            else if (!reader.read_bit())
+                delta_of_delta = to_signed(reader.read(9U), 9U);
+            else if (!reader.read_bit())
+                delta_of_delta = to_signed(reader.read(12U), 12U);
+            else
+                delta_of_delta = static_cast<int64_t>(reader.read(64U));
+            delta = wrapping_add(delta, delta_of_delta);
+            timestamp = wrapping_add(timestamp, delta);
+
+            if (reader.read_bit()) {
+                if (reader.read_bit()) {
+                    leading = static_cast<uint32_t>(reader.read(5U));
+                    length = static_cast<uint32_t>(reader.read(6U)) + 1U;
+                }
+                value ^= reader.read(length) << (64U - leading - length);
+            }
+
+            if (!visitor(sample{timestamp, std::bit_cast<double>(value)}))
+                return;
+        }
+    }
+}
+
+struct time_series::block final
+{
+    int64_t first_timestamp{};
+    atomic<int64_t> last_timestamp{};
+    atomic<uint32_t> count{};
+    atomic<block*> next{};
+    array<atomic<uint64_t>, WORDS_PER_BLOCK> words{};
+};
+
+bool time_series::append(int64_t const timestamp, double const value)
+{
+    auto* const tail = m_tail.load(std::memory_order_relaxed);
+    if (tail != nullptr && timestamp < m_writer.previous_timestamp)
+        return false;
+
+    if (tail == nullptr || m_writer.bit_position + MAXIMUM_SAMPLE_BITS > CAPACITY_BITS) {
+        start_block(timestamp, value);
+        return true;
+    }
+
+    auto* const words = tail->words.data();
+    auto& position = m_writer.bit_position;
+
+    // timestamps: a regular cadence has a delta of delta of zero and costs one bit, jitter falls into one of
+    // three ranges each stored offset so its smallest value encodes as zero
+    auto const delta = wrapping_subtract(timestamp, m_writer.previous_timestamp);
+    auto const delta_of_delta = wrapping_subtract(delta, m_writer.previous_delta);
+    if (delta_of_delta == 0) {
+        write_bits(words, position, 0b0U, 1U);
+    } else if (delta_of_delta >= -63 && delta_of_delta <= 64) {
+        write_bits(words, position, 0b10U, 2U);
+        write_bits(words, position, static_cast<uint64_t>(delta_of_delta + 63), 7U);
+    } else if (delta_of_delta >= -255 && delta_of_delta <= 256) {
+        write_bits(words, position, 0b110U, 3U);
+        write_bits(words, position, static_cast<uint64_t>(delta_of_delta + 255), 9U);
+    } else if (delta_of_delta >= -2047 && delta_of_delta <= 2048) {
+        write_bits(words, position, 0b1110U, 4U);
+        write_bits(words, position, static_cast<uint64_t>(delta_of_delta + 2047), 12U);
+    } else {
+        write_bits(words, position, 0b1111U, 4U);
+        write_bits(words, position, static_cast<uint64_t>(delta_of_delta), 64U);
+    }
+
+    // values: an unchanged value costs one bit, otherwise the xor's meaningful bits are stored either inside
+    // the previous window of leading and trailing zeros or with a new window when they don't fit
+    auto const bits = std::bit_cast<uint64_t>(value);
+    auto const difference = bits ^ m_writer.previous_value;
+    if (difference == 0U) {
+        write_bits(words, position, 0b0U, 1U);
+    } else {
+        auto const leading = std::min(static_cast<uint32_t>(std::countl_zero(difference)), MAXIMUM_LEADING);
+        auto const trailing = static_cast<uint32_t>(std::countr_zero(difference));
+        if (leading >= m_writer.previous_leading && trailing >= m_writer.previous_trailing) {
+            write_bits(words, position, 0b10U, 2U);
+            write_bits(words, position, difference >> m_writer.previous_trailing, 64U - m_writer.previous_leading - m_writer.previous_trailing);
+        } else {
+            auto const length = 64U - leading - trailing;
+            write_bits(words, position, 0b11U, 2U);
+            write_bits(words, position, leading, 5U);
+            write_bits(words, position, length - 1U, 6U);
+            write_bits(words, position, difference >> trailing, length);
+            m_writer.previous_leading = leading;
+            m_writer.previous_trailing = trailing;
+        }
+    }
+
+    m_writer.previous_timestamp = timestamp;
+    m_writer.previous_delta = delta;
+    m_writer.previous_value = bits;
+
+    // readers check last_timestamp only after acquiring count, so it is never older than the samples they see
+    tail->last_timestamp.store(timestamp, std::memory_order_relaxed);
+    tail->count.store(tail->count.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+    m_size.fetch_add(1U, std::memory_order_relaxed);
+    return true;
+}
+
+void time_series::read(int64_t const from, int64_t const to, vector<sample>& destination) const
+{
+    auto const* current = m_head.load(std::memory_order_acquire);
+    while (current != nullptr && current->first_timestamp <= to) {
+        // next is read before count, a block is only linked once its predecessor is full so either next is
+        // set and count is final or the samples read here are the last and what's returned is still a prefix
+        auto const* const next = current->next.load(std::memory_order_acquire);
+        auto const count = current->count.load(std::memory_order_acquire);
+
+        if (current->last_timestamp.load(std::memory_order_relaxed) >= from) {
+            decode(current->words.data(), count, [from, to, &destination](sample const& decoded) {
+                if (decoded.timestamp > to)
+                    return false;
+                if (decoded.timestamp >= from)
+                    destination.push_back(decoded);
+                return true;
+            });
+        }
+        current = next;
+    }
+}
+
+optional<sample> time_series::get_last() const noexcept
+{
+    auto const* const tail = m_tail.load(std::memory_order_acquire);
+    if (tail == nullptr)
+        return nullopt;
+
+    sample last{};
+    decode(tail->words.data(), tail->count.load(std::memory_order_acquire), [&last](sample const& decoded) {
+        last = decoded;
+        return true;
+    });
+    return last;
+}
+
+size_t time_series::size() const noexcept
+{
+    return m_size.load(std::memory_order_relaxed);
+}
+
+size_t time_series::get_memory_usage() const noexcept
+{
+    return sizeof(time_series) + m_block_count.load(std::memory_order_relaxed) * sizeof(block);
+}
+
+time_series::~time_series()
+{
+    auto* current = m_head.load(std::memory_order_acquire);
+    while (current != nullptr) {
+        auto* const next = current->next.load(std::memory_order_relaxed);
+        delete current;
+        current = next;
+    }
+}
+
+void time_series::start_block(int64_t const timestamp, double const value)
+{
+    static_assert(sizeof(block) <= BLOCK_SIZE);
+
+    auto* const started = new block{};
+    auto const bits = std::bit_cast<uint64_t>(value);
+
+    // each block opens with its first sample in full so it can be decoded without any of its predecessors
+    m_writer = writer_state{};
+    write_bits(started->words.data(), m_writer.bit_position, static_cast<uint64_t>(timestamp), 64U);
+    write_bits(started->words.data(), m_writer.bit_position, bits, 64U);
+    m_writer.previous_timestamp = timestamp;
+    m_writer.previous_value = bits;
+    m_writer.previous_leading = NO_WINDOW;
+    m_writer.previous_trailing = NO_WINDOW;
+
+    started->first_timestamp = timestamp;
+    started->last_timestamp.store(timestamp, std::memory_order_relaxed);
+    started->count.store(1U, std::memory_order_relaxed);
+
+    auto* const previous = m_tail.load(std::memory_order_relaxed);
+    if (previous == nullptr)
+        m_head.store(started, std::memory_order_release);
+    else
+        previous->next.store(started, std::memory_order_release);
+    m_tail.store(started, std::memory_order_release);
+    m_block_count.fetch_add(1U, std::memory_order_relaxed);
+    m_size.fetch_add(1U, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,103 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <metrics/time_series_store.h>
+#include <mutex>
+
+using std::make_unique;
+using std::shared_lock;
+using std::size_t;
+using std::unique_lock;
+using std::vector;
+
+namespace metrics
+{
+
+size_t series_key_hash::operator()(series_key const& key) const noexcept
+{
+    auto const metric = std::hash<std::string>{}(key.metric);
+    return metric ^ (std::hash<std::uint64_t>{}(key.process_id) + 0x9e3779b97f4a7c15ULL + (metric << 6U) + (metric >> 2U));
+}
+
+time_series& time_series_store::get_or_add(series_key const& key)
+{
+    {
+        shared_lock lock(m_mutex);
+        if (auto const existing = m_series.find(key); existing != m_series.end())
+            return *existing->second;
+    }
+
+    unique_lock lock(m_mutex);
+    auto& added = m_series[key];
+    if (!added)
+        added = make_unique<time_series>();
+    return *added;
+}
+
+time_series const* time_series_store::find(series_key const& key) const
+{
+    shared_lock lock(m_mutex);
+    auto const existing = m_series.find(key);
+    return existing != m_series.end()
+        ? existing->second.get()
+        : nullptr;
+}
+
+vector<series_key> time_series_store::get_keys() const
+{
+    shared_lock lock(m_mutex);
+    vector<series_key> keys{};
+    keys.reserve(m_series.size());
+    for (auto const& [key, series] : m_series)
+        keys.push_back(key);
+    return keys;
+}
+
+bool time_series_store::remove(series_key const& key)
+{
+    unique_lock lock(m_mutex);
+    return m_series.erase(key) > 0U;
+}
+
+size_t time_series_store::remove_process(std::uint64_t const process_id)
+{
+    unique_lock lock(m_mutex);
+    return std::erase_if(m_series, [process_id](auto const& entry) { return entry.first.process_id == process_id; });
+}
+
+size_t time_series_store::remove_idle(std::int64_t const last_before)
+{
+    unique_lock lock(m_mutex);
+    return std::erase_if(m_series, [last_before](auto const& entry) {
+        auto const last = entry.second->get_last();
+        return last.has_value() && last->timestamp < last_before;
+    });
+}
+
+size_t time_series_store::size() const
+{
+    shared_lock lock(m_mutex);
+    return m_series.size();
+}
+
+size_t time_series_store::get_memory_usage() const
+{
+    shared_lock lock(m_mutex);
+    auto total = m_series.size() * (sizeof(series_key) + sizeof(std::unique_ptr<time_series>));
+    for (auto const& [key, series] : m_series)
+        total += series->get_memory_usage();
+    return total;
+}
+
+}
@@ -0,0 +1,221 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#if defined(__linux__)
+
+#include "shared/epoll_reactor.h"
+#include <cerrno>
+#include <limits>
+#include <system_error>
+
+using std::nullopt;
+using std::optional;
+using std::uint32_t;
+using std::uint64_t;
+
+namespace shared::infrastructure
+{
+
+namespace
+{
+    constexpr uint64_t WAKE_TOKEN = std::numeric_limits<uint64_t>::max();
+
+    constexpr uint64_t to_token(uint32_t const slot, uint32_t const generation) noexcept
+    {
+        return (static_cast<uint64_t>(generation) << 32) | slot;
+    }
+}
+
+epoll_reactor::epoll_reactor(std::size_t const max_events_per_wait)
+    : m_epoll{::epoll_create1(EPOLL_CLOEXEC)}
+    , m_wake{make_eventfd()}
+    , m_events(std::max<std::size_t>(max_events_per_wait, 1U))
+{
+    if (!static_cast<bool>(m_epoll))
+        throw std::system_error(errno, std::system_category(), "epoll_create1 failed");
+    if (!static_cast<bool>(m_wake))
+        throw std::system_error(errno, std::system_category(), "eventfd failed");
+
+    epoll_event wake{};
+    wake.events = EPOLLIN;
+    wake.data.u64 = WAKE_TOKEN;
+    if (::epoll_ctl(m_epoll.Get(), EPOLL_CTL_ADD, m_wake.Get(), &wake) != 0)
+        throw std::system_error(errno, std::system_category(), "unable to register wake descriptor");
+}
+
+optional<epoll_reactor::registration> epoll_reactor::add_descriptor(posix_fd descriptor, uint32_t const events, callback on_ready)
+{
+    if (!static_cast<bool>(descriptor) || !on_ready)
+        return nullopt;
+
+    uint32_t index{};
+    if (!m_free_slots.empty()) {
+        index = m_free_slots.back();
+        m_free_slots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+        m_free_slots.reserve(m_slots.size());
+    }
+
+    auto& entry = m_slots[index];
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = to_token(index, entry.generation);
+    if (::epoll_ctl(m_epoll.Get(), EPOLL_CTL_ADD, descriptor.Get(), &event) != 0) {
+        m_free_slots.push_back(index);
+        return nullopt;
+    }
+
+    entry.descriptor = std::move(descriptor);
+    entry.on_ready = std::move(on_ready);
+    ++m_registered;
+    return registration{index, entry.generation};
+}
+
+bool epoll_reactor::modify(registration const& id, uint32_t const events) noexcept
+{
+    auto const* entry = find(id);
+    if (entry == nullptr)
+        return false;
+
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = to_token(id.slot, id.generation);
+    return ::epoll_ctl(m_epoll.Get(), EPOLL_CTL_MOD, entry->descriptor.Get(), &event) == 0;
+}
+
+bool epoll_reactor::remove(registration const& id) noexcept
+{
+    auto* entry = find(id);
+    if (entry == nullptr)
+        return false;
+
+    ::epoll_ctl(m_epoll.Get(), EPOLL_CTL_DEL, entry->descriptor.Get(), nullptr);
+    entry->descriptor.Reset();
+    ++entry->generation;
+    --m_registered;
+
+    // the callback may be the one removing itself, it can only be destroyed once it has returned
+    if (m_dispatching == id.slot)
+        entry->release_after_dispatch = true;
+    else
+        release(id.slot);
+    return true;
+}
+
+optional<int> epoll_reactor::get_descriptor(registration const& id) const noexcept
+{
+    auto const* entry = find(id);
+    return entry != nullptr
+        ? optional(entry->descriptor.Get())
+        : nullopt;
+}
+
+std::size_t epoll_reactor::size() const noexcept
+{
+    return m_registered;
+}
+
+std::size_t epoll_reactor::run_once(optional<std::chrono::milliseconds> const timeout)
+{
+    auto const timeout_ms = timeout.has_value()
+        ? static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.value().count(), std::numeric_limits<int>::max()))
+        : -1;
+
+    auto const ready = ::epoll_wait(m_epoll.Get(), m_events.data(), static_cast<int>(m_events.size()), timeout_ms);
+    if (ready < 0) {
+        if (errno == EINTR)
+            return 0U;
+        throw std::system_error(errno, std::system_category(), "epoll_wait failed");
+    }
+
+    std::size_t dispatched{};
+    for (auto i = 0; i < ready; ++i) {
+        auto const token = m_events[i].data.u64;
+        if (token == WAKE_TOKEN) {
+            uint64_t ignored{};
+            static_cast<void>(::read(m_wake.Get(), &ignored, sizeof(ignored)));
+            continue;
+        }
+
+        auto const index = static_cast<uint32_t>(token & 0xFFFFFFFFU);
+        auto const generation = static_cast<uint32_t>(token >> 32);
+        auto* entry = find(registration{index, generation});
+        if (entry == nullptr)
+            continue; // removed by an earlier callback in this batch
+
+        m_dispatching = index;
+        try {
+            entry->on_ready(entry->descriptor.Get(), m_events[i].events);
+        } catch (...) {
+            m_dispatching = nullopt;
+            if (entry->release_after_dispatch)
+                release(index);
+            throw;
+        }
+        m_dispatching = nullopt;
+
+        if (entry->release_after_dispatch)
+            release(index);
+        ++dispatched;
+    }
+    return dispatched;
+}
+
+void epoll_reactor::run()
+{
+    while (!m_stop_requested.exchange(false, std::memory_order_acq_rel))
+        run_once();
+}
+
+void epoll_reactor::stop() noexcept
+{
+    m_stop_requested.store(true, std::memory_order_release);
+    uint64_t const one{1U};
+    static_cast<void>(::write(m_wake.Get(), &one, sizeof(one)));
+}
+
+epoll_reactor::slot* epoll_reactor::find(registration const& id) noexcept
+{
+    if (id.slot >= m_slots.size())
+        return nullptr;
+    auto& entry = m_slots[id.slot];
+    return entry.generation == id.generation && static_cast<bool>(entry.descriptor)
+        ? &entry
+        : nullptr;
+}
+
+epoll_reactor::slot const* epoll_reactor::find(registration const& id) const noexcept
+{
+    if (id.slot >= m_slots.size())
+        return nullptr;
+    auto const& entry = m_slots[id.slot];
+    return entry.generation == id.generation && static_cast<bool>(entry.descriptor)
+        ? &entry
+        : nullptr;
+}
+
+void epoll_reactor::release(uint32_t const index) noexcept
+{
+    auto& entry = m_slots[index];
+    entry.on_ready = nullptr;
+    entry.release_after_dispatch = false;
+    m_free_slots.push_back(index);
+}
+
+}
+
+#endif
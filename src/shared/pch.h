@@ -24,10 +24,13 @@
 
 #include "shared/string_extensions.h"
 
+#if defined(_WIN32)
 #include <Windows.h>
 #include <sdkddkver.h>
 #include <processthreadsapi.h>
 
 #include "shared/invalid_handle.h"
 #include "shared/null_handle.h"
+#endif
+
 #include "shared/not_found_exception.h"
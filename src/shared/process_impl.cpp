@@ -12,7 +12,11 @@
 // 
 
 #include "pch.h"
+
+#if defined(_WIN32)
+
 #include "process_impl.h"
+#include <Psapi.h>
 #include <tuple>
 
 using std::find_if;
@@ -79,6 +83,14 @@ vector<unique_process> process_impl::get_processes_by_name(string_view const& pr
     return filtered;
 }
 
+unique_process process_impl::get_process_by_id(unsigned long const process_id)
+{
+    auto process = std::make_unique<process_impl>(process_id);
+    if (!static_cast<bool>(process->m_process_handle))
+        return unique_process();
+    return unique_process(std::move(process));
+}
+
 unsigned long process_impl::get_id() const noexcept
 {
     return m_process_id;
@@ -122,6 +134,13 @@ void process_impl::wait_for_exit() const noexcept {
         WaitForSingleObject(m_process_handle.Get(), INFINITE);
 }
 
+bool process_impl::terminate(unsigned long const exit_code) noexcept
+{
+    if (!is_running())
+        return false;
+    return TerminateProcess(m_process_handle.Get(), exit_code) == TRUE;
+}
+
 optional<std::filesystem::path> process_impl::get_path_to_running_process(string_view const& process_name) const noexcept
 {
     try {
@@ -139,6 +158,17 @@ optional<std::filesystem::path> process_impl::get_path_to_running_process(string
     }
 }
 
+optional<std::uint64_t> process_impl::get_private_bytes() const noexcept
+{
+    if (!static_cast<bool>(m_process_handle))
+        return nullopt;
+
+    PROCESS_MEMORY_COUNTERS_EX counters{};
+    if (GetProcessMemoryInfo(m_process_handle.Get(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)) == FALSE)
+        return nullopt;
+    return optional<std::uint64_t>(counters.PrivateUsage);
+}
+
 process_impl::process_impl(unsigned long const process_id)
     : m_process_id(process_id) {
     m_process_handle.Reset( OpenProcess(PROCESS_ALL_ACCESS, FALSE, process_id));
@@ -296,4 +326,6 @@ bool operator==(process_impl const& left_hand_side, process_impl const& right_ha
     return &left_hand_side == &right_hand_side || left_hand_side.equals(right_hand_side);
 }
 
-}
\ No newline at end of file
+}
+
+#endif
@@ -12,9 +12,17 @@
 // 
 
 #pragma once
+#if defined(_WIN32)
 #include <TlHelp32.h>
+#elif defined(__linux__)
+#include <mutex>
+#include <sys/types.h>
+#include "shared/pidfd.h"
+#endif
 #include "shared/process.h"
 
+#if defined(_WIN32)
+
 namespace shared::model
 {
     class process_impl final : public process
@@ -22,12 +30,16 @@ namespace shared::model
     public:
         static unique_process start(std::string_view const& filename, std::string_view const& arguments);
         static std::vector<unique_process> get_processes_by_name(std::string_view const& process_name);
+        static unique_process get_process_by_id(unsigned long const process_id);
 
         [[nodiscard]] unsigned long get_id() const noexcept final;
         [[nodiscard]] bool is_running() const noexcept final;
         [[nodiscard]] std::optional<unsigned long> exit_code() const noexcept final;
         void wait_for_exit() const noexcept final; 
+        [[maybe_unused]] bool terminate(unsigned long const exit_code) noexcept final;
         [[nodiscard]] std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& process_name) const noexcept final;
+        /// <remarks>PrivateUsage, the commit charge which is Private Bytes in performance monitor</remarks>
+        [[nodiscard]] std::optional<std::uint64_t> get_private_bytes() const noexcept final;
 
         process_impl() = default;
         explicit process_impl(unsigned long const process_id);
@@ -59,3 +71,48 @@ namespace shared::model
 
 }
 
+#elif defined(__linux__)
+
+namespace shared::model
+{
+    /// <summary>process backed by a pidfd, launched processes are children of this one and reaped by it</summary>
+    class process_impl final : public process
+    {
+    public:
+        static unique_process start(std::string_view const& filename, std::string_view const& arguments);
+        static std::vector<unique_process> get_processes_by_name(std::string_view const& process_name);
+        static unique_process get_process_by_id(unsigned long const process_id);
+
+        [[nodiscard]] unsigned long get_id() const noexcept final;
+        [[nodiscard]] bool is_running() const noexcept final;
+        [[nodiscard]] std::optional<unsigned long> exit_code() const noexcept final;
+        void wait_for_exit() const noexcept final;
+        /// <remarks>signals cannot carry an exit code, the process is killed and exit_code reports SIGKILL</remarks>
+        [[maybe_unused]] bool terminate(unsigned long const exit_code) noexcept final;
+        [[nodiscard]] std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& process_name) const noexcept final;
+        /// <remarks>resident pages less those shared with other processes, from /proc/[pid]/statm</remarks>
+        [[nodiscard]] std::optional<std::uint64_t> get_private_bytes() const noexcept final;
+
+        process_impl() = default;
+        explicit process_impl(pid_t const process_id, bool const launched = false);
+        process_impl(const process_impl&) = delete;
+        process_impl& operator=(const process_impl&) = delete;
+        process_impl(process_impl&& other) noexcept = delete;
+        process_impl& operator=(process_impl&& other) noexcept = delete;
+        ~process_impl() override;
+
+    private:
+        pid_t m_process_id{};
+        bool m_process_launched{};
+        shared::infrastructure::pidfd m_process_handle{};
+        mutable std::mutex m_exit_mutex{};
+        mutable std::optional<unsigned long> m_exit_code{};
+
+        [[nodiscard]] bool reap(bool const wait) const noexcept;
+        [[nodiscard]] static std::optional<std::filesystem::path> get_executable(pid_t const process_id);
+        [[nodiscard]] static std::vector<pid_t> get_process_ids_by_name(std::string_view const& process_name);
+    };
+
+}
+
+#endif
@@ -0,0 +1,281 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#if defined(__linux__)
+
+#include "process_impl.h"
+#include <cerrno>
+#include <csignal>
+#include <fstream>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using std::nullopt;
+using std::optional;
+using std::string;
+using std::string_view;
+using std::vector;
+using std::filesystem::path;
+
+using shared::infrastructure::make_pidfd;
+
+extern char** environ;
+
+namespace shared::model
+{
+
+namespace
+{
+    // splits on whitespace, double quotes group words containing spaces
+    vector<string> split_arguments(string_view const& arguments)
+    {
+        vector<string> split{};
+        string current{};
+        bool quoted{};
+        bool in_word{};
+        for (auto const character : arguments) {
+            if (character == '"') {
+                quoted = !quoted;
+                in_word = true;
+            } else if (!quoted && (character == ' ' || character == '\t')) {
+                if (in_word)
+                    split.push_back(std::move(current));
+                current.clear();
+                in_word = false;
+            } else {
+                current.push_back(character);
+                in_word = true;
+            }
+        }
+        if (in_word)
+            split.push_back(std::move(current));
+        return split;
+    }
+
+    optional<pid_t> to_process_id(string const& name)
+    {
+        if (name.empty() || name.find_first_not_of("0123456789") != string::npos)
+            return nullopt;
+        return static_cast<pid_t>(std::stol(name));
+    }
+
+    unsigned long to_exit_code(int const status) noexcept
+    {
+        if (WIFEXITED(status))
+            return static_cast<unsigned long>(WEXITSTATUS(status));
+        if (WIFSIGNALED(status))
+            return 128UL + static_cast<unsigned long>(WTERMSIG(status));
+        return 0UL;
+    }
+}
+
+unique_process process_impl::start(string_view const& filename, string_view const& arguments)
+{
+    auto const absolutePath = std::filesystem::absolute(filename).string();
+
+    if (!std::filesystem::exists(absolutePath) || !std::filesystem::is_regular_file(absolutePath))
+        throw std::invalid_argument("file not found");
+
+    auto arguments_list = split_arguments(arguments);
+    vector<char*> argv{};
+    argv.reserve(arguments_list.size() + 2U);
+    argv.push_back(const_cast<char*>(absolutePath.c_str()));
+    for (auto& argument : arguments_list)
+        argv.push_back(argument.data());
+    argv.push_back(nullptr);
+
+    pid_t process_id{};
+    if (::posix_spawn(&process_id, absolutePath.c_str(), nullptr, nullptr, argv.data(), environ) != 0)
+        return unique_process();
+    return unique_process(new process_impl(process_id, true));
+}
+
+vector<unique_process> process_impl::get_processes_by_name(string_view const& process_name)
+{
+    vector<unique_process> filtered{};
+    for (auto const process_id : get_process_ids_by_name(process_name)) {
+        auto process = std::make_unique<process_impl>(process_id);
+        // the process may have exited between listing /proc and opening it
+        if (static_cast<bool>(process->m_process_handle))
+            filtered.emplace_back(std::move(process));
+    }
+    return filtered;
+}
+
+unique_process process_impl::get_process_by_id(unsigned long const process_id)
+{
+    auto process = std::make_unique<process_impl>(static_cast<pid_t>(process_id));
+    if (!static_cast<bool>(process->m_process_handle))
+        return unique_process();
+    return unique_process(std::move(process));
+}
+
+unsigned long process_impl::get_id() const noexcept
+{
+    return static_cast<unsigned long>(m_process_id);
+}
+
+bool process_impl::is_running() const noexcept
+{
+    if (m_process_launched)
+        return !reap(false);
+    if (!static_cast<bool>(m_process_handle))
+        return false;
+
+    // a pidfd becomes readable once the process it refers to has exited
+    pollfd descriptor{m_process_handle.Get(), POLLIN, 0};
+    return ::poll(&descriptor, 1, 0) == 0;
+}
+
+optional<unsigned long> process_impl::exit_code() const noexcept
+{
+    if (!m_process_launched || !reap(false))
+        return nullopt;
+
+    std::lock_guard lock(m_exit_mutex);
+    return m_exit_code;
+}
+
+void process_impl::wait_for_exit() const noexcept
+{
+    if (m_process_launched) {
+        static_cast<void>(reap(true));
+        return;
+    }
+    if (!static_cast<bool>(m_process_handle))
+        return;
+
+    pollfd descriptor{m_process_handle.Get(), POLLIN, 0};
+    while (::poll(&descriptor, 1, -1) < 0 && errno == EINTR) {
+    }
+}
+
+bool process_impl::terminate(unsigned long const) noexcept
+{
+    if (!is_running())
+        return false;
+    return ::syscall(SYS_pidfd_send_signal, m_process_handle.Get(), SIGKILL, nullptr, 0U) == 0;
+}
+
+optional<path> process_impl::get_path_to_running_process(string_view const& process_name) const noexcept
+{
+    try {
+        auto const process_ids = get_process_ids_by_name(process_name);
+        if (process_ids.empty())
+            return nullopt;
+        return get_executable(process_ids.front());
+    } catch (std::exception const&) {
+        return nullopt;
+    }
+}
+
+optional<std::uint64_t> process_impl::get_private_bytes() const noexcept
+{
+    try {
+        // size resident shared text lib data dirty, all in pages
+        std::ifstream statm(path("/proc") / std::to_string(m_process_id) / "statm");
+        std::uint64_t size{};
+        std::uint64_t resident{};
+        std::uint64_t shared{};
+        if (!(statm >> size >> resident >> shared) || shared > resident)
+            return nullopt;
+        return optional<std::uint64_t>((resident - shared) * static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE)));
+    } catch (std::exception const&) {
+        return nullopt;
+    }
+}
+
+process_impl::process_impl(pid_t const process_id, bool const launched)
+    : m_process_id{process_id}
+    , m_process_launched{launched}
+    , m_process_handle{make_pidfd(process_id)}
+{
+}
+
+process_impl::~process_impl()
+{
+    // as on windows a launched process is waited for, here that also stops it being left as a zombie
+    if (m_process_launched)
+        wait_for_exit();
+}
+
+bool process_impl::reap(bool const wait) const noexcept
+{
+    if (wait) {
+        // WNOWAIT leaves the child to be reaped below, so the lock isn't held while blocked
+        siginfo_t information{};
+        while (::waitid(P_PID, static_cast<id_t>(m_process_id), &information, WEXITED | WNOWAIT) < 0 && errno == EINTR) {
+        }
+    }
+
+    std::lock_guard lock(m_exit_mutex);
+    if (m_exit_code.has_value())
+        return true;
+
+    int status{};
+    pid_t result{};
+    do {
+        result = ::waitpid(m_process_id, &status, WNOHANG);
+    } while (result < 0 && errno == EINTR);
+
+    if (result != m_process_id)
+        return result < 0;
+    m_exit_code = to_exit_code(status);
+    return true;
+}
+
+optional<path> process_impl::get_executable(pid_t const process_id)
+{
+    std::error_code error{};
+    auto executable = std::filesystem::read_symlink(path("/proc") / std::to_string(process_id) / "exe", error);
+    if (error)
+        return nullopt;
+    return executable;
+}
+
+vector<pid_t> process_impl::get_process_ids_by_name(string_view const& process_name)
+{
+    vector<pid_t> matching{};
+    if (process_name.empty())
+        return matching;
+
+    std::error_code error{};
+    for (auto const& entry : std::filesystem::directory_iterator("/proc", error)) {
+        auto const process_id = to_process_id(entry.path().filename().string());
+        if (!process_id.has_value())
+            continue;
+
+        // the executable's file name is the closest match to a windows image name, comm is truncated to 15
+        // characters but is readable for processes owned by other users
+        auto const executable = get_executable(process_id.value());
+        if (executable.has_value()) {
+            if (executable.value().filename() == process_name)
+                matching.push_back(process_id.value());
+            continue;
+        }
+
+        std::ifstream comm_file(entry.path() / "comm");
+        string comm{};
+        if (std::getline(comm_file, comm) && comm == process_name)
+            matching.push_back(process_id.value());
+    }
+    return matching;
+}
+
+}
+
+#endif
@@ -65,6 +65,15 @@ vector<unique_process> process_service_impl::get_processes_by_name(string_view c
         return vector<unique_process>();
     }
 }
+unique_process process_service_impl::get_process_by_id(unsigned long const process_id) const noexcept
+{
+    try {
+        return process_impl::get_process_by_id(process_id);
+    }
+    catch (std::exception const&) {
+        return unique_process();
+    }
+}
 optional<std::filesystem::path> process_service_impl::get_path_to_running_process(string_view const& process_name) const noexcept
 {
     return process_impl().get_path_to_running_process(process_name);
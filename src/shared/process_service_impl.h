@@ -22,6 +22,7 @@ namespace shared::service {
     public:
         [[nodiscard]] SHARED_DLL unique_process start_process(std::string_view const& filename, std::string_view const& arguments) const noexcept override;
         [[nodiscard]] SHARED_DLL std::vector<unique_process> get_processes_by_name(std::string_view const& process_name) const noexcept override;
+        [[nodiscard]] SHARED_DLL unique_process get_process_by_id(unsigned long const process_id) const noexcept override;
         [[nodiscard]] SHARED_DLL std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& process_name) const noexcept override;
 
         SHARED_DLL process_service_impl() = default;
@@ -0,0 +1,105 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/arena.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+using std::byte;
+using std::size_t;
+using std::string_view;
+
+namespace snapshot
+{
+
+void* arena::allocate(size_t const size, size_t const alignment)
+{
+    if (size == 0U)
+        return m_next;
+
+    void* aligned = m_next;
+    auto space = m_remaining;
+    if (m_next != nullptr && std::align(alignment, size, aligned, space) != nullptr) {
+        m_next = static_cast<byte*>(aligned) + size;
+        m_remaining = space - size;
+        return aligned;
+    }
+
+    // an oversized request gets a block of its own, leaving the current block to be filled further
+    auto const needed = size + alignment - 1U;
+    auto const block_size = std::max(needed, m_block_size);
+    std::unique_ptr<byte[]> block(new byte[block_size]);
+    aligned = block.get();
+    space = block_size;
+    static_cast<void>(std::align(alignment, size, aligned, space));
+    // the block is owned before anything points into it, a push_back that throws leaves the arena as it was
+    m_blocks.push_back(std::move(block));
+    m_reserved += block_size;
+    if (needed <= m_block_size) {
+        m_next = static_cast<byte*>(aligned) + size;
+        m_remaining = space - size;
+    }
+    return aligned;
+}
+
+string_view arena::copy(string_view const& text)
+{
+    auto* const copied = allocate_array<char>(text.size());
+    if (!text.empty())
+        std::memcpy(copied, text.data(), text.size());
+    return string_view(copied, text.size());
+}
+
+void arena::clear() noexcept
+{
+    m_blocks.clear();
+    m_next = nullptr;
+    m_remaining = 0U;
+    m_reserved = 0U;
+}
+
+arena::arena(size_t const block_size)
+    : m_block_size{block_size}
+{
+    if (block_size == 0U)
+        throw std::invalid_argument("block_size must be positive");
+}
+
+arena::arena(arena&& other) noexcept
+    : m_block_size{other.m_block_size}
+    , m_blocks{std::move(other.m_blocks)}
+    , m_next{std::exchange(other.m_next, nullptr)}
+    , m_remaining{std::exchange(other.m_remaining, 0U)}
+    , m_reserved{std::exchange(other.m_reserved, 0U)}
+{
+    other.m_blocks.clear();
+}
+
+arena& arena::operator=(arena&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+    m_block_size = other.m_block_size;
+    m_blocks = std::move(other.m_blocks);
+    other.m_blocks.clear();
+    m_next = std::exchange(other.m_next, nullptr);
+    m_remaining = std::exchange(other.m_remaining, 0U);
+    m_reserved = std::exchange(other.m_reserved, 0U);
+    return *this;
+}
+
+}
@@ -0,0 +1,141 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace snapshot::encoding
+{
+
+    constexpr std::array<std::uint32_t, 256> make_crc_table() noexcept
+    {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t index = 0; index < table.size(); ++index) {
+            auto value = index;
+            for (auto bit = 0; bit < 8; ++bit)
+                value = (value & 1U) != 0U ? 0xEDB88320U ^ (value >> 1U) : value >> 1U;
+            table[index] = value;
+        }
+        return table;
+    }
+    inline constexpr auto CRC_TABLE = make_crc_table();
+
+    inline std::uint32_t crc32(std::string_view const& data) noexcept
+    {
+        std::uint32_t crc = 0xFFFFFFFFU;
+        for (auto const character : data)
+            crc = CRC_TABLE[(crc ^ static_cast<std::uint8_t>(character)) & 0xFFU] ^ (crc >> 8U);
+        return crc ^ 0xFFFFFFFFU;
+    }
+
+    /// <summary>little endian, length bytes</summary>
+    inline void put_fixed(std::string& destination, std::uint64_t value, std::size_t const length)
+    {
+        for (std::size_t index = 0; index < length; ++index, value >>= 8U)
+            destination.push_back(static_cast<char>(value & 0xFFU));
+    }
+
+    /// <summary>seven bits per byte, least significant first, high bit set on all but the last</summary>
+    inline void put_varint(std::string& destination, std::uint64_t value)
+    {
+        while (value >= 0x80U) {
+            destination.push_back(static_cast<char>(value | 0x80U));
+            value >>= 7U;
+        }
+        destination.push_back(static_cast<char>(value));
+    }
+
+    /// <summary>maps small magnitudes of either sign to small unsigned values so they varint encode compactly</summary>
+    [[nodiscard]] constexpr std::uint64_t zigzag(std::int64_t const value) noexcept
+    {
+        return (static_cast<std::uint64_t>(value) << 1U) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+    [[nodiscard]] constexpr std::int64_t unzigzag(std::uint64_t const value) noexcept
+    {
+        return static_cast<std::int64_t>(value >> 1U) ^ -static_cast<std::int64_t>(value & 1U);
+    }
+
+    /// <summary>reads values written by the put functions, a read past the end marks the reader failed and yields zero</summary>
+    class byte_reader final
+    {
+    public:
+        [[nodiscard]] std::uint64_t get_fixed(std::size_t const length) noexcept
+        {
+            if (m_data.size() - m_position < length) {
+                fail();
+                return 0U;
+            }
+            std::uint64_t value{};
+            for (auto index = length; index > 0; --index)
+                value = (value << 8U) | static_cast<std::uint8_t>(m_data[m_position + index - 1U]);
+            m_position += length;
+            return value;
+        }
+
+        [[nodiscard]] std::uint64_t get_varint() noexcept
+        {
+            std::uint64_t value{};
+            for (unsigned int shift = 0; shift < 64U; shift += 7U) {
+                if (m_position == m_data.size())
+                    break;
+                auto const next = static_cast<std::uint8_t>(m_data[m_position++]);
+                value |= static_cast<std::uint64_t>(next & 0x7FU) << shift;
+                if ((next & 0x80U) == 0U)
+                    return value;
+            }
+            fail();
+            return 0U;
+        }
+
+        [[nodiscard]] std::string_view get_bytes(std::size_t const length) noexcept
+        {
+            if (m_data.size() - m_position < length) {
+                fail();
+                return {};
+            }
+            auto const bytes = m_data.substr(m_position, length);
+            m_position += length;
+            return bytes;
+        }
+
+        [[nodiscard]] bool has_failed() const noexcept
+        {
+            return m_failed;
+        }
+        [[nodiscard]] bool at_end() const noexcept
+        {
+            return m_position == m_data.size();
+        }
+
+        explicit byte_reader(std::string_view const& data) noexcept
+            : m_data{data}
+        {
+        }
+
+    private:
+        std::string_view m_data;
+        std::size_t m_position{};
+        bool m_failed{};
+
+        void fail() noexcept
+        {
+            m_failed = true;
+            m_position = m_data.size();
+        }
+    };
+
+}
@@ -0,0 +1,256 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/flame_graph.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+using std::int64_t;
+using std::ostream;
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace snapshot
+{
+
+namespace
+{
+    constexpr size_t INITIAL_SLOTS = 1024U;
+
+    [[nodiscard]] constexpr uint64_t mix(uint64_t value) noexcept
+    {
+        value ^= value >> 29U;
+        value *= 0xBF58476D1CE4E5B9ULL;
+        return value ^ value >> 32U;
+    }
+
+    /// <summary>output is built up in a buffer written out in large pieces, a stream insertion per field dominates otherwise</summary>
+    constexpr size_t FLUSH_SIZE = 64U * 1024U;
+
+    void flush_if_full(ostream& output, string& buffer)
+    {
+        if (buffer.size() < FLUSH_SIZE)
+            return;
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    void append_number(string& buffer, int64_t const value)
+    {
+        char digits[24]{};
+        auto const [end, error] = std::to_chars(std::begin(digits), std::end(digits), value);
+        buffer.append(digits, end);
+    }
+
+    /// <summary>appends text as a single folded frame, ';' separates frames and a newline ends the stack</summary>
+    void append_folded_frame(string& buffer, string_view const& text)
+    {
+        auto const start = buffer.size();
+        buffer += text;
+        for (auto index = start; index < buffer.size(); ++index)
+            if (buffer[index] == ';' || static_cast<unsigned char>(buffer[index]) < 0x20U)
+                buffer[index] = '_';
+    }
+
+    void append_json_string(string& buffer, string_view const& text)
+    {
+        buffer += '"';
+        // frames rarely need escaping, the runs between characters which do are appended whole
+        size_t appended{};
+        for (size_t index = 0; index < text.size(); ++index) {
+            auto const code = static_cast<unsigned char>(text[index]);
+            if (code != '"' && code != '\\' && code >= 0x20U)
+                continue;
+
+            buffer.append(text, appended, index - appended);
+            appended = index + 1U;
+            if (code < 0x20U) {
+                char escaped[8]{};
+                std::snprintf(escaped, sizeof(escaped), "\\u%04X", static_cast<unsigned int>(code));
+                buffer += escaped;
+            } else {
+                buffer += '\\';
+                buffer += text[index];
+            }
+        }
+        buffer.append(text, appended);
+        buffer += '"';
+    }
+}
+
+void flame_graph::add(heap_snapshot const& snapshot)
+{
+    for (auto const& site : snapshot.get_sites())
+        add_bytes(site.trace, static_cast<int64_t>(site.bytes));
+}
+
+void flame_graph::apply(snapshot_diff const& diff)
+{
+    if (diff.deltas.size() != diff.changed_sites)
+        throw std::invalid_argument("diff must include every changed site");
+
+    for (auto const& delta : diff.deltas)
+        add_bytes(delta.trace, delta.bytes_delta);
+}
+
+void flame_graph::write_folded(ostream& output, int64_t const minimum_bytes) const
+{
+    string path{};
+    string buffer{};
+    buffer.reserve(FLUSH_SIZE * 2U);
+    write_folded(output, 0U, std::max(minimum_bytes, int64_t{1}), path, buffer);
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void flame_graph::write_json(ostream& output, int64_t const minimum_bytes) const
+{
+    string buffer{};
+    buffer.reserve(FLUSH_SIZE * 2U);
+    write_json(output, 0U, std::max(minimum_bytes, int64_t{1}), buffer);
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+flame_graph::flame_graph(trace_table const& traces)
+    : m_traces{traces}
+    , m_nodes(1U)
+    , m_children(INITIAL_SLOTS)
+{
+}
+
+void flame_graph::add_bytes(trace_id const trace, int64_t const bytes)
+{
+    auto const leaf = get_leaf(trace);
+    auto& self_bytes = m_nodes[leaf].self_bytes;
+    auto const grown = std::max(self_bytes + bytes, int64_t{0}) - std::max(self_bytes, int64_t{0});
+    self_bytes += bytes;
+    for (auto index = leaf; index != NONE; index = m_nodes[index].parent) {
+        m_nodes[index].bytes += bytes;
+        m_nodes[index].grown_bytes += grown;
+    }
+}
+
+uint32_t flame_graph::get_leaf(trace_id const trace)
+{
+    if (trace >= m_leaves.size())
+        m_leaves.resize(static_cast<size_t>(trace) + 1U, NONE);
+    if (m_leaves[trace] != NONE)
+        return m_leaves[trace];
+
+    // umdh lists the allocating frame first, a flame graph grows from the outermost
+    auto const frames = m_traces.get_trace(trace);
+    // the root is never written, a trace without frames gets a leaf of its own so its bytes still show
+    if (frames.empty()) {
+        m_leaves[trace] = get_child(0U, UNKNOWN_FRAME);
+        return m_leaves[trace];
+    }
+    uint32_t index{};
+    for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame)
+        index = get_child(index, *frame);
+    m_leaves[trace] = index;
+    return index;
+}
+
+uint32_t flame_graph::get_child(uint32_t const parent, frame_id const frame)
+{
+    auto const key = static_cast<uint64_t>(parent) << 32U | frame;
+    auto mask = m_children.size() - 1U;
+    auto slot = static_cast<size_t>(mix(key)) & mask;
+    for (; m_children[slot].node != NONE; slot = (slot + 1U) & mask)
+        if (m_children[slot].key == key)
+            return m_children[slot].node;
+
+    auto const added = static_cast<uint32_t>(m_nodes.size());
+    auto& created = m_nodes.emplace_back();
+    created.frame = frame;
+    created.parent = parent;
+    created.next_sibling = m_nodes[parent].first_child;
+    m_nodes[parent].first_child = added;
+    m_children[slot] = child_slot{key, added};
+
+    // kept at most half full, linear probing stays short
+    if (m_nodes.size() * 2U > m_children.size()) {
+        vector<child_slot> grown(m_children.size() * 2U);
+        mask = grown.size() - 1U;
+        for (auto const& existing : m_children) {
+            if (existing.node == NONE)
+                continue;
+            auto index = static_cast<size_t>(mix(existing.key)) & mask;
+            while (grown[index].node != NONE)
+                index = (index + 1U) & mask;
+            grown[index] = existing;
+        }
+        m_children = std::move(grown);
+    }
+    return added;
+}
+
+string_view flame_graph::get_name(node const& current) const
+{
+    return current.frame == UNKNOWN_FRAME ? string_view("[unknown]") : m_traces.get_frame(current.frame);
+}
+
+void flame_graph::write_folded(ostream& output, uint32_t const index, int64_t const minimum_bytes, string& path, string& buffer) const
+{
+    auto const& current = m_nodes[index];
+    auto const length = path.size();
+    if (index != 0U) {
+        if (length != 0U)
+            path += ';';
+        append_folded_frame(path, get_name(current));
+        if (current.self_bytes > 0) {
+            buffer += path;
+            buffer += ' ';
+            append_number(buffer, current.self_bytes);
+            buffer += '\n';
+            flush_if_full(output, buffer);
+        }
+    }
+    for (auto child = current.first_child; child != NONE; child = m_nodes[child].next_sibling)
+        if (m_nodes[child].grown_bytes >= minimum_bytes)
+            write_folded(output, child, minimum_bytes, path, buffer);
+    path.resize(length);
+}
+
+void flame_graph::write_json(ostream& output, uint32_t const index, int64_t const minimum_bytes, string& buffer) const
+{
+    auto const& current = m_nodes[index];
+    buffer += "{\"name\":";
+    append_json_string(buffer, index == 0U ? string_view("root") : get_name(current));
+    buffer += ",\"value\":";
+    // never less than the children written beneath it, d3-flame-graph won't draw a child wider than its parent
+    append_number(buffer, current.grown_bytes);
+    flush_if_full(output, buffer);
+
+    bool has_children{};
+    for (auto child = current.first_child; child != NONE; child = m_nodes[child].next_sibling) {
+        if (m_nodes[child].grown_bytes < minimum_bytes)
+            continue;
+        buffer += has_children ? "," : ",\"children\":[";
+        has_children = true;
+        write_json(output, child, minimum_bytes, buffer);
+    }
+    if (has_children)
+        buffer += ']';
+    buffer += '}';
+}
+
+}
@@ -0,0 +1,57 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/heap_snapshot.h>
+#include <algorithm>
+#include <iterator>
+#include <snapshot/umdh_parser.h>
+
+using std::string_view;
+using std::vector;
+
+namespace snapshot
+{
+
+heap_snapshot::heap_snapshot(vector<allocation_site> sites)
+    : m_sites{std::move(sites)}
+{
+    // umdh already lists sites in backtrace order, which is usually close to interning order
+    if (!std::is_sorted(m_sites.begin(), m_sites.end(), [](auto const& left, auto const& right) { return left.trace < right.trace; }))
+        std::sort(m_sites.begin(), m_sites.end(), [](auto const& left, auto const& right) { return left.trace < right.trace; });
+
+    auto merged = m_sites.begin();
+    for (auto current = m_sites.begin(); current != m_sites.end(); ++current) {
+        m_total_bytes += current->bytes;
+        m_total_count += current->count;
+        if (merged != m_sites.begin() && std::prev(merged)->trace == current->trace) {
+            std::prev(merged)->bytes += current->bytes;
+            std::prev(merged)->count += current->count;
+        } else {
+            *merged++ = *current;
+        }
+    }
+    m_sites.erase(merged, m_sites.end());
+}
+
+heap_snapshot read_heap_snapshot(string_view const& text, trace_table& traces)
+{
+    vector<allocation_site> sites{};
+    umdh_reader reader(text);
+    allocation_record record{};
+    while (reader.next(record))
+        sites.push_back(allocation_site{traces.intern(record), record.bytes, record.count});
+    return heap_snapshot(std::move(sites));
+}
+
+}
@@ -0,0 +1,147 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/mapped_file.h>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using std::filesystem::path;
+
+namespace snapshot
+{
+
+namespace
+{
+    /// <summary>the calling thread's last error, taken before closing a handle which may well overwrite it</summary>
+    [[nodiscard]] int get_last_error() noexcept
+    {
+#if defined(_WIN32)
+        return static_cast<int>(::GetLastError());
+#else
+        return errno;
+#endif
+    }
+
+    [[noreturn]] void throw_error(int const error, char const* what)
+    {
+        throw std::system_error(error, std::system_category(), what);
+    }
+
+    [[noreturn]] void throw_last_error(char const* what)
+    {
+        throw_error(get_last_error(), what);
+    }
+}
+
+mapped_file::mapped_file(path const& filename)
+{
+    // the mapping holds its own reference to the file, so neither handle outlives the constructor
+#if defined(_WIN32)
+    auto* const file = ::CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw_last_error("unable to open file");
+
+    LARGE_INTEGER size{};
+    if (!::GetFileSizeEx(file, &size)) {
+        auto const error = get_last_error();
+        ::CloseHandle(file);
+        throw_error(error, "unable to read file size");
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0U) {
+        ::CloseHandle(file);
+        return;
+    }
+
+    auto* const mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    auto error = get_last_error();
+    ::CloseHandle(file);
+    if (mapping == nullptr)
+        throw_error(error, "unable to map file");
+    m_data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    error = get_last_error();
+    ::CloseHandle(mapping);
+    if (m_data == nullptr)
+        throw_error(error, "unable to map file");
+#elif defined(__linux__)
+    auto const file = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        throw_last_error("unable to open file");
+
+    auto const size = ::lseek(file, 0, SEEK_END);
+    if (size < 0) {
+        auto const error = get_last_error();
+        ::close(file);
+        throw_error(error, "unable to read file size");
+    }
+    m_size = static_cast<std::size_t>(size);
+    if (m_size == 0U) {
+        ::close(file);
+        return;
+    }
+
+    auto* const data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    auto const error = get_last_error();
+    ::close(file);
+    if (data == MAP_FAILED)
+        throw_error(error, "unable to map file");
+    // snapshots are read front to back, let the kernel read ahead aggressively and drop pages behind
+    static_cast<void>(::madvise(data, m_size, MADV_SEQUENTIAL));
+    m_data = data;
+#endif
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}
+    , m_size{std::exchange(other.m_size, 0U)}
+{
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+    unmap();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0U);
+    return *this;
+}
+
+mapped_file::~mapped_file()
+{
+    unmap();
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (m_data == nullptr)
+        return;
+#if defined(_WIN32)
+    static_cast<void>(::UnmapViewOfFile(m_data));
+#elif defined(__linux__)
+    static_cast<void>(::munmap(const_cast<void*>(m_data), m_size));
+#endif
+    m_data = nullptr;
+}
+
+}
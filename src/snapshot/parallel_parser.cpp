@@ -0,0 +1,64 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/parallel_parser.h>
+#include <algorithm>
+
+using std::size_t;
+using std::string_view;
+using std::vector;
+
+namespace snapshot
+{
+
+namespace
+{
+    [[nodiscard]] constexpr bool is_frame_start(char const character) noexcept
+    {
+        return character == ' ' || character == '\t';
+    }
+
+    /// first offset at or after from which starts a line that isn't a frame, text.size() if there is none
+    [[nodiscard]] size_t find_record_start(string_view const& text, size_t const from) noexcept
+    {
+        for (auto newline = text.find('\n', from == 0U ? 0U : from - 1U); newline != string_view::npos; newline = text.find('\n', newline + 1U))
+            if (newline + 1U < text.size() && !is_frame_start(text[newline + 1U]))
+                return newline + 1U;
+        return text.size();
+    }
+}
+
+vector<string_view> split_records(string_view const& text, size_t const chunk_count, size_t const minimum_size)
+{
+    vector<string_view> chunks{};
+    if (text.empty())
+        return chunks;
+
+    auto const count = std::clamp(text.size() / std::max(minimum_size, size_t{1}), size_t{1}, std::max(chunk_count, size_t{1}));
+    auto const target_size = text.size() / count;
+    chunks.reserve(count);
+
+    size_t start{};
+    for (size_t chunk = 1U; chunk < count && start < text.size(); ++chunk) {
+        // a boundary may land inside the previous chunk's record, in which case it just gets longer
+        auto const end = find_record_start(text, std::max(start + 1U, chunk * target_size));
+        chunks.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    if (start < text.size())
+        chunks.push_back(text.substr(start));
+    return chunks;
+}
+
+}
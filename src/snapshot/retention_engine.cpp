@@ -0,0 +1,179 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/retention_engine.h>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <snapshot/snapshot_file.h>
+
+using std::size_t;
+using std::string_view;
+using std::vector;
+using std::chrono::system_clock;
+using std::filesystem::path;
+
+namespace snapshot
+{
+
+namespace
+{
+    constexpr auto UNMAPPED = std::numeric_limits<trace_id>::max();
+
+    [[nodiscard]] bool share_bucket(system_clock::time_point const left, system_clock::time_point const right, system_clock::duration const resolution) noexcept
+    {
+        auto const bucket = [resolution](system_clock::time_point const time) {
+            auto const ticks = time.time_since_epoch().count();
+            auto const quotient = ticks / resolution.count();
+            return ticks % resolution.count() < 0 ? quotient - 1 : quotient;
+        };
+        return bucket(left) == bucket(right);
+    }
+
+    /// <summary>copies the kept snapshots of a segment to filename with a dictionary of only the traces they reference</summary>
+    void write_segment(snapshot_file_reader const& reader, vector<size_t> const& kept, path const& filename)
+    {
+        trace_table traces{};
+        reader.read_traces(traces);
+
+        trace_table compacted{};
+        vector<trace_id> remap(traces.size(), UNMAPPED);
+        vector<string_view> frames{};
+        snapshot_file_writer writer(filename);
+        for (auto const index : kept) {
+            auto const read = reader.read_snapshot(index);
+            vector<allocation_site> sites(read.get_sites().begin(), read.get_sites().end());
+            for (auto& site : sites) {
+                if (site.trace >= remap.size())
+                    throw std::runtime_error("snapshot references a trace missing from its segment");
+                auto& mapped = remap[site.trace];
+                if (mapped == UNMAPPED) {
+                    frames.clear();
+                    for (auto const frame : traces.get_trace(site.trace))
+                        frames.push_back(traces.get_frame(frame));
+                    mapped = compacted.intern(frames);
+                }
+                site.trace = mapped;
+            }
+            writer.append(heap_snapshot(std::move(sites)), reader.get_info(index).taken_at, compacted);
+        }
+        writer.close();
+    }
+}
+
+retention_report retention_engine::tick(system_clock::time_point const now)
+{
+    if (m_pending.empty())
+        start_pass();
+
+    retention_report report{};
+    while (!m_pending.empty() && report.segments_checked < m_policy.segments_per_tick &&
+        (report.bytes_rewritten == 0U || report.bytes_rewritten < m_policy.bytes_per_tick)) {
+        auto const segment = std::move(m_pending.back());
+        m_pending.pop_back();
+        ++report.segments_checked;
+
+        // the segment still being written has no trailer yet, it's left alone without mapping or scanning it
+        if (!is_finished(segment, now))
+            continue;
+        if (segment.parent_path() != m_series) {
+            m_series = segment.parent_path();
+            m_last_kept.reset();
+        }
+
+        auto temporary = segment;
+        temporary += ".tmp";
+        vector<size_t> kept{};
+        {
+            snapshot_file_reader const reader(segment);
+
+            for (size_t index = 0; index < reader.size(); ++index) {
+                auto const taken_at = reader.get_info(index).taken_at;
+                auto const resolution = get_resolution(now - taken_at);
+                if (resolution == system_clock::duration::zero() || !m_last_kept.has_value() || !share_bucket(taken_at, m_last_kept.value(), resolution)) {
+                    kept.push_back(index);
+                    m_last_kept = taken_at;
+                }
+            }
+            // a recovered segment is rewritten whatever it keeps so it gains an index and isn't scanned again
+            if (kept.size() == reader.size() && !reader.was_recovered())
+                continue;
+
+            report.snapshots_removed += reader.size() - kept.size();
+            if (!kept.empty()) {
+                write_segment(reader, kept, temporary);
+                report.bytes_rewritten += std::filesystem::file_size(segment) + std::filesystem::file_size(temporary);
+            }
+        }
+
+        // the reader's mapping is gone by now, windows won't replace or delete a mapped file
+        if (kept.empty()) {
+            std::filesystem::remove(segment);
+            ++report.segments_removed;
+        } else {
+            std::filesystem::rename(temporary, segment);
+            ++report.segments_rewritten;
+        }
+    }
+
+    report.pass_complete = m_pending.empty();
+    return report;
+}
+
+retention_engine::retention_engine(path directory, retention_policy const& policy)
+    : m_directory{std::move(directory)}
+    , m_policy{policy}
+{
+    if (m_policy.full_window <= system_clock::duration::zero() || m_policy.hourly_window < m_policy.full_window)
+        throw std::invalid_argument("windows must be positive with hourly_window no shorter than full_window");
+    if (m_policy.segments_per_tick == 0U)
+        throw std::invalid_argument("segments_per_tick must be positive");
+}
+
+void retention_engine::start_pass()
+{
+    m_series.clear();
+    m_last_kept.reset();
+    auto const add_segments = [this](path const& series) {
+        for (auto const& entry : std::filesystem::directory_iterator(series))
+            if (entry.is_regular_file() && entry.path().extension() == ".snap")
+                m_pending.push_back(entry.path());
+    };
+    add_segments(m_directory);
+    for (auto const& entry : std::filesystem::directory_iterator(m_directory))
+        if (entry.is_directory())
+            add_segments(entry.path());
+    // paths compare by directory first, so each series is passed over whole and in the order of its segment names
+    std::sort(m_pending.begin(), m_pending.end(), std::greater<>());
+}
+
+bool retention_engine::is_finished(path const& segment, system_clock::time_point const now) const
+{
+    if (snapshot_file_reader::is_closed(segment))
+        return true;
+    auto const written = std::chrono::file_clock::to_sys(std::filesystem::last_write_time(segment));
+    return now - std::chrono::time_point_cast<system_clock::duration>(written) >= m_policy.full_window;
+}
+
+system_clock::duration retention_engine::get_resolution(system_clock::duration const age) const noexcept
+{
+    if (age < m_policy.full_window)
+        return system_clock::duration::zero();
+    if (age < m_policy.hourly_window)
+        return std::chrono::hours(1);
+    return std::chrono::hours(24);
+}
+
+}
@@ -0,0 +1,79 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/snapshot_diff.h>
+#include <algorithm>
+
+using std::int64_t;
+using std::optional;
+using std::size_t;
+
+namespace snapshot
+{
+
+namespace
+{
+    [[nodiscard]] bool grew_more(site_delta const& left, site_delta const& right) noexcept
+    {
+        return left.bytes_delta != right.bytes_delta
+            ? left.bytes_delta > right.bytes_delta
+            : left.trace < right.trace;
+    }
+
+    [[nodiscard]] int64_t subtract(std::uint64_t const after, std::uint64_t const before) noexcept
+    {
+        return static_cast<int64_t>(after - before);
+    }
+}
+
+snapshot_diff diff_snapshots(heap_snapshot const& before, heap_snapshot const& after, optional<size_t> const top)
+{
+    snapshot_diff result{};
+    result.bytes_delta = subtract(after.get_total_bytes(), before.get_total_bytes());
+    result.count_delta = subtract(after.get_total_count(), before.get_total_count());
+
+    auto const earlier = before.get_sites();
+    auto const later = after.get_sites();
+    auto& deltas = result.deltas;
+
+    auto left = earlier.begin();
+    auto right = later.begin();
+    while (left != earlier.end() || right != later.end()) {
+        if (right == later.end() || (left != earlier.end() && left->trace < right->trace)) {
+            deltas.push_back(site_delta{left->trace, site_change::VANISHED, -static_cast<int64_t>(left->bytes), -static_cast<int64_t>(left->count), 0U, 0U});
+            ++result.vanished_sites;
+            ++left;
+        } else if (left == earlier.end() || right->trace < left->trace) {
+            deltas.push_back(site_delta{right->trace, site_change::NEW, static_cast<int64_t>(right->bytes), static_cast<int64_t>(right->count), right->bytes, right->count});
+            ++result.new_sites;
+            ++right;
+        } else {
+            if (left->bytes != right->bytes || left->count != right->count)
+                deltas.push_back(site_delta{right->trace, site_change::CHANGED, subtract(right->bytes, left->bytes), subtract(right->count, left->count), right->bytes, right->count});
+            ++left;
+            ++right;
+        }
+    }
+    result.changed_sites = deltas.size();
+
+    // with a limit only the survivors are ordered, selecting them is linear in the number of changed sites
+    if (top.has_value() && top.value() < deltas.size()) {
+        std::nth_element(deltas.begin(), deltas.begin() + static_cast<std::ptrdiff_t>(top.value()), deltas.end(), grew_more);
+        deltas.resize(top.value());
+    }
+    std::sort(deltas.begin(), deltas.end(), grew_more);
+    return result;
+}
+
+}
@@ -0,0 +1,521 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/snapshot_file.h>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include "encoding.h"
+
+using std::int64_t;
+using std::size_t;
+using std::span;
+using std::string_view;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+using std::chrono::system_clock;
+using std::filesystem::path;
+
+using snapshot::encoding::byte_reader;
+using snapshot::encoding::crc32;
+using snapshot::encoding::put_fixed;
+using snapshot::encoding::put_varint;
+using snapshot::encoding::unzigzag;
+using snapshot::encoding::zigzag;
+
+namespace snapshot
+{
+
+namespace
+{
+    constexpr string_view FILE_MAGIC{"HEAPSNP\0", 8U};
+    constexpr string_view INDEX_MAGIC{"HEAPIDX\0", 8U};
+    constexpr uint32_t VERSION = 1U;
+    constexpr size_t FILE_HEADER_SIZE = 16U;
+    // type, payload length, crc32 of the payload, reserved
+    constexpr size_t BLOCK_HEADER_SIZE = 16U;
+    // type, length, offset, checksum, sites, timestamp, total bytes, total count
+    constexpr size_t INDEX_ENTRY_SIZE = 48U;
+    // index offset, entry count, crc32 of the entries, magic
+    constexpr size_t TRAILER_SIZE = 24U;
+
+    [[nodiscard]] int64_t to_nanoseconds(system_clock::time_point const& time) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+    [[nodiscard]] system_clock::time_point from_nanoseconds(int64_t const nanoseconds) noexcept
+    {
+        return system_clock::time_point(std::chrono::duration_cast<system_clock::duration>(std::chrono::nanoseconds(nanoseconds)));
+    }
+
+    [[nodiscard]] bool is_known(uint32_t const type) noexcept
+    {
+        return type >= static_cast<uint32_t>(block_type::DICTIONARY) && type <= static_cast<uint32_t>(block_type::DELTA);
+    }
+
+    /// <summary>difference in one trace between consecutive snapshots, from zero for a trace which is new</summary>
+    struct site_change_entry final
+    {
+        trace_id trace{};
+        int64_t bytes{};
+        int64_t count{};
+    };
+
+    [[nodiscard]] int64_t subtract(uint64_t const after, uint64_t const before) noexcept
+    {
+        return static_cast<int64_t>(after - before);
+    }
+
+    /// totals at the head of every snapshot block, so an index can be rebuilt from the blocks alone
+    [[nodiscard]] snapshot_info read_info(byte_reader& reader) noexcept
+    {
+        snapshot_info info{};
+        info.taken_at = from_nanoseconds(static_cast<int64_t>(reader.get_fixed(8U)));
+        info.total_bytes = reader.get_varint();
+        info.total_count = reader.get_varint();
+        info.sites = static_cast<size_t>(reader.get_varint());
+        return info;
+    }
+
+    [[noreturn]] void throw_damaged()
+    {
+        throw std::runtime_error("snapshot file block is damaged");
+    }
+
+    /// <summary>ids stored as the gap from the one before, usually a single byte as they ascend</summary>
+    template <typename VALUES, typename PROJECTION>
+    void put_trace_column(std::string& destination, VALUES const& values, PROJECTION projection)
+    {
+        trace_id previous{};
+        for (auto const& value : values) {
+            put_varint(destination, projection(value) - previous);
+            previous = projection(value);
+        }
+    }
+
+    template <typename VALUES, typename PROJECTION>
+    void get_trace_column(byte_reader& reader, VALUES& values, PROJECTION projection)
+    {
+        trace_id previous{};
+        for (auto& value : values) {
+            projection(value) = previous + static_cast<trace_id>(reader.get_varint());
+            previous = projection(value);
+        }
+    }
+
+    [[nodiscard]] vector<allocation_site> read_keyframe(string_view const& payload)
+    {
+        byte_reader reader(payload);
+        auto const info = read_info(reader);
+        // every site takes at least a byte of the payload, a larger count is damage which passed the crc
+        if (reader.has_failed() || info.sites > payload.size())
+            throw_damaged();
+
+        vector<allocation_site> sites(info.sites);
+        get_trace_column(reader, sites, [](auto& site) -> trace_id& { return site.trace; });
+        for (auto& site : sites)
+            site.bytes = reader.get_varint();
+        for (auto& site : sites)
+            site.count = reader.get_varint();
+        if (reader.has_failed() || !reader.at_end())
+            throw_damaged();
+        return sites;
+    }
+
+    /// <summary>merges the changes of a delta block into sites, merged is scratch space reused between deltas</summary>
+    void apply_delta(string_view const& payload, vector<allocation_site>& sites, vector<allocation_site>& merged)
+    {
+        byte_reader reader(payload);
+        auto const info = read_info(reader);
+        // counts are checked before anything is sized by them, damage which passed the crc is still runtime_error
+        auto const vanished_count = static_cast<size_t>(reader.get_varint());
+        if (reader.has_failed() || vanished_count > sites.size())
+            throw_damaged();
+        vector<trace_id> vanished(vanished_count);
+        get_trace_column(reader, vanished, [](auto& trace) -> trace_id& { return trace; });
+
+        auto const change_count = static_cast<size_t>(reader.get_varint());
+        if (reader.has_failed() || change_count > payload.size())
+            throw_damaged();
+        vector<site_change_entry> changes(change_count);
+        get_trace_column(reader, changes, [](auto& change) -> trace_id& { return change.trace; });
+        for (auto& change : changes)
+            change.bytes = unzigzag(reader.get_varint());
+        for (auto& change : changes)
+            change.count = unzigzag(reader.get_varint());
+        if (reader.has_failed() || !reader.at_end())
+            throw_damaged();
+
+        // a delta is far smaller than its snapshot, the merge can't outgrow the sites before it plus every change
+        if (info.sites > sites.size() + changes.size())
+            throw_damaged();
+        merged.clear();
+        merged.reserve(info.sites);
+        auto removed = vanished.begin();
+        auto change = changes.begin();
+        auto const add_new = [&merged](site_change_entry const& added) {
+            merged.push_back(allocation_site{added.trace, static_cast<uint64_t>(added.bytes), static_cast<uint64_t>(added.count)});
+        };
+        for (auto const& site : sites) {
+            for (; change != changes.end() && change->trace < site.trace; ++change)
+                add_new(*change);
+            if (removed != vanished.end() && *removed == site.trace) {
+                ++removed;
+            } else if (change != changes.end() && change->trace == site.trace) {
+                merged.push_back(allocation_site{site.trace, site.bytes + static_cast<uint64_t>(change->bytes), site.count + static_cast<uint64_t>(change->count)});
+                ++change;
+            } else {
+                merged.push_back(site);
+            }
+        }
+        for (; change != changes.end(); ++change)
+            add_new(*change);
+
+        if (removed != vanished.end() || merged.size() != info.sites)
+            throw_damaged();
+        std::swap(sites, merged);
+    }
+}
+
+void snapshot_file_writer::append(heap_snapshot const& snapshot, system_clock::time_point const taken_at, trace_table const& traces)
+{
+    if (m_closed)
+        throw std::invalid_argument("snapshot file has been closed");
+
+    if (traces.get_frame_count() > m_frames_written || traces.size() > m_traces_written)
+        write_dictionary(traces);
+
+    auto const sites = snapshot.get_sites();
+    snapshot_info const info{taken_at, snapshot.get_total_bytes(), snapshot.get_total_count(), sites.size()};
+
+    m_buffer.clear();
+    put_fixed(m_buffer, static_cast<uint64_t>(to_nanoseconds(taken_at)), 8U);
+    put_varint(m_buffer, info.total_bytes);
+    put_varint(m_buffer, info.total_count);
+    put_varint(m_buffer, info.sites);
+
+    auto const keyframe = m_since_keyframe == 0U;
+    if (keyframe) {
+        put_trace_column(m_buffer, sites, [](auto const& site) { return site.trace; });
+        for (auto const& site : sites)
+            put_varint(m_buffer, site.bytes);
+        for (auto const& site : sites)
+            put_varint(m_buffer, site.count);
+    } else {
+        write_delta(sites);
+    }
+
+    write_block(keyframe ? block_type::SNAPSHOT : block_type::DELTA, info);
+    m_previous.assign(sites.begin(), sites.end());
+    m_since_keyframe = (m_since_keyframe + 1U) % m_keyframe_interval;
+}
+
+void snapshot_file_writer::close()
+{
+    if (m_closed)
+        return;
+    m_closed = true;
+
+    m_buffer.clear();
+    for (auto const& entry : m_index) {
+        put_fixed(m_buffer, static_cast<uint32_t>(entry.type), 4U);
+        put_fixed(m_buffer, entry.length, 4U);
+        put_fixed(m_buffer, entry.offset, 8U);
+        put_fixed(m_buffer, entry.checksum, 4U);
+        put_fixed(m_buffer, entry.info.sites, 4U);
+        put_fixed(m_buffer, static_cast<uint64_t>(to_nanoseconds(entry.info.taken_at)), 8U);
+        put_fixed(m_buffer, entry.info.total_bytes, 8U);
+        put_fixed(m_buffer, entry.info.total_count, 8U);
+    }
+    auto const checksum = crc32(m_buffer);
+    put_fixed(m_buffer, m_offset, 8U);
+    put_fixed(m_buffer, m_index.size(), 4U);
+    put_fixed(m_buffer, checksum, 4U);
+    m_buffer.append(INDEX_MAGIC);
+
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_offset += m_buffer.size();
+    m_file.close();
+}
+
+snapshot_file_writer::snapshot_file_writer(path const& filename, size_t const keyframe_interval)
+    : m_keyframe_interval{keyframe_interval}
+{
+    if (m_keyframe_interval == 0U)
+        throw std::invalid_argument("keyframe_interval must be positive");
+
+    m_file.exceptions(std::ios::failbit | std::ios::badbit);
+    m_file.open(filename, std::ios::binary | std::ios::out | std::ios::trunc);
+
+    m_buffer.append(FILE_MAGIC);
+    put_fixed(m_buffer, VERSION, 4U);
+    put_fixed(m_buffer, 0U, 4U);
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_offset = m_buffer.size();
+}
+
+snapshot_file_writer::~snapshot_file_writer()
+{
+    try {
+        close();
+    } catch (std::exception const&) {
+        // the blocks already written remain readable without the index
+    }
+}
+
+void snapshot_file_writer::write_dictionary(trace_table const& traces)
+{
+    m_buffer.clear();
+    put_varint(m_buffer, m_frames_written);
+    put_varint(m_buffer, traces.get_frame_count() - m_frames_written);
+    for (auto frame = m_frames_written; frame < traces.get_frame_count(); ++frame) {
+        auto const text = traces.get_frame(static_cast<frame_id>(frame));
+        put_varint(m_buffer, text.size());
+        m_buffer.append(text);
+    }
+
+    put_varint(m_buffer, m_traces_written);
+    put_varint(m_buffer, traces.size() - m_traces_written);
+    for (auto trace = m_traces_written; trace < traces.size(); ++trace) {
+        auto const frames = traces.get_trace(static_cast<trace_id>(trace));
+        put_varint(m_buffer, frames.size());
+        for (auto const frame : frames)
+            put_varint(m_buffer, frame);
+    }
+
+    write_block(block_type::DICTIONARY, snapshot_info{});
+    m_frames_written = traces.get_frame_count();
+    m_traces_written = traces.size();
+}
+
+void snapshot_file_writer::write_delta(span<allocation_site const> const sites)
+{
+    vector<trace_id> vanished{};
+    vector<site_change_entry> changes{};
+
+    auto before = m_previous.cbegin();
+    auto after = sites.begin();
+    while (before != m_previous.cend() || after != sites.end()) {
+        if (after == sites.end() || (before != m_previous.cend() && before->trace < after->trace)) {
+            vanished.push_back(before->trace);
+            ++before;
+        } else if (before == m_previous.cend() || after->trace < before->trace) {
+            changes.push_back(site_change_entry{after->trace, static_cast<int64_t>(after->bytes), static_cast<int64_t>(after->count)});
+            ++after;
+        } else {
+            if (before->bytes != after->bytes || before->count != after->count)
+                changes.push_back(site_change_entry{after->trace, subtract(after->bytes, before->bytes), subtract(after->count, before->count)});
+            ++before;
+            ++after;
+        }
+    }
+
+    // vanished sites are listed apart from the changes so a site whose bytes fall to zero isn't mistaken for one which went
+    put_varint(m_buffer, vanished.size());
+    put_trace_column(m_buffer, vanished, [](auto const trace) { return trace; });
+    put_varint(m_buffer, changes.size());
+    put_trace_column(m_buffer, changes, [](auto const& change) { return change.trace; });
+    for (auto const& change : changes)
+        put_varint(m_buffer, zigzag(change.bytes));
+    for (auto const& change : changes)
+        put_varint(m_buffer, zigzag(change.count));
+}
+
+void snapshot_file_writer::write_block(block_type const type, snapshot_info const& info)
+{
+    if (m_buffer.size() > std::numeric_limits<uint32_t>::max())
+        throw std::invalid_argument("snapshot block exceeds 4GiB");
+
+    block_entry const entry{type, static_cast<uint32_t>(m_buffer.size()), m_offset, crc32(m_buffer), info};
+    std::string header{};
+    put_fixed(header, static_cast<uint32_t>(type), 4U);
+    put_fixed(header, entry.length, 4U);
+    put_fixed(header, entry.checksum, 4U);
+    put_fixed(header, 0U, 4U);
+
+    m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_index.push_back(entry);
+    m_offset += BLOCK_HEADER_SIZE + m_buffer.size();
+}
+
+snapshot_info const& snapshot_file_reader::get_info(size_t const index) const
+{
+    if (index >= m_snapshots.size())
+        throw std::invalid_argument("snapshot index out of range");
+    return m_snapshots[index].info;
+}
+
+heap_snapshot snapshot_file_reader::read_snapshot(size_t const index) const
+{
+    if (index >= m_snapshots.size())
+        throw std::invalid_argument("snapshot index out of range");
+
+    auto keyframe = index;
+    while (m_snapshots[keyframe].type != block_type::SNAPSHOT) {
+        if (keyframe == 0U)
+            throw_damaged();
+        --keyframe;
+    }
+
+    auto sites = read_keyframe(get_payload(m_snapshots[keyframe]));
+    vector<allocation_site> merged{};
+    for (auto delta = keyframe + 1U; delta <= index; ++delta)
+        apply_delta(get_payload(m_snapshots[delta]), sites, merged);
+    return heap_snapshot(std::move(sites));
+}
+
+void snapshot_file_reader::read_traces(trace_table& traces) const
+{
+    if (traces.size() != 0U || traces.get_frame_count() != 0U)
+        throw std::invalid_argument("traces must be empty");
+
+    vector<string_view> frames{};
+    vector<string_view> trace{};
+    for (auto const& dictionary : m_dictionaries) {
+        byte_reader reader(get_payload(dictionary));
+        if (reader.get_varint() != frames.size())
+            throw_damaged();
+        for (auto count = reader.get_varint(); count > 0U && !reader.has_failed(); --count)
+            frames.push_back(reader.get_bytes(static_cast<size_t>(reader.get_varint())));
+
+        if (reader.get_varint() != traces.size())
+            throw_damaged();
+        for (auto count = reader.get_varint(); count > 0U && !reader.has_failed(); --count) {
+            trace.clear();
+            for (auto length = reader.get_varint(); length > 0U && !reader.has_failed(); --length) {
+                auto const frame = reader.get_varint();
+                if (frame >= frames.size())
+                    throw_damaged();
+                trace.push_back(frames[static_cast<size_t>(frame)]);
+            }
+            // traces were written in id order and each is distinct, so interning them again reproduces the ids
+            auto const expected = traces.size();
+            if (traces.intern(trace) != expected)
+                throw_damaged();
+        }
+        if (reader.has_failed() || !reader.at_end())
+            throw_damaged();
+    }
+}
+
+bool snapshot_file_reader::is_closed(path const& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file || !file.seekg(-static_cast<std::streamoff>(TRAILER_SIZE), std::ios::end))
+        return false;
+
+    std::array<char, TRAILER_SIZE> trailer{};
+    if (!file.read(trailer.data(), static_cast<std::streamsize>(trailer.size())))
+        return false;
+    return string_view(trailer.data(), trailer.size()).substr(TRAILER_SIZE - INDEX_MAGIC.size()) == INDEX_MAGIC;
+}
+
+snapshot_file_reader::snapshot_file_reader(path const& filename)
+    : m_file{filename}
+{
+    auto const view = m_file.get_view();
+    // the magic and version fit in a shorter file, scan_blocks relies on the whole header being there
+    if (view.size() < FILE_HEADER_SIZE)
+        throw std::runtime_error("not a snapshot file");
+    byte_reader header(view.substr(0U, FILE_HEADER_SIZE));
+    if (header.get_bytes(FILE_MAGIC.size()) != FILE_MAGIC || header.get_fixed(4U) != VERSION)
+        throw std::runtime_error("not a snapshot file");
+
+    if (!read_index()) {
+        m_snapshots.clear();
+        m_dictionaries.clear();
+        scan_blocks();
+        m_recovered = true;
+    }
+}
+
+bool snapshot_file_reader::read_index()
+{
+    auto const view = m_file.get_view();
+    if (view.size() < FILE_HEADER_SIZE + TRAILER_SIZE)
+        return false;
+
+    byte_reader trailer(view.substr(view.size() - TRAILER_SIZE));
+    auto const index_offset = trailer.get_fixed(8U);
+    auto const entries = trailer.get_fixed(4U);
+    auto const checksum = static_cast<uint32_t>(trailer.get_fixed(4U));
+    if (trailer.get_bytes(INDEX_MAGIC.size()) != INDEX_MAGIC)
+        return false;
+    // bounded before the addition, a damaged offset could wrap it and pass
+    if (index_offset > view.size() - TRAILER_SIZE)
+        return false;
+    if (index_offset < FILE_HEADER_SIZE || index_offset + entries * INDEX_ENTRY_SIZE != view.size() - TRAILER_SIZE)
+        return false;
+
+    auto const index = view.substr(static_cast<size_t>(index_offset), static_cast<size_t>(entries * INDEX_ENTRY_SIZE));
+    if (crc32(index) != checksum)
+        return false;
+
+    byte_reader reader(index);
+    for (uint64_t count = 0; count < entries; ++count) {
+        auto const type = static_cast<uint32_t>(reader.get_fixed(4U));
+        block_entry entry{};
+        entry.type = static_cast<block_type>(type);
+        entry.length = static_cast<uint32_t>(reader.get_fixed(4U));
+        entry.offset = reader.get_fixed(8U);
+        entry.checksum = static_cast<uint32_t>(reader.get_fixed(4U));
+        entry.info.sites = static_cast<size_t>(reader.get_fixed(4U));
+        entry.info.taken_at = from_nanoseconds(static_cast<int64_t>(reader.get_fixed(8U)));
+        entry.info.total_bytes = reader.get_fixed(8U);
+        entry.info.total_count = reader.get_fixed(8U);
+        if (!is_known(type) || entry.offset + BLOCK_HEADER_SIZE + entry.length > index_offset)
+            return false;
+        (entry.type == block_type::DICTIONARY ? m_dictionaries : m_snapshots).push_back(entry);
+    }
+    return !reader.has_failed();
+}
+
+void snapshot_file_reader::scan_blocks()
+{
+    auto const view = m_file.get_view();
+    for (auto offset = FILE_HEADER_SIZE; view.size() - offset >= BLOCK_HEADER_SIZE;) {
+        byte_reader header(view.substr(offset, BLOCK_HEADER_SIZE));
+        auto const type = static_cast<uint32_t>(header.get_fixed(4U));
+        auto const length = static_cast<uint32_t>(header.get_fixed(4U));
+        auto const checksum = static_cast<uint32_t>(header.get_fixed(4U));
+        // the first block which is unknown, runs past the end or fails its checksum ends the readable part
+        if (!is_known(type) || view.size() - offset - BLOCK_HEADER_SIZE < length)
+            return;
+        auto const payload = view.substr(offset + BLOCK_HEADER_SIZE, length);
+        if (crc32(payload) != checksum)
+            return;
+
+        block_entry entry{static_cast<block_type>(type), length, offset, checksum, snapshot_info{}};
+        if (entry.type == block_type::DICTIONARY) {
+            m_dictionaries.push_back(entry);
+        } else {
+            byte_reader reader(payload);
+            entry.info = read_info(reader);
+            m_snapshots.push_back(entry);
+        }
+        offset += BLOCK_HEADER_SIZE + length;
+    }
+}
+
+string_view snapshot_file_reader::get_payload(block_entry const& entry) const
+{
+    auto const payload = m_file.get_view().substr(static_cast<size_t>(entry.offset + BLOCK_HEADER_SIZE), entry.length);
+    if (payload.size() != entry.length || crc32(payload) != entry.checksum)
+        throw_damaged();
+    return payload;
+}
+
+}
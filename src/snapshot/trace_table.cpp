@@ -0,0 +1,247 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/trace_table.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+using std::size_t;
+using std::span;
+using std::string_view;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace snapshot
+{
+
+namespace
+{
+    constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+    constexpr size_t INITIAL_SLOTS = 1024U;
+    constexpr uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+    [[nodiscard]] constexpr uint64_t mix(uint64_t value) noexcept
+    {
+        value ^= value >> 29U;
+        value *= 0xBF58476D1CE4E5B9ULL;
+        return value ^ value >> 32U;
+    }
+
+    [[nodiscard]] uint32_t hash_text(string_view const& text) noexcept
+    {
+        // eight bytes at a time, frames are long enough that a byte at a time hash dominates interning
+        auto hash = text.size() * MULTIPLIER;
+        auto const* next = text.data();
+        auto remaining = text.size();
+        for (; remaining >= sizeof(uint64_t); remaining -= sizeof(uint64_t), next += sizeof(uint64_t)) {
+            uint64_t word{};
+            std::memcpy(&word, next, sizeof(word));
+            hash = (hash ^ word) * MULTIPLIER;
+        }
+        uint64_t tail{};
+        if (remaining != 0U)
+            std::memcpy(&tail, next, remaining);
+        return static_cast<uint32_t>(mix(hash ^ tail));
+    }
+
+    [[nodiscard]] uint32_t hash_frames(span<frame_id const> const frames) noexcept
+    {
+        auto hash = frames.size() * MULTIPLIER;
+        for (auto const frame : frames)
+            hash = (hash ^ frame) * MULTIPLIER;
+        return static_cast<uint32_t>(mix(hash));
+    }
+
+    /// finds the slot holding a key equal by matches, or the empty slot where it belongs
+    template <typename SLOT, typename MATCHES>
+    [[nodiscard]] size_t probe(vector<SLOT> const& slots, uint32_t const hash, MATCHES matches) noexcept
+    {
+        auto const mask = slots.size() - 1U;
+        for (auto index = static_cast<size_t>(hash) & mask;; index = (index + 1U) & mask) {
+            auto const& candidate = slots[index];
+            if (candidate.id == EMPTY || (candidate.hash == hash && matches(candidate)))
+                return index;
+        }
+    }
+
+    /// doubles slots once they're half full, so probe sequences stay short
+    template <typename SLOT>
+    void grow_if_needed(vector<SLOT>& slots, size_t const count)
+    {
+        if ((count + 1U) * 2U <= slots.size())
+            return;
+
+        vector<SLOT> grown(slots.size() * 2U, SLOT{0U, EMPTY});
+        auto const mask = grown.size() - 1U;
+        for (auto const& existing : slots) {
+            if (existing.id == EMPTY)
+                continue;
+            auto index = static_cast<size_t>(existing.hash) & mask;
+            while (grown[index].id != EMPTY)
+                index = (index + 1U) & mask;
+            grown[index] = existing;
+        }
+        slots.swap(grown);
+    }
+}
+
+trace_id trace_table::intern(allocation_record const& record)
+{
+    auto const hash = static_cast<uint32_t>(mix(record.backtrace_id * MULTIPLIER));
+    auto const index = probe(m_backtrace_slots, hash, [&record](backtrace_slot const& candidate) {
+        return candidate.backtrace_id == record.backtrace_id;
+    });
+    if (m_backtrace_slots[index].id != EMPTY)
+        return m_backtrace_slots[index].id;
+
+    auto const id = intern(record.frames);
+    m_backtrace_slots[index] = backtrace_slot{hash, id, record.backtrace_id};
+    grow_if_needed(m_backtrace_slots, ++m_backtrace_count);
+    return id;
+}
+
+trace_id trace_table::intern(frame_list const& frames)
+{
+    m_scratch.clear();
+    for (auto const frame : frames)
+        m_scratch.push_back(intern_frame(frame));
+    return intern_trace();
+}
+
+trace_id trace_table::intern(span<string_view const> const frames)
+{
+    m_scratch.clear();
+    for (auto const& frame : frames)
+        m_scratch.push_back(intern_frame(frame));
+    return intern_trace();
+}
+
+span<frame_id const> trace_table::get_trace(trace_id const id) const
+{
+    if (id >= m_traces.size())
+        throw std::invalid_argument("unknown trace id");
+    return span<frame_id const>(m_traces[id].frames, m_traces[id].length);
+}
+
+string_view trace_table::get_frame(frame_id const id) const
+{
+    if (id >= m_frames.size())
+        throw std::invalid_argument("unknown frame id");
+    return m_frames[id];
+}
+
+size_t trace_table::get_memory_usage() const noexcept
+{
+    return m_arena.get_memory_usage() +
+        m_frames.capacity() * sizeof(string_view) +
+        m_frame_slots.capacity() * sizeof(frame_slot) +
+        m_traces.capacity() * sizeof(trace) +
+        m_trace_slots.capacity() * sizeof(slot) +
+        m_backtrace_slots.capacity() * sizeof(backtrace_slot) +
+        m_scratch.capacity() * sizeof(frame_id);
+}
+
+void trace_table::clear()
+{
+    // the empty tables are allocated before anything is released so a failure leaves the table as it was
+    vector<frame_slot> frame_slots(INITIAL_SLOTS, frame_slot{0U, EMPTY, {}});
+    vector<slot> trace_slots(INITIAL_SLOTS, slot{0U, EMPTY});
+    vector<backtrace_slot> backtrace_slots(INITIAL_SLOTS, backtrace_slot{0U, EMPTY, 0U});
+
+    m_arena.clear();
+    vector<string_view>().swap(m_frames);
+    vector<trace>().swap(m_traces);
+    vector<frame_id>().swap(m_scratch);
+    m_frame_slots.swap(frame_slots);
+    m_trace_slots.swap(trace_slots);
+    m_backtrace_slots.swap(backtrace_slots);
+    m_backtrace_count = 0U;
+}
+
+trace_table::trace_table()
+    : m_frame_slots(INITIAL_SLOTS, frame_slot{0U, EMPTY, {}})
+    , m_trace_slots(INITIAL_SLOTS, slot{0U, EMPTY})
+    , m_backtrace_slots(INITIAL_SLOTS, backtrace_slot{0U, EMPTY, 0U})
+{
+}
+
+trace_table::trace_table(trace_table&& other)
+    : trace_table()
+{
+    swap(other);
+}
+
+trace_table& trace_table::operator=(trace_table&& other)
+{
+    if (this == &other)
+        return *this;
+
+    // a moved from table must still be able to intern, it's given fresh tables rather than none at all
+    trace_table previous{};
+    swap(previous);
+    swap(other);
+    return *this;
+}
+
+void trace_table::swap(trace_table& other) noexcept
+{
+    std::swap(m_arena, other.m_arena);
+    m_frames.swap(other.m_frames);
+    m_frame_slots.swap(other.m_frame_slots);
+    m_traces.swap(other.m_traces);
+    m_trace_slots.swap(other.m_trace_slots);
+    m_backtrace_slots.swap(other.m_backtrace_slots);
+    std::swap(m_backtrace_count, other.m_backtrace_count);
+    m_scratch.swap(other.m_scratch);
+}
+
+frame_id trace_table::intern_frame(string_view const& frame)
+{
+    auto const hash = hash_text(frame);
+    auto const index = probe(m_frame_slots, hash, [&frame](frame_slot const& candidate) { return candidate.text == frame; });
+    if (m_frame_slots[index].id != EMPTY)
+        return m_frame_slots[index].id;
+
+    auto const id = static_cast<frame_id>(m_frames.size());
+    m_frames.push_back(m_arena.copy(frame));
+    m_frame_slots[index] = frame_slot{hash, id, m_frames.back()};
+    grow_if_needed(m_frame_slots, m_frames.size());
+    return id;
+}
+
+trace_id trace_table::intern_trace()
+{
+    span<frame_id const> const frames(m_scratch);
+    auto const hash = hash_frames(frames);
+    auto const index = probe(m_trace_slots, hash, [this, &frames](slot const& candidate) {
+        auto const& existing = m_traces[candidate.id];
+        return existing.length == frames.size() && std::equal(frames.begin(), frames.end(), existing.frames);
+    });
+    if (m_trace_slots[index].id != EMPTY)
+        return m_trace_slots[index].id;
+
+    auto* const stored = m_arena.allocate_array<frame_id>(frames.size());
+    std::copy(frames.begin(), frames.end(), stored);
+
+    auto const id = static_cast<trace_id>(m_traces.size());
+    m_traces.push_back(trace{stored, static_cast<uint32_t>(frames.size())});
+    m_trace_slots[index] = slot{hash, id};
+    grow_if_needed(m_trace_slots, m_traces.size());
+    return id;
+}
+
+}
@@ -0,0 +1,191 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/trend_engine.h>
+#include <algorithm>
+#include <stdexcept>
+
+using std::optional;
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+
+namespace snapshot
+{
+
+namespace
+{
+    /// running sums of a least squares fit
+    struct regression final
+    {
+        double n{};
+        double x{};
+        double xx{};
+        double y{};
+        double xy{};
+        double yy{};
+
+        /// adds the points first..last, all with the same y, using the closed forms for sums of integers and squares
+        void add_run(double const first, double const last, double const value) noexcept
+        {
+            auto const count = last - first + 1.0;
+            auto const sum_x = (first + last) * count / 2.0;
+            auto const sum_squares = [](double const upto) { return upto * (upto + 1.0) * (2.0 * upto + 1.0) / 6.0; };
+            n += count;
+            x += sum_x;
+            xx += sum_squares(last) - sum_squares(first - 1.0);
+            y += value * count;
+            xy += value * sum_x;
+            yy += value * value * count;
+        }
+
+        [[nodiscard]] double get_slope() const noexcept
+        {
+            auto const spread = n * xx - x * x;
+            return spread > 0.0 ? (n * xy - x * y) / spread : 0.0;
+        }
+
+        [[nodiscard]] double get_r_squared() const noexcept
+        {
+            auto const spread_x = n * xx - x * x;
+            auto const spread_y = n * yy - y * y;
+            if (spread_x <= 0.0 || spread_y <= 0.0)
+                return 0.0;
+            auto const covariance = n * xy - x * y;
+            return std::min(covariance * covariance / (spread_x * spread_y), 1.0);
+        }
+    };
+}
+
+void trend_engine::add(snapshot_diff const& diff)
+{
+    if (diff.deltas.size() != diff.changed_sites)
+        throw std::invalid_argument("diff must include every changed site");
+
+    ++m_current;
+    for (auto const& delta : diff.deltas) {
+        if (delta.trace >= m_traces.size())
+            m_traces.resize(static_cast<size_t>(delta.trace) + 1U);
+
+        auto& state = m_traces[delta.trace];
+        state.history.push_back(state.current);
+        state.current = run{m_current, delta.bytes};
+        if (delta.bytes_delta > 0) {
+            ++state.increases;
+            ++state.growth_streak;
+        } else if (delta.bytes_delta < 0) {
+            ++state.decreases;
+            state.growth_streak = 0U;
+        }
+        if (!state.active) {
+            state.active = true;
+            m_active.push_back(delta.trace);
+        }
+    }
+
+    auto const window_start = get_window_start();
+    m_flagged.clear();
+    auto still_active = m_active.begin();
+    for (auto const trace : m_active) {
+        auto& state = m_traces[trace];
+
+        // a run is only needed while the one after it starts inside the window, the first run kept then
+        // stands in for everything before the window so its start no longer matters
+        size_t expired{};
+        while (expired < state.history.size() &&
+            (expired + 1U < state.history.size() ? state.history[expired + 1U].start : state.current.start) <= window_start)
+            ++expired;
+        if (expired != 0U) {
+            state.history.erase(state.history.begin(), state.history.begin() + static_cast<std::ptrdiff_t>(expired));
+            if (!state.history.empty())
+                state.history.front().start = 0U;
+        }
+        if (state.history.empty() && state.current.start <= window_start) {
+            state.current.start = 0U;
+            state.history.shrink_to_fit();
+            state.active = false;
+            continue;
+        }
+
+        *still_active++ = trace;
+        if (auto const trend = evaluate(trace, state); is_flagged(trend))
+            m_flagged.push_back(trend);
+    }
+    m_active.erase(still_active, m_active.end());
+
+    std::sort(m_flagged.begin(), m_flagged.end(), [](site_trend const& left, site_trend const& right) {
+        return left.slope != right.slope ? left.slope > right.slope : left.trace < right.trace;
+    });
+}
+
+optional<site_trend> trend_engine::get_trend(trace_id const trace) const
+{
+    if (trace >= m_traces.size())
+        return std::nullopt;
+    return evaluate(trace, m_traces[trace]);
+}
+
+trend_engine::trend_engine(heap_snapshot const& baseline, trend_thresholds const& thresholds)
+    : m_thresholds{thresholds}
+{
+    if (m_thresholds.window < 2U)
+        throw std::invalid_argument("window must cover at least 2 snapshots");
+
+    auto const sites = baseline.get_sites();
+    if (!sites.empty())
+        m_traces.resize(static_cast<size_t>(sites.back().trace) + 1U);
+    for (auto const& site : sites)
+        m_traces[site.trace].current = run{0U, site.bytes};
+}
+
+uint32_t trend_engine::get_window_start() const noexcept
+{
+    return m_current + 1U > m_thresholds.window
+        ? m_current + 1U - static_cast<uint32_t>(m_thresholds.window)
+        : 0U;
+}
+
+site_trend trend_engine::evaluate(trace_id const trace, trace_state const& state) const noexcept
+{
+    auto const window_start = get_window_start();
+    // x is measured from the window start and y from the current value, slope and r squared are unchanged
+    // by either shift and both keep the sums small enough that doubles lose nothing
+    auto const reference = static_cast<double>(state.current.value);
+    regression fit{};
+
+    auto const add_run = [&fit, window_start, reference](uint32_t const start, uint32_t const end, uint64_t const value) {
+        auto const first = std::max(start, window_start);
+        if (first > end)
+            return;
+        fit.add_run(static_cast<double>(first - window_start), static_cast<double>(end - window_start), static_cast<double>(value) - reference);
+    };
+
+    for (size_t index = 0; index < state.history.size(); ++index) {
+        auto const next_start = index + 1U < state.history.size() ? state.history[index + 1U].start : state.current.start;
+        add_run(state.history[index].start, next_start - 1U, state.history[index].value);
+    }
+    add_run(state.current.start, m_current, state.current.value);
+
+    return site_trend{trace, fit.get_slope(), fit.get_r_squared(), state.current.value, state.growth_streak, state.increases, state.decreases};
+}
+
+bool trend_engine::is_flagged(site_trend const& trend) const noexcept
+{
+    return get_snapshot_count() >= m_thresholds.minimum_samples &&
+        trend.slope >= m_thresholds.minimum_slope &&
+        trend.r_squared >= m_thresholds.minimum_r_squared &&
+        trend.growth_streak >= m_thresholds.minimum_growth_streak;
+}
+
+}
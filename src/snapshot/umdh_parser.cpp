@@ -0,0 +1,174 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/umdh_parser.h>
+#include <array>
+
+using std::array;
+using std::size_t;
+using std::string_view;
+using std::uint64_t;
+
+namespace snapshot
+{
+
+namespace
+{
+    constexpr string_view BYTES_MARKER = " bytes ";
+    constexpr string_view SUMMARY_MARKER = "in 0x";
+    constexpr string_view ALLOCATION_MARKER = "+ ";
+    constexpr string_view BACKTRACE_MARKER = "BackTrace";
+    constexpr std::int8_t NOT_HEX = -1;
+
+    constexpr array<std::int8_t, 256> make_hex_digits() noexcept
+    {
+        array<std::int8_t, 256> digits{};
+        for (auto& digit : digits)
+            digit = NOT_HEX;
+        for (auto character = '0'; character <= '9'; ++character)
+            digits[static_cast<unsigned char>(character)] = static_cast<std::int8_t>(character - '0');
+        for (auto character = 'a'; character <= 'f'; ++character)
+            digits[static_cast<unsigned char>(character)] = static_cast<std::int8_t>(character - 'a' + 10);
+        for (auto character = 'A'; character <= 'F'; ++character)
+            digits[static_cast<unsigned char>(character)] = static_cast<std::int8_t>(character - 'A' + 10);
+        return digits;
+    }
+    constexpr auto HEX_DIGITS = make_hex_digits();
+
+    [[nodiscard]] constexpr std::int8_t hex_digit(char const character) noexcept
+    {
+        return HEX_DIGITS[static_cast<unsigned char>(character)];
+    }
+
+    [[nodiscard]] constexpr bool is_frame_start(char const character) noexcept
+    {
+        return character == ' ' || character == '\t';
+    }
+
+    /// reads hex digits from the front of text, removing them, false if there weren't any
+    [[nodiscard]] bool consume_hex(string_view& text, uint64_t& value) noexcept
+    {
+        size_t length{};
+        value = 0U;
+        for (; length < text.size() && hex_digit(text[length]) != NOT_HEX; ++length)
+            value = value << 4U | static_cast<uint64_t>(hex_digit(text[length]));
+        text.remove_prefix(length);
+        return length != 0U;
+    }
+
+    [[nodiscard]] bool consume(string_view& text, string_view const& expected) noexcept
+    {
+        if (text.substr(0U, expected.size()) != expected)
+            return false;
+        text.remove_prefix(expected.size());
+        return true;
+    }
+
+    [[nodiscard]] bool parse_header(string_view line, allocation_record& record) noexcept
+    {
+        // frame lines are indented and most noise starts with something other than a hex digit, so the
+        // majority of lines are turned away by their first character
+        if (line.empty() || hex_digit(line.front()) == NOT_HEX)
+            return false;
+        if (!consume_hex(line, record.bytes) || !consume(line, BYTES_MARKER))
+            return false;
+
+        if (consume(line, SUMMARY_MARKER)) {
+            if (!consume_hex(line, record.count))
+                return false;
+        } else if (consume(line, ALLOCATION_MARKER)) {
+            record.count = 1U;
+        } else {
+            return false;
+        }
+
+        auto const backtrace = line.find(BACKTRACE_MARKER);
+        if (backtrace == string_view::npos)
+            return false;
+        line.remove_prefix(backtrace + BACKTRACE_MARKER.size());
+        return consume_hex(line, record.backtrace_id);
+    }
+
+    [[nodiscard]] string_view trim(string_view text) noexcept
+    {
+        while (!text.empty() && (is_frame_start(text.front()) || text.front() == '\r'))
+            text.remove_prefix(1U);
+        while (!text.empty() && (is_frame_start(text.back()) || text.back() == '\r'))
+            text.remove_suffix(1U);
+        return text;
+    }
+}
+
+frame_iterator& frame_iterator::operator++() noexcept
+{
+    while (!m_remaining.empty()) {
+        auto const newline = m_remaining.find('\n');
+        auto const frame = trim(m_remaining.substr(0U, newline));
+        m_remaining = newline == string_view::npos
+            ? m_remaining.substr(m_remaining.size())
+            : m_remaining.substr(newline + 1U);
+        if (!frame.empty()) {
+            m_frame = frame;
+            return *this;
+        }
+    }
+
+    // indistinguishable from a default constructed iterator, which is what end() returns
+    m_remaining = string_view();
+    m_frame = string_view();
+    return *this;
+}
+
+bool umdh_reader::next(allocation_record& record) noexcept
+{
+    while (m_position < m_text.size()) {
+        auto const newline = m_text.find('\n', m_position);
+        if (newline == string_view::npos && !m_final)
+            return false;
+
+        auto const line_end = newline == string_view::npos ? m_text.size() : newline;
+        auto const frames_start = newline == string_view::npos ? m_text.size() : newline + 1U;
+        if (!parse_header(m_text.substr(m_position, line_end - m_position), record)) {
+            m_position = frames_start;
+            continue;
+        }
+
+        auto frames_end = frames_start;
+        while (frames_end < m_text.size() && is_frame_start(m_text[frames_end])) {
+            auto const frame_end = m_text.find('\n', frames_end);
+            frames_end = frame_end == string_view::npos ? m_text.size() : frame_end + 1U;
+        }
+        // without the line which follows there's no telling whether the frames continue in the next chunk
+        if (frames_end == m_text.size() && !m_final)
+            return false;
+
+        record.frames = frame_list{m_text.substr(frames_start, frames_end - frames_start)};
+        m_position = frames_end;
+        return true;
+    }
+    return false;
+}
+
+size_t umdh_stream_parser::find_record_boundary(string_view const& chunk) const noexcept
+{
+    if (!chunk.empty() && m_pending.back() == '\n' && !is_frame_start(chunk.front()))
+        return 0U;
+
+    for (auto newline = chunk.find('\n'); newline != string_view::npos; newline = chunk.find('\n', newline + 1U))
+        if (newline + 1U < chunk.size() && !is_frame_start(chunk[newline + 1U]))
+            return newline + 1U;
+    return string_view::npos;
+}
+
+}
@@ -0,0 +1,58 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/coroutine_task_action.h>
+#include <stdexcept>
+
+using std::future;
+using std::promise;
+using std::shared_ptr;
+
+namespace tasks
+{
+
+namespace
+{
+    lazy<action_result> keep_alive(shared_ptr<coroutine_task_action> action, std::stop_token stop_token)
+    {
+        // parameters are copied into the coroutine frame, so the action lives until its coroutine completes
+        co_return co_await action->process(std::move(stop_token));
+    }
+}
+
+future<action_result> coroutine_action_adapter::process_async()
+{
+    return process_async(std::stop_token());
+}
+
+future<action_result> coroutine_action_adapter::process_async(std::stop_token stop_token)
+{
+    promise<action_result> completion;
+    auto result = completion.get_future();
+
+    m_executor.post([action = m_action, stop_token = std::move(stop_token), completion = std::move(completion)]() mutable {
+        start_detached(keep_alive(std::move(action), std::move(stop_token)), std::move(completion));
+    });
+    return result;
+}
+
+coroutine_action_adapter::coroutine_action_adapter(shared_ptr<coroutine_task_action> action, executor& executor)
+    : m_action{std::move(action)}
+    , m_executor{executor}
+{
+    if (!m_action)
+        throw std::invalid_argument("action is null");
+}
+
+}
@@ -0,0 +1,189 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/executor.h>
+#include <deque>
+
+using std::size_t;
+using std::uint64_t;
+
+namespace tasks
+{
+
+namespace
+{
+    struct current_worker final
+    {
+        executor const* owner{};
+        size_t index{};
+    };
+    thread_local current_worker t_current_worker{};
+}
+
+struct executor::worker final
+{
+    std::mutex mutex{};
+    std::deque<work_item> queue{};
+    std::thread thread{};
+};
+
+void executor::post(work_item item)
+{
+    if (!item)
+        return;
+
+    auto const index = t_current_worker.owner == this
+        ? t_current_worker.index
+        : m_next_worker.fetch_add(1U, std::memory_order_relaxed) % m_workers.size();
+
+    {
+        auto& target = *m_workers[index];
+        std::lock_guard lock(target.mutex);
+        target.queue.push_back(std::move(item));
+    }
+    m_submitted.fetch_add(1U, std::memory_order_relaxed);
+    m_pending.fetch_add(1U, std::memory_order_release);
+    wake_one();
+}
+
+size_t executor::get_worker_count() const noexcept
+{
+    return m_workers.size();
+}
+
+size_t executor::get_queue_depth() const noexcept
+{
+    return m_pending.load(std::memory_order_acquire);
+}
+
+uint64_t executor::get_steal_count() const noexcept
+{
+    return m_stolen.load(std::memory_order_relaxed);
+}
+
+executor_statistics executor::get_statistics() const
+{
+    executor_statistics statistics{};
+    statistics.submitted = m_submitted.load(std::memory_order_relaxed);
+    statistics.executed = m_executed.load(std::memory_order_relaxed);
+    statistics.stolen = m_stolen.load(std::memory_order_relaxed);
+    statistics.queue_depths.reserve(m_workers.size());
+    for (auto const& current : m_workers) {
+        std::lock_guard lock(current->mutex);
+        statistics.queue_depths.push_back(current->queue.size());
+    }
+    return statistics;
+}
+
+bool executor::is_worker_thread() const noexcept
+{
+    return t_current_worker.owner == this;
+}
+
+executor::executor(size_t const worker_count)
+{
+    auto const count = std::max<size_t>(worker_count, 1U);
+    m_workers.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        m_workers.push_back(std::make_unique<worker>());
+
+    // workers are only started once every deque exists as any of them may be stolen from
+    for (size_t i = 0; i < count; ++i)
+        m_workers[i]->thread = std::thread([this, i]() { run_worker(i); });
+}
+
+executor::~executor()
+{
+    {
+        std::lock_guard lock(m_idle_mutex);
+        m_stopping.store(true, std::memory_order_release);
+    }
+    m_idle.notify_all();
+
+    for (auto& current : m_workers) {
+        if (current->thread.joinable())
+            current->thread.join();
+    }
+}
+
+void executor::run_worker(size_t const index)
+{
+    t_current_worker = current_worker{this, index};
+
+    work_item item{};
+    while (true) {
+        if (try_pop(index, item) || try_steal(index, item)) {
+            m_pending.fetch_sub(1U, std::memory_order_acq_rel);
+            // counted before it runs, submit() completes its future from within item so counting after could lag it
+            m_executed.fetch_add(1U, std::memory_order_relaxed);
+            try {
+                item();
+            } catch (...) {
+                // post() is fire and forget, submit() captures exceptions in the promise
+            }
+            item = work_item();
+            continue;
+        }
+
+        std::unique_lock lock(m_idle_mutex);
+        m_idle.wait(lock, [this]() {
+            return m_pending.load(std::memory_order_acquire) > 0U || m_stopping.load(std::memory_order_acquire);
+        });
+        if (m_stopping.load(std::memory_order_acquire) && m_pending.load(std::memory_order_acquire) == 0U)
+            break;
+    }
+
+    t_current_worker = current_worker{};
+}
+
+bool executor::try_pop(size_t const index, work_item& item)
+{
+    auto& owner = *m_workers[index];
+    std::lock_guard lock(owner.mutex);
+    if (owner.queue.empty())
+        return false;
+
+    // oldest first so a steady stream of new work can't starve what was queued earlier
+    item = std::move(owner.queue.front());
+    owner.queue.pop_front();
+    return true;
+}
+
+bool executor::try_steal(size_t const thief, work_item& item)
+{
+    auto const count = m_workers.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        auto& victim = *m_workers[(thief + offset) % count];
+        std::unique_lock lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.queue.empty())
+            continue;
+
+        item = std::move(victim.queue.back());
+        victim.queue.pop_back();
+        m_stolen.fetch_add(1U, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void executor::wake_one()
+{
+    // taking the lock orders this notify after any worker which has checked m_pending but not yet started waiting
+    {
+        std::lock_guard lock(m_idle_mutex);
+    }
+    m_idle.notify_one();
+}
+
+}
@@ -0,0 +1,121 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/latency_histogram.h>
+#include <algorithm>
+#include <cmath>
+
+using std::chrono::nanoseconds;
+using std::uint32_t;
+using std::uint64_t;
+
+namespace tasks
+{
+
+namespace
+{
+    nanoseconds to_nanoseconds(uint64_t const value) noexcept
+    {
+        return nanoseconds(static_cast<nanoseconds::rep>(value));
+    }
+
+    uint64_t lowest_in_bucket(uint32_t const bucket) noexcept
+    {
+        return bucket == 0U
+            ? 0U
+            : latency_histogram::highest_in_bucket(bucket - 1U) + 1U;
+    }
+}
+
+void latency_histogram::record(nanoseconds const value) noexcept
+{
+    auto const clamped = std::min(static_cast<uint64_t>(std::max(value.count(), nanoseconds::rep{0})), MAXIMUM_VALUE);
+    ++m_counts[bucket_of(clamped)];
+    ++m_count;
+    m_total += clamped;
+    m_minimum = std::min(m_minimum, clamped);
+    m_maximum = std::max(m_maximum, clamped);
+}
+
+void latency_histogram::add_to_bucket(uint32_t const bucket, uint64_t const count) noexcept
+{
+    if (bucket >= BUCKETS || count == 0U)
+        return;
+
+    auto const lowest = lowest_in_bucket(bucket);
+    auto const highest = highest_in_bucket(bucket);
+    m_counts[bucket] += count;
+    m_count += count;
+    m_total += count * (lowest + (highest - lowest) / 2U);
+    m_minimum = std::min(m_minimum, lowest);
+    m_maximum = std::max(m_maximum, highest);
+}
+
+void latency_histogram::merge(latency_histogram const& other) noexcept
+{
+    for (uint32_t bucket = 0; bucket < BUCKETS; ++bucket)
+        m_counts[bucket] += other.m_counts[bucket];
+    m_count += other.m_count;
+    m_total += other.m_total;
+    m_minimum = std::min(m_minimum, other.m_minimum);
+    m_maximum = std::max(m_maximum, other.m_maximum);
+}
+
+void latency_histogram::reset() noexcept
+{
+    *this = latency_histogram();
+}
+
+nanoseconds latency_histogram::get_percentile(double const percentile) const noexcept
+{
+    if (m_count == 0U)
+        return nanoseconds::zero();
+
+    auto const clamped = std::clamp(percentile, 0.0, 100.0);
+    auto const rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(m_count))), 1U);
+    uint64_t seen{};
+    for (uint32_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        seen += m_counts[bucket];
+        if (seen >= rank)
+            // the bucket's upper bound may overshoot what was actually recorded, never report more than the maximum
+            return to_nanoseconds(std::min(highest_in_bucket(bucket), m_maximum));
+    }
+    return to_nanoseconds(m_maximum);
+}
+
+nanoseconds latency_histogram::get_minimum() const noexcept
+{
+    return m_count == 0U
+        ? nanoseconds::zero()
+        : to_nanoseconds(m_minimum);
+}
+
+nanoseconds latency_histogram::get_maximum() const noexcept
+{
+    return to_nanoseconds(m_maximum);
+}
+
+nanoseconds latency_histogram::get_mean() const noexcept
+{
+    return m_count == 0U
+        ? nanoseconds::zero()
+        : to_nanoseconds(m_total / m_count);
+}
+
+uint64_t latency_histogram::get_count() const noexcept
+{
+    return m_count;
+}
+
+}
@@ -0,0 +1,221 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/latency_recorder.h>
+#include <iomanip>
+#include <map>
+
+using std::chrono::nanoseconds;
+using std::make_unique;
+using std::size_t;
+using std::type_index;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace tasks
+{
+
+namespace
+{
+    std::atomic<uint64_t> next_recorder_id{};
+
+    /// <summary>reuses the slots of destroyed recorders so each thread's shard cache is bounded by the recorders alive at once</summary>
+    class recorder_slots final
+    {
+    public:
+        [[nodiscard]] size_t acquire()
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_free.empty())
+                return m_next++;
+            auto const slot = m_free.back();
+            m_free.pop_back();
+            return slot;
+        }
+
+        void release(size_t const slot) noexcept
+        {
+            try {
+                std::lock_guard lock(m_mutex);
+                m_free.push_back(slot);
+            } catch (std::bad_alloc const&) {
+                // the slot is never reused, which costs each thread one cache entry
+            }
+        }
+
+    private:
+        std::mutex m_mutex{};
+        vector<size_t> m_free{};
+        size_t m_next{};
+    };
+
+    /// <summary>constructed by the first recorder so it outlives every recorder, even static ones</summary>
+    recorder_slots& get_recorder_slots()
+    {
+        static recorder_slots slots;
+        return slots;
+    }
+
+    void add_to(latency_histogram& merged, std::array<std::atomic<uint64_t>, latency_histogram::BUCKETS> const& counts) noexcept
+    {
+        for (uint32_t bucket = 0; bucket < latency_histogram::BUCKETS; ++bucket)
+            merged.add_to_bucket(bucket, counts[bucket].load(std::memory_order_relaxed));
+    }
+
+    double to_microseconds(nanoseconds const value) noexcept
+    {
+        return static_cast<double>(value.count()) / 1000.0;
+    }
+}
+
+char const* to_string(latency_metric const metric) noexcept
+{
+    switch (metric) {
+    case latency_metric::QUEUE:
+        return "queue";
+    case latency_metric::RUN:
+        return "run";
+    case latency_metric::END_TO_END:
+        return "end_to_end";
+    }
+    return "unknown";
+}
+
+void latency_recorder::on_transition(task& source, task_state const previous, task_state const current) noexcept
+{
+    auto const type = type_index(typeid(source));
+    auto const ready_at = source.get_ready_at();
+    auto const started_at = source.get_started_at();
+
+    if (current == task_state::RUNNING) {
+        if (ready_at.has_value() && started_at.has_value())
+            record(type, latency_metric::QUEUE, started_at.value() - ready_at.value());
+        return;
+    }
+    if (previous != task_state::RUNNING || (current != task_state::COMPLETE && current != task_state::FAILED))
+        return;
+
+    auto const now = task::clock::now();
+    if (started_at.has_value())
+        record(type, latency_metric::RUN, now - started_at.value());
+    if (ready_at.has_value())
+        record(type, latency_metric::END_TO_END, now - ready_at.value());
+}
+
+void latency_recorder::record(type_index const& task_type, latency_metric const metric, nanoseconds const value) noexcept
+{
+    try {
+        auto& shard = get_thread_shard();
+        auto match = shard.types.find(task_type);
+        if (match == shard.types.end()) {
+            std::lock_guard lock(shard.mutex);
+            match = shard.types.emplace(task_type, make_unique<shard_histograms>()).first;
+        }
+
+        // this thread is the only writer so a load and store is enough, the atomics are for the readers' sake
+        auto& count = (*match->second)[static_cast<size_t>(metric)].counts[latency_histogram::bucket_of(static_cast<uint64_t>(std::max(value.count(), nanoseconds::rep{0})))];
+        count.store(count.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+    } catch (std::bad_alloc const&) {
+        // the first sample of a type on a thread is lost, recording must never fail the caller
+    }
+}
+
+latency_histogram latency_recorder::get_histogram(type_index const& task_type, latency_metric const metric) const
+{
+    latency_histogram merged;
+    std::lock_guard lock(m_mutex);
+    for (auto const& shard : m_shards) {
+        std::lock_guard shard_lock(shard->mutex);
+        auto const match = shard->types.find(task_type);
+        if (match != shard->types.end())
+            add_to(merged, (*match->second)[static_cast<size_t>(metric)].counts);
+    }
+    return merged;
+}
+
+vector<latency_summary> latency_recorder::get_summaries() const
+{
+    std::map<type_index, std::unique_ptr<std::array<latency_histogram, METRICS>>> merged;
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto const& shard : m_shards) {
+            std::lock_guard shard_lock(shard->mutex);
+            for (auto const& [type, histograms] : shard->types) {
+                auto& destination = merged[type];
+                if (!destination)
+                    destination = make_unique<std::array<latency_histogram, METRICS>>();
+                for (size_t metric = 0; metric < METRICS; ++metric)
+                    add_to((*destination)[metric], (*histograms)[metric].counts);
+            }
+        }
+    }
+
+    vector<latency_summary> summaries;
+    for (auto const& [type, histograms] : merged)
+        for (size_t metric = 0; metric < METRICS; ++metric) {
+            auto const& histogram = (*histograms)[metric];
+            if (histogram.get_count() == 0U)
+                continue;
+            summaries.push_back(latency_summary{type, static_cast<latency_metric>(metric), histogram.get_count(),
+                histogram.get_percentile(50.0), histogram.get_percentile(90.0), histogram.get_percentile(99.0), histogram.get_maximum()});
+        }
+    return summaries;
+}
+
+void latency_recorder::dump(std::ostream& output) const
+{
+    auto const flags = output.flags();
+    output << std::fixed << std::setprecision(1);
+    for (auto const& summary : get_summaries())
+        output << summary.task_type.name() << ' ' << to_string(summary.metric)
+            << " count=" << summary.count
+            << " p50=" << to_microseconds(summary.p50) << "us"
+            << " p90=" << to_microseconds(summary.p90) << "us"
+            << " p99=" << to_microseconds(summary.p99) << "us"
+            << " max=" << to_microseconds(summary.maximum) << "us\n";
+    output.flags(flags);
+}
+
+latency_recorder::latency_recorder()
+    : m_id{next_recorder_id.fetch_add(1U, std::memory_order_relaxed) + 1U}
+    , m_slot{get_recorder_slots().acquire()}
+{
+}
+
+latency_recorder::~latency_recorder()
+{
+    get_recorder_slots().release(m_slot);
+}
+
+latency_recorder::thread_shard& latency_recorder::get_thread_shard()
+{
+    // a slot is reused once its recorder is destroyed, the id check stops a later recorder picking up the stale shard
+    thread_local vector<cached_shard> shards_by_slot;
+    if (m_slot < shards_by_slot.size() && shards_by_slot[m_slot].recorder_id == m_id)
+        return *shards_by_slot[m_slot].shard;
+
+    auto shard = make_unique<thread_shard>();
+    auto* const created = shard.get();
+    {
+        std::lock_guard lock(m_mutex);
+        m_shards.push_back(std::move(shard));
+    }
+    if (shards_by_slot.size() <= m_slot)
+        shards_by_slot.resize(m_slot + 1U);
+    shards_by_slot[m_slot] = cached_shard{m_id, created};
+    return *created;
+}
+
+}
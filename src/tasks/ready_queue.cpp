@@ -0,0 +1,82 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/ready_queue.h>
+#include <algorithm>
+#include <stdexcept>
+
+using std::size_t;
+
+namespace tasks
+{
+
+void fifo_ready_queue::push(task& ready, clock::time_point const)
+{
+    m_tasks.push_back(&ready);
+}
+
+task* fifo_ready_queue::pop()
+{
+    if (m_tasks.empty())
+        return nullptr;
+    auto* const next = m_tasks.front();
+    m_tasks.pop_front();
+    return next;
+}
+
+size_t fifo_ready_queue::size() const noexcept
+{
+    return m_tasks.size();
+}
+
+void slack_ready_queue::push(task& ready, clock::time_point const now)
+{
+    auto const deadline = ready.get_deadline().value_or(now + m_default_deadline);
+    auto const latest_start = deadline - std::chrono::duration_cast<clock::duration>(ready.get_estimated_time_remaining());
+
+    m_heap.push_back(entry{latest_start, m_sequence++, &ready});
+    std::push_heap(m_heap.begin(), m_heap.end(), runs_after);
+}
+
+task* slack_ready_queue::pop()
+{
+    if (m_heap.empty())
+        return nullptr;
+    std::pop_heap(m_heap.begin(), m_heap.end(), runs_after);
+    auto* const next = m_heap.back().target;
+    m_heap.pop_back();
+    return next;
+}
+
+size_t slack_ready_queue::size() const noexcept
+{
+    return m_heap.size();
+}
+
+slack_ready_queue::slack_ready_queue(clock::duration const default_deadline)
+    : m_default_deadline{default_deadline}
+{
+    if (default_deadline <= clock::duration::zero())
+        throw std::invalid_argument("default_deadline must be positive");
+}
+
+bool slack_ready_queue::runs_after(entry const& first, entry const& second) noexcept
+{
+    // equal slack falls back to arrival order so the policy degrades to fifo rather than something arbitrary
+    return first.latest_start != second.latest_start
+        ? first.latest_start > second.latest_start
+        : first.sequence > second.sequence;
+}
+
+}
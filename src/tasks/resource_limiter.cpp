@@ -0,0 +1,199 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/resource_limiter.h>
+#include <algorithm>
+#include <stdexcept>
+
+using std::future;
+using std::make_unique;
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::unique_ptr;
+using std::vector;
+
+namespace tasks
+{
+
+void resource_limiter::add_class(string_view const name, size_t const limit, size_t const max_queued)
+{
+    if (limit == 0U)
+        throw std::invalid_argument("limit must be greater than zero");
+
+    std::lock_guard lock(m_mutex);
+    if (m_classes.find(name) != m_classes.end())
+        throw std::invalid_argument("resource class already exists");
+    m_classes.emplace(string(name), make_unique<resource_class>(resource_class{string(name), limit, max_queued}));
+}
+
+future<void> resource_limiter::submit(task& target)
+{
+    return submit(target.get_resource_classes(), [&target]() { target.process(); });
+}
+
+void resource_limiter::post(vector<string> const& classes, work_item item)
+{
+    auto pending = make_request(classes);
+    pending->work = wrap(pending->classes, std::move(item));
+    enqueue(std::move(pending));
+}
+
+bool resource_limiter::try_post(vector<string> const& classes, work_item item)
+{
+    auto pending = make_request(classes);
+    pending->work = wrap(pending->classes, std::move(item));
+    return try_enqueue(std::move(pending));
+}
+
+size_t resource_limiter::get_queue_length(string_view const name) const
+{
+    std::lock_guard lock(m_mutex);
+    return find_class(name).waiting.size();
+}
+
+size_t resource_limiter::get_in_use(string_view const name) const
+{
+    std::lock_guard lock(m_mutex);
+    return find_class(name).in_use;
+}
+
+vector<resource_class_statistics> resource_limiter::get_statistics() const
+{
+    std::lock_guard lock(m_mutex);
+    vector<resource_class_statistics> statistics;
+    statistics.reserve(m_classes.size());
+    for (auto const& [name, current] : m_classes)
+        statistics.push_back(resource_class_statistics{name, current->limit, current->in_use, current->waiting.size(), current->rejected});
+    return statistics;
+}
+
+resource_limiter::resource_limiter(executor& executor)
+    : m_executor{executor}
+{
+}
+
+unique_ptr<resource_limiter::request> resource_limiter::make_request(vector<string> const& classes) const
+{
+    auto pending = make_unique<request>();
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto const& name : classes)
+            pending->classes.push_back(&find_class(name));
+    }
+
+    // a single global order, here by name, is what keeps multi class requests from deadlocking
+    std::sort(pending->classes.begin(), pending->classes.end(), [](auto const* left, auto const* right) { return left->name < right->name; });
+    pending->classes.erase(std::unique(pending->classes.begin(), pending->classes.end()), pending->classes.end());
+    return pending;
+}
+
+resource_limiter::resource_class& resource_limiter::find_class(string_view const name) const
+{
+    auto const match = m_classes.find(name);
+    if (match == m_classes.end())
+        throw std::invalid_argument("unknown resource class");
+    return *match->second;
+}
+
+unique_ptr<resource_limiter::request> resource_limiter::acquire(unique_ptr<request> pending)
+{
+    while (pending->acquired < pending->classes.size()) {
+        auto* const next = pending->classes[pending->acquired];
+        if (next->in_use >= next->limit) {
+            next->waiting.push_back(std::move(pending));
+            return nullptr;
+        }
+        ++next->in_use;
+        ++pending->acquired;
+    }
+    return pending;
+}
+
+void resource_limiter::enqueue(unique_ptr<request> pending)
+{
+    unique_ptr<request> ready;
+    {
+        std::lock_guard lock(m_mutex);
+        ready = acquire(std::move(pending));
+    }
+    if (ready)
+        dispatch(std::move(ready));
+}
+
+bool resource_limiter::try_enqueue(unique_ptr<request> pending)
+{
+    unique_ptr<request> ready;
+    {
+        std::lock_guard lock(m_mutex);
+        auto const saturated = std::find_if(pending->classes.begin(), pending->classes.end(), [](auto const* candidate) {
+            return candidate->in_use >= candidate->limit && candidate->waiting.size() >= candidate->max_queued;
+        });
+        if (saturated != pending->classes.end()) {
+            ++(*saturated)->rejected;
+            return false;
+        }
+        ready = acquire(std::move(pending));
+    }
+    if (ready)
+        dispatch(std::move(ready));
+    return true;
+}
+
+void resource_limiter::dispatch(unique_ptr<request> ready)
+{
+    m_executor.post([ready = std::move(ready)]() { ready->work(); });
+}
+
+work_item resource_limiter::wrap(vector<resource_class*> const& classes, work_item item)
+{
+    return work_item([this, &classes, item = std::move(item)]() mutable {
+        // released even if item throws, the executor discards the exception but the permits must come back
+        struct releaser final
+        {
+            resource_limiter& owner;
+            vector<resource_class*> const& classes;
+            ~releaser()
+            {
+                owner.release(classes);
+            }
+        } const release_on_exit{*this, classes};
+        item();
+    });
+}
+
+void resource_limiter::release(vector<resource_class*> const& classes)
+{
+    vector<unique_ptr<request>> ready;
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto* const released : classes) {
+            --released->in_use;
+            if (released->waiting.empty())
+                continue;
+
+            // the freed permit goes straight to the longest waiting request which then carries on acquiring
+            auto next = std::move(released->waiting.front());
+            released->waiting.pop_front();
+            ++released->in_use;
+            ++next->acquired;
+            if (auto acquired = acquire(std::move(next)))
+                ready.push_back(std::move(acquired));
+        }
+    }
+    for (auto& current : ready)
+        dispatch(std::move(current));
+}
+
+}
@@ -0,0 +1,92 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/runtime_estimator.h>
+#include <stdexcept>
+
+using std::chrono::milliseconds;
+using std::make_shared;
+using std::shared_ptr;
+using std::type_index;
+
+namespace tasks
+{
+
+namespace
+{
+    milliseconds to_milliseconds(std::chrono::nanoseconds const estimate) noexcept
+    {
+        // rounded up so that a short but non zero estimate isn't reported as already finished
+        return std::chrono::ceil<milliseconds>(estimate);
+    }
+}
+
+void runtime_estimator::on_transition(task& source, task_state const previous, task_state const current) noexcept
+{
+    try {
+        auto const model = get_or_add_model(type_index(typeid(source)));
+        switch (current) {
+        case task_state::READY:
+        case task_state::RUNNING:
+            source.update_time_remaining(to_milliseconds(model->estimate(source.get_input_size())));
+            break;
+        case task_state::COMPLETE:
+            if (previous == task_state::RUNNING && source.get_started_at().has_value())
+                model->record(task::clock::now() - source.get_started_at().value(), source.get_input_size());
+            source.update_time_remaining(milliseconds::zero());
+            break;
+        case task_state::FAILED:
+            source.update_time_remaining(milliseconds::zero());
+            break;
+        case task_state::PENDING:
+            break;
+        }
+    } catch (std::bad_alloc const&) {
+        // estimation is best effort, losing a sample is preferable to failing the transition
+    }
+}
+
+shared_ptr<runtime_model const> runtime_estimator::find_model(type_index const& task_type) const
+{
+    std::shared_lock lock(m_mutex);
+    auto const match = m_models.find(task_type);
+    return match != m_models.end()
+        ? match->second
+        : nullptr;
+}
+
+runtime_estimator::runtime_estimator(double const smoothing)
+    : m_smoothing{smoothing}
+{
+    if (!(smoothing > 0.0 && smoothing <= 1.0))
+        throw std::invalid_argument("smoothing must be in (0, 1]");
+}
+
+shared_ptr<runtime_model> runtime_estimator::get_or_add_model(type_index const& task_type)
+{
+    {
+        std::shared_lock lock(m_mutex);
+        auto const match = m_models.find(task_type);
+        if (match != m_models.end())
+            return match->second;
+    }
+
+    std::unique_lock lock(m_mutex);
+    auto& model = m_models[task_type];
+    if (!model)
+        model = make_shared<runtime_model>(m_smoothing);
+    return model;
+}
+
+}
@@ -0,0 +1,94 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/runtime_model.h>
+#include <stdexcept>
+
+using std::chrono::nanoseconds;
+using std::optional;
+using std::uint64_t;
+
+namespace tasks
+{
+
+namespace
+{
+    // a fit through fewer points is too easily thrown by a single outlier
+    constexpr uint64_t MINIMUM_FIT_SAMPLES = 3U;
+
+    nanoseconds to_nanoseconds(double const value) noexcept
+    {
+        return nanoseconds(static_cast<nanoseconds::rep>(value < 0.0 ? 0.0 : value + 0.5));
+    }
+}
+
+void runtime_model::record(nanoseconds const duration, optional<double> const input_size) noexcept
+{
+    auto const sample = static_cast<double>(duration.count());
+
+    std::lock_guard lock(m_mutex);
+    m_average = m_count == 0U
+        ? sample
+        : m_average + m_smoothing * (sample - m_average);
+    ++m_count;
+    m_median.add(sample);
+    m_p90.add(sample);
+    m_p99.add(sample);
+
+    if (!input_size.has_value())
+        return;
+
+    auto const size = input_size.value();
+    ++m_sized_count;
+    auto const size_offset = size - m_mean_size;
+    m_mean_size += size_offset / static_cast<double>(m_sized_count);
+    m_mean_duration += (sample - m_mean_duration) / static_cast<double>(m_sized_count);
+    m_size_variance += size_offset * (size - m_mean_size);
+    m_covariance += size_offset * (sample - m_mean_duration);
+}
+
+nanoseconds runtime_model::estimate(optional<double> const input_size) const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    if (input_size.has_value() && has_fit()) {
+        auto const slope = m_covariance / m_size_variance;
+        return to_nanoseconds(m_mean_duration + slope * (input_size.value() - m_mean_size));
+    }
+    return to_nanoseconds(m_average);
+}
+
+runtime_statistics runtime_model::get_statistics() const
+{
+    std::lock_guard lock(m_mutex);
+    runtime_statistics statistics{m_count, to_nanoseconds(m_average), to_nanoseconds(m_median.get_value()), to_nanoseconds(m_p90.get_value()), to_nanoseconds(m_p99.get_value())};
+    if (has_fit()) {
+        statistics.slope = m_covariance / m_size_variance;
+        statistics.intercept = m_mean_duration - statistics.slope.value() * m_mean_size;
+    }
+    return statistics;
+}
+
+runtime_model::runtime_model(double const smoothing)
+    : m_smoothing{smoothing}
+{
+    if (!(smoothing > 0.0 && smoothing <= 1.0))
+        throw std::invalid_argument("smoothing must be in (0, 1]");
+}
+
+bool runtime_model::has_fit() const noexcept
+{
+    return m_sized_count >= MINIMUM_FIT_SAMPLES && m_size_variance > 0.0;
+}
+
+}
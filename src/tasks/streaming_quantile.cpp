@@ -0,0 +1,116 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/streaming_quantile.h>
+#include <algorithm>
+#include <stdexcept>
+
+using std::size_t;
+using std::uint64_t;
+
+namespace tasks
+{
+
+void streaming_quantile::add(double const value) noexcept
+{
+    if (m_count < MARKERS) {
+        m_heights[m_count++] = value;
+        if (m_count == MARKERS)
+            std::sort(m_heights.begin(), m_heights.end());
+        return;
+    }
+    ++m_count;
+
+    size_t cell{};
+    if (value < m_heights[0]) {
+        m_heights[0] = value;
+    } else if (value >= m_heights[MARKERS - 1]) {
+        m_heights[MARKERS - 1] = value;
+        cell = MARKERS - 2;
+    } else {
+        while (value >= m_heights[cell + 1])
+            ++cell;
+    }
+
+    for (auto index = cell + 1; index < MARKERS; ++index)
+        m_positions[index] += 1.0;
+    for (size_t index = 0; index < MARKERS; ++index)
+        m_desired[index] += m_increments[index];
+
+    // move each middle marker at most one position towards where it should be
+    for (size_t index = 1; index < MARKERS - 1; ++index) {
+        auto const offset = m_desired[index] - m_positions[index];
+        if ((offset >= 1.0 && m_positions[index + 1] - m_positions[index] > 1.0) ||
+            (offset <= -1.0 && m_positions[index - 1] - m_positions[index] < -1.0)) {
+            auto const direction = offset >= 0.0 ? 1.0 : -1.0;
+            auto const candidate = parabolic(index, direction);
+            m_heights[index] = m_heights[index - 1] < candidate && candidate < m_heights[index + 1]
+                ? candidate
+                : linear(index, direction);
+            m_positions[index] += direction;
+        }
+    }
+}
+
+double streaming_quantile::get_value() const noexcept
+{
+    if (m_count == 0U)
+        return 0.0;
+    if (m_count >= MARKERS)
+        return m_heights[2];
+
+    // too few samples for the markers to mean anything, use the exact quantile of what has been seen
+    auto seen = m_heights;
+    auto const last = seen.begin() + static_cast<std::ptrdiff_t>(m_count);
+    std::sort(seen.begin(), last);
+    auto const rank = static_cast<size_t>(m_probability * static_cast<double>(m_count - 1U) + 0.5);
+    return seen[rank];
+}
+
+double streaming_quantile::get_probability() const noexcept
+{
+    return m_probability;
+}
+
+uint64_t streaming_quantile::get_count() const noexcept
+{
+    return m_count;
+}
+
+streaming_quantile::streaming_quantile(double const probability)
+    : m_probability{probability}
+    , m_positions{1.0, 2.0, 3.0, 4.0, 5.0}
+    , m_desired{1.0, 1.0 + 2.0 * probability, 1.0 + 4.0 * probability, 3.0 + 2.0 * probability, 5.0}
+    , m_increments{0.0, probability / 2.0, probability, (1.0 + probability) / 2.0, 1.0}
+{
+    if (!(probability > 0.0 && probability < 1.0))
+        throw std::invalid_argument("probability must be between 0 and 1 exclusive");
+}
+
+double streaming_quantile::parabolic(size_t const index, double const direction) const noexcept
+{
+    auto const& q = m_heights;
+    auto const& n = m_positions;
+    return q[index] + direction / (n[index + 1] - n[index - 1]) *
+        ((n[index] - n[index - 1] + direction) * (q[index + 1] - q[index]) / (n[index + 1] - n[index]) +
+         (n[index + 1] - n[index] - direction) * (q[index] - q[index - 1]) / (n[index] - n[index - 1]));
+}
+
+double streaming_quantile::linear(size_t const index, double const direction) const noexcept
+{
+    auto const neighbour = direction > 0.0 ? index + 1 : index - 1;
+    return m_heights[index] + direction * (m_heights[neighbour] - m_heights[index]) / (m_positions[neighbour] - m_positions[index]);
+}
+
+}
@@ -13,27 +13,202 @@
 
 #include "pch.h"
 #include <tasks/task.h>
+#include <tasks/task_transition.h>
+#include <algorithm>
+#include <stdexcept>
+
+using std::make_shared;
+using std::nullopt;
+using std::optional;
+using std::shared_ptr;
+using std::chrono::milliseconds;
 
 namespace tasks
 {
 
+namespace
+{
+    /// <summary>true if leaving state starts a new run, which is given a stop_source of its own</summary>
+    [[nodiscard]] constexpr bool ends_run(task_state const state) noexcept
+    {
+        return state == task_state::COMPLETE || state == task_state::FAILED;
+    }
+}
+
 task_state task::get_current_state() const noexcept
 {
-    return m_current_state;
+    return m_current_state.load(std::memory_order_acquire);
+}
+milliseconds task::get_estimated_time_remaining() const noexcept
+{
+    auto const estimate = m_time_remaining.load(std::memory_order_relaxed);
+    if (get_current_state() != task_state::RUNNING)
+        return estimate;
+
+    auto const elapsed = std::chrono::duration_cast<milliseconds>(clock::now() - m_estimated_at.load(std::memory_order_relaxed));
+    return std::max(estimate - elapsed, milliseconds::zero());
+}
+void task::update_time_remaining(milliseconds const value) noexcept
+{
+    m_estimated_at.store(clock::now(), std::memory_order_relaxed);
+    m_time_remaining.store(value, std::memory_order_relaxed);
+}
+
+optional<task::clock::time_point> task::get_ready_at() const noexcept
+{
+    auto const ready = m_ready_at.load(std::memory_order_relaxed);
+    if (ready == clock::time_point::max())
+        return nullopt;
+    return ready;
+}
+
+optional<task::clock::time_point> task::get_started_at() const noexcept
+{
+    auto const started = m_started_at.load(std::memory_order_relaxed);
+    if (started == clock::time_point::max())
+        return nullopt;
+    return started;
+}
+
+optional<double> task::get_input_size() const noexcept
+{
+    return nullopt;
+}
+
+std::vector<std::string> task::get_resource_classes() const
+{
+    return {};
+}
+
+optional<task::clock::time_point> task::get_deadline() const noexcept
+{
+    auto const deadline = m_deadline.load(std::memory_order_relaxed);
+    if (deadline == clock::time_point::max())
+        return nullopt;
+    return deadline;
+}
+void task::set_deadline(optional<clock::time_point> const value) noexcept
+{
+    m_deadline.store(value.value_or(clock::time_point::max()), std::memory_order_relaxed);
 }
-std::chrono::milliseconds task::get_estimated_time_remaining() const noexcept
+
+optional<task::clock::duration> task::get_timeout() const noexcept
+{
+    auto const timeout = m_timeout.load(std::memory_order_relaxed);
+    if (timeout <= clock::duration::zero())
+        return nullopt;
+    return timeout;
+}
+void task::set_timeout(optional<clock::duration> const value) noexcept
+{
+    m_timeout.store(value.value_or(clock::duration::zero()), std::memory_order_relaxed);
+}
+
+std::stop_token task::get_stop_token() const
+{
+    std::lock_guard lock(m_stop_mutex);
+    return m_stop_source.get_token();
+}
+bool task::request_stop() noexcept
+{
+    std::stop_source current;
+    {
+        std::lock_guard lock(m_stop_mutex);
+        current = m_stop_source;
+    }
+    // requested outside the lock since callbacks may well complete the task
+    return current.request_stop();
+}
+
+bool task::try_transition(task_state const expected, task_state const desired)
+{
+    if (!is_valid_transition(expected, desired))
+        throw std::invalid_argument("invalid task state transition");
+
+    auto replacement = get_replacement(expected);
+    auto current = expected;
+    if (!m_current_state.compare_exchange_strong(current, desired, std::memory_order_acq_rel, std::memory_order_acquire))
+        return false;
+
+    on_transition(expected, desired, std::move(replacement));
+    return true;
+}
+
+void task::add_observer(shared_ptr<task_observer> observer)
 {
-    return m_time_remaining;
+    if (!observer)
+        throw std::invalid_argument("observer is null");
+
+    auto current = m_observers.load(std::memory_order_acquire);
+    shared_ptr<observer_list const> updated;
+    do {
+        auto copy = current ? make_shared<observer_list>(*current) : make_shared<observer_list>();
+        copy->push_back(observer);
+        updated = std::move(copy);
+    } while (!m_observers.compare_exchange_weak(current, updated, std::memory_order_acq_rel, std::memory_order_acquire));
 }
 
-inline void task::update_task_state(task_state const value)
+bool task::remove_observer(task_observer const& observer) noexcept
 {
-    m_current_state = value;
+    auto current = m_observers.load(std::memory_order_acquire);
+    shared_ptr<observer_list const> updated;
+    do {
+        if (!current)
+            return false;
+        auto const match = std::find_if(current->begin(), current->end(), [&observer](auto const& candidate) { return candidate.get() == &observer; });
+        if (match == current->end())
+            return false;
+
+        auto copy = make_shared<observer_list>(*current);
+        copy->erase(copy->begin() + (match - current->begin()));
+        updated = copy->empty() ? nullptr : std::move(copy);
+    } while (!m_observers.compare_exchange_weak(current, updated, std::memory_order_acq_rel, std::memory_order_acquire));
+    return true;
 }
 
-inline void task::update_time_remaining(task_state const value)
+void task::update_task_state(task_state const value)
 {
-    m_current_state = value;
+    auto current = m_current_state.load(std::memory_order_acquire);
+    std::stop_source replacement(std::nostopstate);
+    do {
+        if (!is_valid_transition(current, value))
+            throw std::invalid_argument("invalid task state transition");
+        // a retry may start from another state, which may or may not need a fresh stop_source
+        if (replacement.stop_possible() != ends_run(current))
+            replacement = get_replacement(current);
+    } while (!m_current_state.compare_exchange_weak(current, value, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    on_transition(current, value, std::move(replacement));
+}
+
+std::stop_source task::get_replacement(task_state const previous)
+{
+    return ends_run(previous)
+        ? std::stop_source()
+        : std::stop_source(std::nostopstate);
+}
+
+void task::on_transition(task_state const previous, task_state const current, std::stop_source replacement) noexcept
+{
+    // only a swap happens here, the allocation was made before the state changed so nothing below can throw
+    if (replacement.stop_possible()) {
+        std::lock_guard lock(m_stop_mutex);
+        m_stop_source.swap(replacement);
+    }
+    if (current == task_state::READY)
+        m_ready_at.store(clock::now(), std::memory_order_relaxed);
+    if (current == task_state::RUNNING) {
+        // an estimate made while waiting to run counts down from the start rather than from when it was made
+        auto const now = clock::now();
+        m_started_at.store(now, std::memory_order_relaxed);
+        m_estimated_at.store(now, std::memory_order_relaxed);
+    }
+
+    auto const observers = m_observers.load(std::memory_order_acquire);
+    if (!observers)
+        return;
+    for (auto const& observer : *observers)
+        observer->on_transition(*this, previous, current);
 }
 
 }
@@ -0,0 +1,153 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/task_graph.h>
+#include <atomic>
+#include <stdexcept>
+
+using std::any;
+using std::future;
+using std::make_shared;
+using std::shared_ptr;
+using std::size_t;
+using std::vector;
+
+namespace tasks
+{
+
+struct task_graph::run_state final
+{
+    executor& worker_pool;
+    std::unique_ptr<std::atomic<size_t>[]> pending;
+    std::unique_ptr<std::atomic<bool>[]> cancelled;
+    vector<vector<any>> inputs;
+    task_graph_result result;
+    std::atomic<size_t> remaining;
+    std::promise<task_graph_result> completion{};
+
+    explicit run_state(executor& executor, size_t const size)
+        : worker_pool{executor}
+        , pending{std::make_unique<std::atomic<size_t>[]>(size)}
+        , cancelled{std::make_unique<std::atomic<bool>[]>(size)}
+        , inputs(size)
+        , remaining{size}
+    {
+        result.outcomes.resize(size, node_outcome::CANCELLED);
+        result.outputs.resize(size);
+        result.errors.resize(size);
+    }
+};
+
+task_graph::node_id task_graph::add_node(node_function work, vector<node_id> const& dependencies)
+{
+    if (!work)
+        throw std::invalid_argument("work is empty");
+
+    auto const id = m_nodes.size();
+    for (auto const dependency : dependencies)
+        if (dependency >= id)
+            throw std::invalid_argument("dependency has not been added");
+
+    for (size_t input_index = 0; input_index < dependencies.size(); ++input_index)
+        m_nodes[dependencies[input_index]].successors.push_back(successor{id, input_index});
+    m_nodes.push_back(node{std::move(work), dependencies.size(), {}});
+    return id;
+}
+
+future<task_graph_result> task_graph::run(executor& executor) const
+{
+    auto const state = make_shared<run_state>(executor, m_nodes.size());
+    auto result = state->completion.get_future();
+    if (m_nodes.empty()) {
+        state->completion.set_value(std::move(state->result));
+        return result;
+    }
+
+    for (node_id id = 0; id < m_nodes.size(); ++id) {
+        state->pending[id].store(m_nodes[id].dependency_count, std::memory_order_relaxed);
+        state->inputs[id].resize(m_nodes[id].dependency_count);
+    }
+    // counters are initialised before anything is posted, workers see them through the executor's queue lock
+    for (node_id id = 0; id < m_nodes.size(); ++id)
+        if (m_nodes[id].dependency_count == 0U)
+            post(state, id);
+    return result;
+}
+
+size_t task_graph::size() const noexcept
+{
+    return m_nodes.size();
+}
+
+void task_graph::execute(shared_ptr<run_state> const& state, node_id const id) const
+{
+    auto succeeded = false;
+    try {
+        state->result.outputs[id] = m_nodes[id].work(std::move(state->inputs[id]));
+        state->result.outcomes[id] = node_outcome::COMPLETE;
+        succeeded = true;
+    } catch (...) {
+        state->result.errors[id] = std::current_exception();
+        state->result.outcomes[id] = node_outcome::FAILED;
+    }
+    finish(state, id, succeeded);
+}
+
+void task_graph::finish(shared_ptr<run_state> const& state, node_id const id, bool const succeeded) const
+{
+    // cancellation is walked with an explicit stack so a failure at the head of a long chain can't overflow
+    vector<node_id> cancelled;
+    release_successors(state, id, succeeded, cancelled);
+    auto finished = size_t{1};
+    while (!cancelled.empty()) {
+        auto const current = cancelled.back();
+        cancelled.pop_back();
+        release_successors(state, current, false, cancelled);
+        ++finished;
+    }
+
+    if (state->remaining.fetch_sub(finished, std::memory_order_acq_rel) == finished)
+        state->completion.set_value(std::move(state->result));
+}
+
+void task_graph::release_successors(shared_ptr<run_state> const& state, node_id const id, bool const succeeded, vector<node_id>& cancelled) const
+{
+    auto const& successors = m_nodes[id].successors;
+    for (size_t index = 0; index < successors.size(); ++index) {
+        auto const& [target, input_index] = successors[index];
+        if (succeeded) {
+            // every dependent but the last gets a copy, the last takes the value itself
+            auto& output = state->result.outputs[id];
+            state->inputs[target][input_index] = index + 1U == successors.size()
+                ? std::move(output)
+                : output;
+        } else {
+            state->cancelled[target].store(true, std::memory_order_relaxed);
+        }
+
+        if (state->pending[target].fetch_sub(1U, std::memory_order_acq_rel) != 1U)
+            continue;
+        if (state->cancelled[target].load(std::memory_order_relaxed))
+            cancelled.push_back(target);
+        else
+            post(state, target);
+    }
+}
+
+void task_graph::post(shared_ptr<run_state> const& state, node_id const id) const
+{
+    state->worker_pool.post([this, state, id]() { execute(state, id); });
+}
+
+}
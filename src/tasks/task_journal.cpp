@@ -0,0 +1,624 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/task_journal.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#endif
+
+using std::array;
+using std::int64_t;
+using std::optional;
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::uint8_t;
+using std::vector;
+using std::filesystem::path;
+
+namespace tasks
+{
+
+namespace
+{
+    constexpr size_t RECORD_SIZE = 32U;
+    constexpr size_t HEADER_SIZE = 16U;
+    constexpr array<char, 8> MAGIC{'T', 'S', 'K', 'J', 'R', 'N', 'L', '\0'};
+    constexpr uint32_t VERSION = 1U;
+    // a whole number of records so a chunk never splits one
+    constexpr size_t READ_CHUNK = RECORD_SIZE * 32'768U;
+
+    constexpr char const* LOG_NAME = "journal.log";
+    constexpr char const* CHECKPOINT_NAME = "journal.checkpoint";
+    constexpr char const* CHECKPOINT_TEMPORARY_NAME = "journal.checkpoint.tmp";
+
+    constexpr array<uint32_t, 256> make_crc_table() noexcept
+    {
+        array<uint32_t, 256> table{};
+        for (uint32_t index = 0; index < table.size(); ++index) {
+            auto value = index;
+            for (auto bit = 0; bit < 8; ++bit)
+                value = (value & 1U) != 0U ? 0xEDB88320U ^ (value >> 1U) : value >> 1U;
+            table[index] = value;
+        }
+        return table;
+    }
+    constexpr auto CRC_TABLE = make_crc_table();
+
+    uint32_t crc32(uint8_t const* data, size_t const length, uint32_t crc = 0xFFFFFFFFU) noexcept
+    {
+        for (size_t index = 0; index < length; ++index)
+            crc = CRC_TABLE[(crc ^ data[index]) & 0xFFU] ^ (crc >> 8U);
+        return crc;
+    }
+
+    void put(uint8_t* destination, uint64_t value, size_t const length) noexcept
+    {
+        for (size_t index = 0; index < length; ++index, value >>= 8U)
+            destination[index] = static_cast<uint8_t>(value & 0xFFU);
+    }
+    uint64_t get(uint8_t const* source, size_t const length) noexcept
+    {
+        uint64_t value{};
+        for (size_t index = length; index > 0; --index)
+            value = (value << 8U) | source[index - 1];
+        return value;
+    }
+
+    // type, state, 2 reserved bytes, crc32 of every other byte, id, timestamp, value
+    void encode(journal_record const& value, uint8_t* destination) noexcept
+    {
+        std::memset(destination, 0, RECORD_SIZE);
+        destination[0] = static_cast<uint8_t>(value.type);
+        destination[1] = static_cast<uint8_t>(value.state);
+        put(destination + 8, value.id, 8U);
+        put(destination + 16, static_cast<uint64_t>(value.timestamp), 8U);
+        put(destination + 24, static_cast<uint64_t>(value.value), 8U);
+        auto const crc = crc32(destination + 8, RECORD_SIZE - 8U, crc32(destination, 4U));
+        put(destination + 4, crc ^ 0xFFFFFFFFU, 4U);
+    }
+    optional<journal_record> decode(uint8_t const* source) noexcept
+    {
+        auto const crc = crc32(source + 8, RECORD_SIZE - 8U, crc32(source, 4U)) ^ 0xFFFFFFFFU;
+        if (crc != get(source + 4, 4U))
+            return std::nullopt;
+        if (source[0] < static_cast<uint8_t>(journal_record_type::TRANSITION) || source[0] > static_cast<uint8_t>(journal_record_type::REMOVE))
+            return std::nullopt;
+        if (source[1] > static_cast<uint8_t>(task_state::FAILED))
+            return std::nullopt;
+
+        return journal_record{
+            static_cast<journal_record_type>(source[0]),
+            static_cast<task_state>(source[1]),
+            get(source + 8, 8U),
+            static_cast<int64_t>(get(source + 16, 8U)),
+            static_cast<int64_t>(get(source + 24, 8U))};
+    }
+
+    array<uint8_t, HEADER_SIZE> make_header() noexcept
+    {
+        array<uint8_t, HEADER_SIZE> header{};
+        std::memcpy(header.data(), MAGIC.data(), MAGIC.size());
+        put(header.data() + MAGIC.size(), VERSION, 4U);
+        return header;
+    }
+
+    journal_entry::clock::duration to_duration(int64_t const nanoseconds) noexcept
+    {
+        return std::chrono::duration_cast<journal_entry::clock::duration>(std::chrono::nanoseconds(nanoseconds));
+    }
+    journal_entry::clock::time_point to_time_point(int64_t const nanoseconds) noexcept
+    {
+        return journal_entry::clock::time_point(to_duration(nanoseconds));
+    }
+    int64_t to_nanoseconds(journal_entry::clock::duration const value) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(value).count();
+    }
+
+    // every record sets or clears fields outright, so applying a log a second time over state it already
+    // produced leaves that state unchanged; compaction relies on this if it is interrupted part way
+    void apply(journal_state& state, journal_record const& value)
+    {
+        switch (value.type) {
+        case journal_record_type::TRANSITION: {
+            auto& entry = state[value.id];
+            entry.state = value.state;
+            entry.updated_at = to_time_point(value.timestamp);
+            break;
+        }
+        case journal_record_type::SCHEDULE: {
+            auto& entry = state[value.id];
+            entry.anchor = to_time_point(value.timestamp);
+            entry.period = to_duration(value.value);
+            break;
+        }
+        case journal_record_type::REMOVE:
+            state.erase(value.id);
+            break;
+        }
+    }
+
+#if defined(_WIN32)
+    using journal_file = shared::infrastructure::invalid_handle;
+
+    [[noreturn]] void throw_last_error(char const* what)
+    {
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+    }
+
+    [[nodiscard]] bool was_missing() noexcept
+    {
+        auto const error = GetLastError();
+        return error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND;
+    }
+
+    [[nodiscard]] journal_file open_for_reading(path const& file) noexcept
+    {
+        return journal_file(CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+    }
+
+    /// <summary>opens, or creates, the log positioned at its end, writes then go to the end as there is only one writer</summary>
+    [[nodiscard]] journal_file open_log(path const& file)
+    {
+        journal_file log(CreateFileW(file.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+        if (!static_cast<bool>(log))
+            throw_last_error("unable to open journal log");
+        if (SetFilePointerEx(log.Get(), LARGE_INTEGER{}, nullptr, FILE_END) == FALSE)
+            throw_last_error("unable to seek journal log");
+        return log;
+    }
+
+    [[nodiscard]] journal_file create_file(path const& file) noexcept
+    {
+        return journal_file(CreateFileW(file.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+    }
+
+    size_t read_some(journal_file const& file, void* data, size_t const length)
+    {
+        DWORD count{};
+        if (ReadFile(file.Get(), data, static_cast<DWORD>(std::min<size_t>(length, MAXDWORD)), &count, nullptr) == FALSE)
+            throw_last_error("unable to read journal file");
+        return count;
+    }
+
+    void write_all(journal_file const& file, void const* data, size_t length)
+    {
+        auto const* remaining = static_cast<char const*>(data);
+        while (length > 0U) {
+            DWORD written{};
+            if (WriteFile(file.Get(), remaining, static_cast<DWORD>(std::min<size_t>(length, MAXDWORD)), &written, nullptr) == FALSE)
+                throw_last_error("write failed");
+            remaining += written;
+            length -= written;
+        }
+    }
+
+    void sync(journal_file const& file)
+    {
+        if (FlushFileBuffers(file.Get()) == FALSE)
+            throw_last_error("FlushFileBuffers failed");
+    }
+
+    /// <summary>truncates file to length, leaving it positioned at its new end</summary>
+    void truncate(journal_file const& file, size_t const length)
+    {
+        LARGE_INTEGER position{};
+        position.QuadPart = static_cast<LONGLONG>(length);
+        if (SetFilePointerEx(file.Get(), position, nullptr, FILE_BEGIN) == FALSE || SetEndOfFile(file.Get()) == FALSE)
+            throw_last_error("unable to truncate journal log");
+    }
+
+    void replace(path const& source, path const& destination)
+    {
+        // write through so the rename is durable before returning, NTFS journals the directory change itself
+        if (MoveFileExW(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == FALSE)
+            throw_last_error("unable to replace journal checkpoint");
+    }
+
+    void sync_directory(path const&) noexcept
+    {
+        // nothing to do, see replace
+    }
+#else
+    using journal_file = shared::infrastructure::posix_fd;
+
+    [[noreturn]] void throw_last_error(char const* what)
+    {
+        throw std::system_error(errno, std::system_category(), what);
+    }
+
+    [[nodiscard]] bool was_missing() noexcept
+    {
+        return errno == ENOENT;
+    }
+
+    [[nodiscard]] journal_file open_for_reading(path const& file) noexcept
+    {
+        return journal_file(::open(file.c_str(), O_RDONLY | O_CLOEXEC));
+    }
+
+    /// <summary>opens, or creates, the log for appending</summary>
+    [[nodiscard]] journal_file open_log(path const& file)
+    {
+        journal_file log(::open(file.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644));
+        if (!static_cast<bool>(log))
+            throw_last_error("unable to open journal log");
+        return log;
+    }
+
+    [[nodiscard]] journal_file create_file(path const& file) noexcept
+    {
+        return journal_file(::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    }
+
+    size_t read_some(journal_file const& file, void* data, size_t const length)
+    {
+        while (true) {
+            auto const count = ::read(file.Get(), data, length);
+            if (count >= 0)
+                return static_cast<size_t>(count);
+            if (errno != EINTR)
+                throw_last_error("unable to read journal file");
+        }
+    }
+
+    void write_all(journal_file const& file, void const* data, size_t length)
+    {
+        auto const* remaining = static_cast<char const*>(data);
+        while (length > 0U) {
+            auto const written = ::write(file.Get(), remaining, length);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw_last_error("write failed");
+            }
+            remaining += written;
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    void sync(journal_file const& file)
+    {
+        if (::fdatasync(file.Get()) != 0)
+            throw_last_error("fdatasync failed");
+    }
+
+    void truncate(journal_file const& file, size_t const length)
+    {
+        if (::ftruncate(file.Get(), static_cast<off_t>(length)) != 0)
+            throw_last_error("ftruncate failed");
+    }
+
+    void replace(path const& source, path const& destination)
+    {
+        std::filesystem::rename(source, destination);
+    }
+
+    void sync_directory(path const& directory)
+    {
+        journal_file const handle(::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        if (!static_cast<bool>(handle))
+            throw_last_error("unable to open journal directory");
+        if (::fsync(handle.Get()) != 0)
+            throw_last_error("fsync failed");
+    }
+#endif
+
+    /// returns the length of the valid prefix of file, 0 if it is missing or doesn't start with a journal header
+    size_t read_file(path const& file, journal_state& state)
+    {
+        auto const handle = open_for_reading(file);
+        if (!static_cast<bool>(handle)) {
+            if (was_missing())
+                return 0U;
+            throw_last_error("unable to open journal file");
+        }
+
+        vector<uint8_t> buffer(READ_CHUNK);
+        size_t buffered{};
+        size_t valid{};
+        bool header_read{};
+        while (true) {
+            auto const count = read_some(handle, buffer.data() + buffered, buffer.size() - buffered);
+            buffered += count;
+            auto const at_end = count == 0U;
+
+            size_t offset{};
+            if (!header_read) {
+                if (buffered < HEADER_SIZE) {
+                    if (at_end)
+                        return 0U;
+                    continue;
+                }
+                if (std::memcmp(buffer.data(), make_header().data(), HEADER_SIZE) != 0)
+                    return 0U;
+                header_read = true;
+                offset = HEADER_SIZE;
+                valid = HEADER_SIZE;
+            }
+
+            for (; offset + RECORD_SIZE <= buffered; offset += RECORD_SIZE) {
+                auto const decoded = decode(buffer.data() + offset);
+                if (!decoded.has_value())
+                    return valid;
+                apply(state, decoded.value());
+                valid += RECORD_SIZE;
+            }
+            if (at_end)
+                return valid;
+
+            buffered -= offset;
+            std::memmove(buffer.data(), buffer.data() + offset, buffered);
+        }
+    }
+}
+
+std::optional<journal_entry::clock::time_point> journal_entry::get_next_due(clock::time_point const now) const noexcept
+{
+    if (!period.has_value() || period.value() <= clock::duration::zero())
+        return std::nullopt;
+    if (now < anchor)
+        return anchor;
+
+    auto const elapsed_periods = (now - anchor) / period.value();
+    return anchor + period.value() * (elapsed_periods + 1);
+}
+
+void task_journal::on_transition(task& source, task_state const, task_state const current) noexcept
+{
+    try {
+        uint64_t id{};
+        {
+            std::shared_lock lock(m_tracked_mutex);
+            auto const tracked = m_tracked.find(&source);
+            if (tracked == m_tracked.end())
+                return;
+            id = tracked->second;
+        }
+        static_cast<void>(append_transition(id, current));
+    } catch (std::exception const&) {
+        // the failure is kept by the writer and reported to the next caller which appends or waits
+    }
+}
+
+void task_journal::track(task const& target, uint64_t const id)
+{
+    std::unique_lock lock(m_tracked_mutex);
+    m_tracked[&target] = id;
+}
+
+bool task_journal::untrack(task const& target)
+{
+    std::unique_lock lock(m_tracked_mutex);
+    return m_tracked.erase(&target) > 0U;
+}
+
+task_journal::sequence task_journal::append_transition(uint64_t const id, task_state const state)
+{
+    return append(journal_record{journal_record_type::TRANSITION, state, id, to_nanoseconds(clock::now().time_since_epoch()), 0});
+}
+
+task_journal::sequence task_journal::append_schedule(uint64_t const id, clock::time_point const anchor, clock::duration const period)
+{
+    if (period <= clock::duration::zero())
+        throw std::invalid_argument("period must be positive");
+    return append(journal_record{journal_record_type::SCHEDULE, task_state::PENDING, id, to_nanoseconds(anchor.time_since_epoch()), to_nanoseconds(period)});
+}
+
+task_journal::sequence task_journal::append_remove(uint64_t const id)
+{
+    return append(journal_record{journal_record_type::REMOVE, task_state::PENDING, id, 0, 0});
+}
+
+void task_journal::wait_durable(sequence const value)
+{
+    std::unique_lock lock(m_mutex);
+    m_durable_changed.wait(lock, [this, value]() { return m_durable >= value || m_failure; });
+    if (m_durable < value)
+        std::rethrow_exception(m_failure);
+}
+
+void task_journal::flush()
+{
+    sequence appended{};
+    {
+        std::lock_guard lock(m_mutex);
+        appended = m_appended;
+    }
+    wait_durable(appended);
+}
+
+void task_journal::compact()
+{
+    std::unique_lock lock(m_mutex);
+    if (m_failure)
+        std::rethrow_exception(m_failure);
+
+    auto const compactions = m_compactions;
+    m_compact_requested = true;
+    m_work_available.notify_one();
+    m_durable_changed.wait(lock, [this, compactions]() { return m_compactions != compactions || m_failure; });
+    if (m_compactions == compactions)
+        std::rethrow_exception(m_failure);
+}
+
+journal_state const& task_journal::get_recovered() const noexcept
+{
+    return m_recovered;
+}
+
+size_t task_journal::get_log_size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_log_size;
+}
+
+size_t task_journal::get_sync_count() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_sync_count;
+}
+
+journal_state task_journal::replay(path const& directory)
+{
+    journal_state state{};
+    static_cast<void>(read_file(directory / CHECKPOINT_NAME, state));
+    static_cast<void>(read_file(directory / LOG_NAME, state));
+    return state;
+}
+
+task_journal::task_journal(path directory, size_t const compact_after)
+    : m_directory{std::move(directory)}
+    , m_compact_after{compact_after}
+{
+    std::filesystem::create_directories(m_directory);
+
+    static_cast<void>(read_file(m_directory / CHECKPOINT_NAME, m_recovered));
+    auto const valid = read_file(m_directory / LOG_NAME, m_recovered);
+
+    m_log = open_log(m_directory / LOG_NAME);
+
+    // anything past the valid prefix is a record torn by a crash, it has to go before appending resumes
+    truncate(m_log, valid);
+    if (valid == 0U) {
+        auto const header = make_header();
+        write_all(m_log, header.data(), header.size());
+        sync(m_log);
+        sync_directory(m_directory);
+    }
+
+    m_log_size = valid == 0U ? 0U : (valid - HEADER_SIZE) / RECORD_SIZE;
+    m_state = m_recovered;
+    m_writer = std::thread([this]() { write_pending(); });
+}
+
+task_journal::~task_journal()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_work_available.notify_one();
+    if (m_writer.joinable())
+        m_writer.join();
+}
+
+task_journal::sequence task_journal::append(journal_record const& value)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_failure)
+        std::rethrow_exception(m_failure);
+
+    m_pending.push_back(value);
+    m_work_available.notify_one();
+    return ++m_appended;
+}
+
+void task_journal::write_pending()
+{
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_work_available.wait(lock, [this]() { return m_stopping || m_compact_requested || !m_pending.empty(); });
+        if (m_pending.empty() && !m_compact_requested)
+            return;
+
+        // whatever accumulated while the last batch was being synced is written and synced as one
+        m_writing.swap(m_pending);
+        auto const batch_end = m_appended;
+        auto const log_size = m_log_size + m_writing.size();
+        auto const compact = std::exchange(m_compact_requested, false) || log_size >= m_compact_after;
+        auto const synced = !m_writing.empty();
+        lock.unlock();
+
+        std::exception_ptr failure{};
+        try {
+            if (synced)
+                write_records(m_writing);
+            if (compact)
+                write_checkpoint();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        m_writing.clear();
+
+        lock.lock();
+        if (failure) {
+            m_failure = failure;
+        } else {
+            m_durable = batch_end;
+            m_log_size = compact ? 0U : log_size;
+            m_sync_count += synced ? 1U : 0U;
+            m_compactions += compact ? 1U : 0U;
+        }
+        m_durable_changed.notify_all();
+    }
+}
+
+void task_journal::write_records(vector<journal_record> const& records)
+{
+    m_encoded.resize(records.size() * RECORD_SIZE);
+    auto* destination = reinterpret_cast<uint8_t*>(m_encoded.data());
+    for (auto const& current : records) {
+        encode(current, destination);
+        destination += RECORD_SIZE;
+    }
+
+    write_all(m_log, m_encoded.data(), m_encoded.size());
+    sync(m_log);
+
+    for (auto const& current : records)
+        apply(m_state, current);
+}
+
+void task_journal::write_checkpoint()
+{
+    m_encoded.clear();
+    auto const header = make_header();
+    m_encoded.insert(m_encoded.end(), header.begin(), header.end());
+
+    auto const add = [this](journal_record const& value) {
+        auto const offset = m_encoded.size();
+        m_encoded.resize(offset + RECORD_SIZE);
+        encode(value, reinterpret_cast<uint8_t*>(m_encoded.data() + offset));
+    };
+    for (auto const& [id, entry] : m_state) {
+        if (entry.period.has_value())
+            add(journal_record{journal_record_type::SCHEDULE, task_state::PENDING, id, to_nanoseconds(entry.anchor.time_since_epoch()), to_nanoseconds(entry.period.value())});
+        if (entry.state.has_value())
+            add(journal_record{journal_record_type::TRANSITION, entry.state.value(), id, to_nanoseconds(entry.updated_at.time_since_epoch()), 0});
+    }
+
+    auto const temporary = m_directory / CHECKPOINT_TEMPORARY_NAME;
+    {
+        auto const checkpoint = create_file(temporary);
+        if (!static_cast<bool>(checkpoint))
+            throw_last_error("unable to create journal checkpoint");
+        write_all(checkpoint, m_encoded.data(), m_encoded.size());
+        sync(checkpoint);
+    }
+    replace(temporary, m_directory / CHECKPOINT_NAME);
+    sync_directory(m_directory);
+
+    // a crash before this point replays the old log over the new checkpoint, which apply makes harmless
+    truncate(m_log, HEADER_SIZE);
+    sync(m_log);
+}
+
+}
@@ -0,0 +1,80 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/timeout_monitor.h>
+
+using std::size_t;
+
+#if defined(__linux__)
+using shared::infrastructure::epoll_reactor;
+#endif
+
+namespace tasks
+{
+
+void timeout_monitor::on_transition(task& source, task_state const, task_state const current) noexcept
+{
+    try {
+        std::lock_guard lock(m_mutex);
+        if (current == task_state::RUNNING) {
+            auto const timeout = source.get_timeout();
+            if (timeout.has_value())
+                m_armed[&source] = m_timers.schedule_once(source, timeout.value());
+            return;
+        }
+
+        auto const armed = m_armed.find(&source);
+        if (armed == m_armed.end())
+            return;
+        m_timers.cancel(armed->second);
+        m_armed.erase(armed);
+    } catch (std::exception const&) {
+        // a timeout which can't be armed leaves the task unbounded, which is no worse than not having one
+    }
+}
+
+size_t timeout_monitor::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_armed.size();
+}
+
+#if defined(__linux__)
+timeout_monitor::timeout_monitor(epoll_reactor& reactor, timer_scheduler::clock::duration const resolution)
+    : m_timers{reactor, [this](task& expired, timer_id const& id) { on_expired(expired, id); }, resolution}
+{
+}
+#endif
+
+timeout_monitor::timeout_monitor(timer_scheduler::clock::duration const resolution)
+    : m_timers{[this](task& expired, timer_id const& id) { on_expired(expired, id); }, resolution}
+{
+}
+
+void timeout_monitor::on_expired(task& expired, timer_id const& id)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        auto const armed = m_armed.find(&expired);
+        // the task may have finished, and even started again, between the timer firing and this running
+        if (armed == m_armed.end() || armed->second != id)
+            return;
+        m_armed.erase(armed);
+    }
+
+    // outside the lock as stop callbacks can complete the task, which comes back through on_transition
+    expired.request_stop();
+}
+
+}
@@ -0,0 +1,245 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/timer_scheduler.h>
+#include <stdexcept>
+#include <system_error>
+#if defined(__linux__)
+#include <cerrno>
+#elif defined(_WIN32)
+#include <array>
+#endif
+
+using std::optional;
+using std::size_t;
+
+#if defined(__linux__)
+using shared::infrastructure::epoll_reactor;
+using shared::infrastructure::make_timerfd;
+#endif
+
+#if defined(_WIN32) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace tasks
+{
+
+namespace
+{
+#if defined(__linux__)
+    timespec to_timespec(timer_wheel::clock::time_point const time) noexcept
+    {
+        // libstdc++ and libc++ both implement steady_clock over CLOCK_MONOTONIC, the clock the timerfd is created with
+        auto const since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch());
+        auto const seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+        return timespec{static_cast<time_t>(seconds.count()), static_cast<long>((since_epoch - seconds).count())};
+    }
+#elif defined(_WIN32)
+    using file_time_duration = std::chrono::duration<LONGLONG, std::ratio<1, 10'000'000>>;
+#endif
+}
+
+timer_id timer_scheduler::schedule_once(task& target, clock::duration const delay)
+{
+    std::lock_guard lock(m_mutex);
+    auto const id = m_wheel.schedule_once(target, relative_to_wheel(delay));
+    rearm(false);
+    return id;
+}
+
+timer_id timer_scheduler::schedule_periodic(task& target, clock::duration const period, optional<clock::duration> const initial_delay)
+{
+    std::lock_guard lock(m_mutex);
+    auto const id = m_wheel.schedule_periodic(target, period, relative_to_wheel(initial_delay.value_or(period)));
+    rearm(false);
+    return id;
+}
+
+bool timer_scheduler::cancel(timer_id const& id) noexcept
+{
+    // the timer is left armed, at worst that costs one wakeup which finds nothing to do
+    std::lock_guard lock(m_mutex);
+    return m_wheel.cancel(id);
+}
+
+bool timer_scheduler::is_scheduled(timer_id const& id) const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_wheel.is_scheduled(id);
+}
+
+size_t timer_scheduler::size() const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_wheel.size();
+}
+
+#if defined(__linux__)
+
+timer_scheduler::timer_scheduler(epoll_reactor& reactor, expired_callback on_expired, clock::duration const resolution)
+    : m_wheel{resolution}
+    , m_on_expired{std::move(on_expired)}
+    , m_reactor{&reactor}
+{
+    if (!m_on_expired)
+        throw std::invalid_argument("on_expired is empty");
+    open_timer();
+}
+
+timer_scheduler::timer_scheduler(expired_callback on_expired, clock::duration const resolution)
+    : m_wheel{resolution}
+    , m_on_expired{std::move(on_expired)}
+    , m_owned_reactor{std::make_unique<epoll_reactor>()}
+    , m_reactor{m_owned_reactor.get()}
+{
+    if (!m_on_expired)
+        throw std::invalid_argument("on_expired is empty");
+    open_timer();
+    m_worker = std::thread([this]() { m_reactor->run(); });
+}
+
+timer_scheduler::~timer_scheduler()
+{
+    if (m_worker.joinable()) {
+        m_reactor->stop();
+        m_worker.join();
+    }
+    if (m_registration.has_value())
+        m_reactor->remove(m_registration.value());
+}
+
+void timer_scheduler::open_timer()
+{
+    auto timer = make_timerfd();
+    if (!static_cast<bool>(timer))
+        throw std::system_error(errno, std::system_category(), "timerfd_create failed");
+    m_timer_descriptor = timer.Get();
+
+    m_registration = m_reactor->add(std::move(timer), EPOLLIN, [this](int, std::uint32_t) {
+        std::uint64_t expirations{};
+        static_cast<void>(::read(m_timer_descriptor, &expirations, sizeof(expirations)));
+        on_timer_ready();
+    });
+    if (!m_registration.has_value())
+        throw std::runtime_error("unable to register timer with reactor");
+}
+
+void timer_scheduler::rearm(bool const force) noexcept
+{
+    auto const next = m_wheel.get_next_expiry();
+    if (!force && m_armed_for.has_value() && next.has_value() && m_armed_for.value() <= next.value())
+        return;
+    if (!force && !next.has_value())
+        return;
+
+    itimerspec setting{};
+    if (next.has_value())
+        setting.it_value = to_timespec(next.value());
+    // an all zero it_value disarms the timer
+    if (setting.it_value.tv_sec == 0 && setting.it_value.tv_nsec == 0)
+        setting.it_value.tv_nsec = next.has_value() ? 1 : 0;
+
+    static_cast<void>(::timerfd_settime(m_timer_descriptor, TFD_TIMER_ABSTIME, &setting, nullptr));
+    m_armed_for = next;
+}
+
+#elif defined(_WIN32)
+
+timer_scheduler::timer_scheduler(expired_callback on_expired, clock::duration const resolution)
+    : m_wheel{resolution}
+    , m_on_expired{std::move(on_expired)}
+{
+    if (!m_on_expired)
+        throw std::invalid_argument("on_expired is empty");
+    open_timer();
+    m_worker = std::thread([this]() { wait_for_timer(); });
+}
+
+timer_scheduler::~timer_scheduler()
+{
+    if (!m_worker.joinable())
+        return;
+    static_cast<void>(SetEvent(m_stop_requested.Get()));
+    m_worker.join();
+}
+
+void timer_scheduler::open_timer()
+{
+    // high resolution timers arrived with Windows 10 1803, older versions fall back to the system timer tick
+    m_timer.Reset(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS));
+    if (!m_timer)
+        m_timer.Reset(CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS));
+    if (!m_timer)
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "CreateWaitableTimerEx failed");
+
+    m_stop_requested.Reset(CreateEventW(nullptr, TRUE, FALSE, nullptr));
+    if (!m_stop_requested)
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "CreateEvent failed");
+}
+
+void timer_scheduler::wait_for_timer()
+{
+    // the stop event is first so it wins over a timer signalled at the same moment
+    std::array<HANDLE, 2> const handles{m_stop_requested.Get(), m_timer.Get()};
+    while (WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE) == WAIT_OBJECT_0 + 1)
+        on_timer_ready();
+}
+
+void timer_scheduler::rearm(bool const force) noexcept
+{
+    auto const next = m_wheel.get_next_expiry();
+    if (!force && m_armed_for.has_value() && next.has_value() && m_armed_for.value() <= next.value())
+        return;
+    if (!force && !next.has_value())
+        return;
+
+    if (next.has_value()) {
+        // absolute due times are against the system clock, which steady_clock isn't, so the timer is set relative
+        // to now; a negative due time is relative, rounded up so the timer never fires before the wheel's event
+        auto const remaining = std::chrono::ceil<file_time_duration>(next.value() - clock::now());
+        LARGE_INTEGER due{};
+        due.QuadPart = -(std::max)(remaining.count(), LONGLONG{1});
+        static_cast<void>(SetWaitableTimer(m_timer.Get(), &due, 0, nullptr, nullptr, FALSE));
+    } else {
+        static_cast<void>(CancelWaitableTimer(m_timer.Get()));
+    }
+    m_armed_for = next;
+}
+
+#endif
+
+void timer_scheduler::on_timer_ready()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_wheel.advance(clock::now(), m_expired);
+        rearm(true);
+        m_dispatching.swap(m_expired);
+    }
+
+    // m_dispatching is only touched on the timer thread so callbacks are free to schedule or cancel
+    for (auto const& expired : m_dispatching)
+        m_on_expired(*expired.target, expired.id);
+    m_dispatching.clear();
+}
+
+timer_scheduler::clock::duration timer_scheduler::relative_to_wheel(clock::duration const delay) const noexcept
+{
+    // the wheel only moves when the timer fires so it can lag behind the real time
+    auto const lag = clock::now() - m_wheel.get_current_time();
+    return delay + (std::max)(lag, clock::duration::zero());
+}
+
+}
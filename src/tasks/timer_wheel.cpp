@@ -0,0 +1,284 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/timer_wheel.h>
+#include <bit>
+#include <stdexcept>
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace tasks
+{
+
+namespace
+{
+    constexpr uint64_t BITS_PER_LEVEL = 6U;
+    constexpr uint64_t SLOT_MASK = timer_wheel::SLOTS - 1U;
+    // a deadline less than 2^36 ticks away can still differ from the current tick in bit 36 once a carry
+    // is involved, the top level exists to absorb that so the usable range is one level short of the wheel
+    constexpr uint64_t MAXIMUM_TICKS = uint64_t{1} << (BITS_PER_LEVEL * (timer_wheel::LEVELS - 1U));
+
+    constexpr uint64_t slots_above(size_t const index) noexcept
+    {
+        return index + 1U >= timer_wheel::SLOTS
+            ? 0U
+            : ~uint64_t{0} << (index + 1U);
+    }
+}
+
+timer_id timer_wheel::schedule_once(task& target, clock::duration const delay)
+{
+    return add(target, m_current + to_ticks(delay, true), 0U);
+}
+
+timer_id timer_wheel::schedule_periodic(task& target, clock::duration const period, optional<clock::duration> const initial_delay)
+{
+    auto const period_ticks = to_ticks(period, false);
+    return add(target, m_current + to_ticks(initial_delay.value_or(period), true), period_ticks);
+}
+
+bool timer_wheel::cancel(timer_id const& id) noexcept
+{
+    if (!is_scheduled(id))
+        return false;
+
+    unlink(id.index);
+    release(id.index);
+    return true;
+}
+
+bool timer_wheel::is_scheduled(timer_id const& id) const noexcept
+{
+    return id.index < m_nodes.size() &&
+        m_nodes[id.index].active &&
+        m_nodes[id.index].generation == id.generation;
+}
+
+size_t timer_wheel::advance(clock::time_point const now, vector<expiration>& expired)
+{
+    auto const target = tick_at(now);
+    size_t fired{};
+
+    while (m_current < target) {
+        auto const next = next_event_tick();
+        if (!next.has_value() || next.value() > target) {
+            // nothing expires or cascades in between so the intermediate ticks can be skipped
+            m_current = target;
+            break;
+        }
+
+        m_current = next.value();
+        for (auto level_index = LEVELS - 1; level_index > 0; --level_index) {
+            auto const lower_bits = BITS_PER_LEVEL * level_index;
+            if ((m_current & ((uint64_t{1} << lower_bits) - 1U)) == 0U)
+                cascade(level_index, static_cast<size_t>((m_current >> lower_bits) & SLOT_MASK));
+        }
+
+        auto& ground = m_levels[0];
+        auto const slot = static_cast<size_t>(m_current & SLOT_MASK);
+        while (ground.heads[slot] != NONE) {
+            auto const index = ground.heads[slot];
+            auto& expiring = m_nodes[index];
+            unlink(index);
+
+            expired.push_back(expiration{expiring.target, timer_id{index, expiring.generation}});
+            ++fired;
+
+            if (expiring.period == 0U) {
+                release(index);
+                continue;
+            }
+
+            // catch up on periods missed by the time being advanced to rather than firing once for each of them
+            auto const overdue = target - expiring.deadline;
+            expiring.deadline += expiring.period * (overdue / expiring.period + 1U);
+            insert(index);
+        }
+    }
+    return fired;
+}
+
+optional<timer_wheel::clock::time_point> timer_wheel::get_next_expiry() const noexcept
+{
+    auto const next = next_event_tick();
+    if (!next.has_value())
+        return nullopt;
+    return m_origin + m_resolution * static_cast<clock::rep>(next.value());
+}
+
+timer_wheel::clock::time_point timer_wheel::get_current_time() const noexcept
+{
+    return m_origin + m_resolution * static_cast<clock::rep>(m_current);
+}
+
+size_t timer_wheel::size() const noexcept
+{
+    return m_active;
+}
+
+timer_wheel::clock::duration timer_wheel::get_resolution() const noexcept
+{
+    return m_resolution;
+}
+
+timer_wheel::clock::duration timer_wheel::get_maximum_delay() const noexcept
+{
+    return m_resolution * static_cast<clock::rep>(MAXIMUM_TICKS - 1U);
+}
+
+timer_wheel::timer_wheel(clock::duration const resolution, clock::time_point const origin)
+    : m_resolution{resolution}
+    , m_origin{origin}
+{
+    if (resolution <= clock::duration::zero())
+        throw std::invalid_argument("resolution must be positive");
+
+    for (auto& current : m_levels)
+        current.heads.fill(NONE);
+}
+
+timer_id timer_wheel::add(task& target, uint64_t const deadline, uint64_t const period)
+{
+    if (deadline - m_current >= MAXIMUM_TICKS)
+        throw std::out_of_range("deadline exceeds the range of the timer wheel");
+
+    uint32_t index{};
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_free.reserve(m_nodes.size());
+    }
+
+    auto& added = m_nodes[index];
+    added.target = &target;
+    added.deadline = deadline;
+    added.period = period;
+    added.active = true;
+    insert(index);
+    ++m_active;
+    return timer_id{index, added.generation};
+}
+
+void timer_wheel::insert(uint32_t const index) noexcept
+{
+    auto& inserted = m_nodes[index];
+
+    // the level is chosen by the highest 6 bit group in which the deadline differs from now, the deadline
+    // then agrees with m_current on every higher group so the slot is reached before that level wraps
+    auto const difference = inserted.deadline ^ m_current;
+    auto const level_index = difference == 0U
+        ? size_t{0}
+        : static_cast<size_t>((std::bit_width(difference) - 1U) / BITS_PER_LEVEL);
+    auto const slot = static_cast<size_t>((inserted.deadline >> (BITS_PER_LEVEL * level_index)) & SLOT_MASK);
+
+    auto& destination = m_levels[level_index];
+    inserted.level = static_cast<std::uint8_t>(level_index);
+    inserted.slot = static_cast<std::uint8_t>(slot);
+    inserted.previous = NONE;
+    inserted.next = destination.heads[slot];
+    if (inserted.next != NONE)
+        m_nodes[inserted.next].previous = index;
+    destination.heads[slot] = index;
+    destination.occupied |= uint64_t{1} << slot;
+}
+
+void timer_wheel::unlink(uint32_t const index) noexcept
+{
+    auto& removed = m_nodes[index];
+    auto& source = m_levels[removed.level];
+
+    if (removed.previous != NONE)
+        m_nodes[removed.previous].next = removed.next;
+    else
+        source.heads[removed.slot] = removed.next;
+    if (removed.next != NONE)
+        m_nodes[removed.next].previous = removed.previous;
+
+    if (source.heads[removed.slot] == NONE)
+        source.occupied &= ~(uint64_t{1} << removed.slot);
+
+    removed.previous = NONE;
+    removed.next = NONE;
+}
+
+void timer_wheel::release(uint32_t const index) noexcept
+{
+    auto& released = m_nodes[index];
+    released.active = false;
+    released.target = nullptr;
+    ++released.generation;
+    --m_active;
+    m_free.push_back(index);
+}
+
+void timer_wheel::cascade(size_t const level_index, size_t const slot) noexcept
+{
+    auto& source = m_levels[level_index];
+    while (source.heads[slot] != NONE) {
+        auto const index = source.heads[slot];
+        unlink(index);
+        insert(index);
+    }
+}
+
+optional<uint64_t> timer_wheel::next_event_tick() const noexcept
+{
+    // every timer on a level sits in a slot after the current one, and anything on a lower level comes before
+    // the next slot of a higher one, so the first occupied slot found bottom up is the earliest event
+    for (size_t level_index = 0; level_index < LEVELS; ++level_index) {
+        auto const lower_bits = BITS_PER_LEVEL * level_index;
+        auto const current_slot = static_cast<size_t>((m_current >> lower_bits) & SLOT_MASK);
+        auto const pending = m_levels[level_index].occupied & slots_above(current_slot);
+        if (pending == 0U)
+            continue;
+
+        auto const slot = static_cast<uint64_t>(std::countr_zero(pending));
+        auto const upper_bits = lower_bits + BITS_PER_LEVEL;
+        auto const base = upper_bits >= 64U ? 0U : (m_current >> upper_bits) << upper_bits;
+        return base | (slot << lower_bits);
+    }
+    return nullopt;
+}
+
+uint64_t timer_wheel::to_ticks(clock::duration const delay, bool const round_up) const
+{
+    if (delay > get_maximum_delay())
+        throw std::out_of_range("delay exceeds the range of the timer wheel");
+    if (delay <= clock::duration::zero())
+        return 1U;
+
+    auto const ticks = static_cast<uint64_t>(delay / m_resolution);
+    auto const remainder = delay % m_resolution;
+    auto const rounded = round_up && remainder != clock::duration::zero()
+        ? ticks + 1U
+        : ticks;
+    return std::max<uint64_t>(rounded, 1U);
+}
+
+uint64_t timer_wheel::tick_at(clock::time_point const time) const noexcept
+{
+    if (time <= m_origin)
+        return 0U;
+    return static_cast<uint64_t>((time - m_origin) / m_resolution);
+}
+
+}
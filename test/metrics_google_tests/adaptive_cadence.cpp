@@ -0,0 +1,137 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <metrics/adaptive_cadence.h>
+#include <stdexcept>
+
+using metrics::adaptive_cadence;
+using metrics::cadence_decision;
+using std::chrono::seconds;
+
+namespace metrics::adaptive_cadence_tests
+{
+
+namespace
+{
+    constexpr std::uint64_t MiB = 1024U * 1024U;
+
+    /// <summary>one sample a second starting at bytes and growing by growth each second</summary>
+    cadence_decision feed(adaptive_cadence& cadence, adaptive_cadence::clock::time_point& now, std::size_t const samples, std::uint64_t& bytes, std::uint64_t const growth)
+    {
+        cadence_decision decision{};
+        for (std::size_t index = 0; index < samples; ++index) {
+            now += seconds(1);
+            bytes += growth;
+            decision = cadence.add(now, bytes);
+        }
+        return decision;
+    }
+}
+
+TEST(adaptive_cadence, starts_at_minimum)
+{
+    adaptive_cadence const cadence(seconds(10), seconds(600));
+
+    ASSERT_EQ(seconds(10), cadence.get_interval());
+}
+
+TEST(adaptive_cadence, idle_process_relaxes_to_maximum)
+{
+    // arrange
+    adaptive_cadence cadence(seconds(10), seconds(600));
+    adaptive_cadence::clock::time_point now{};
+    std::uint64_t bytes = 100U * MiB;
+
+    // Act
+    auto const decision = feed(cadence, now, 20U, bytes, 0U);
+
+    // Assert
+    ASSERT_EQ(seconds(600), decision.interval);
+    ASSERT_EQ(seconds(600), cadence.get_interval());
+    ASSERT_FALSE(decision.snapshot_now);
+}
+
+TEST(adaptive_cadence, growing_process_tightens_to_minimum)
+{
+    // arrange
+    adaptive_cadence cadence(seconds(10), seconds(600));
+    adaptive_cadence::clock::time_point now{};
+    std::uint64_t bytes = 100U * MiB;
+    static_cast<void>(feed(cadence, now, 20U, bytes, 0U));
+
+    // Act
+    auto const decision = feed(cadence, now, 20U, bytes, 64U * 1024U);
+
+    // Assert
+    ASSERT_EQ(seconds(10), decision.interval);
+    ASSERT_FALSE(decision.snapshot_now);
+    ASSERT_NEAR(64.0 * 1024.0, cadence.get_slope().value(), 1.0);
+}
+
+TEST(adaptive_cadence, moderate_growth_holds_interval)
+{
+    // arrange
+    adaptive_cadence cadence(seconds(10), seconds(600));
+    adaptive_cadence::clock::time_point now{};
+    std::uint64_t bytes = 100U * MiB;
+    static_cast<void>(feed(cadence, now, 3U, bytes, 0U));
+    auto const before = cadence.get_interval();
+
+    // Act
+    auto const decision = feed(cadence, now, 20U, bytes, 4U * 1024U);
+
+    // Assert
+    ASSERT_FALSE(decision.changed);
+    ASSERT_EQ(before, decision.interval);
+}
+
+TEST(adaptive_cadence, spike_requests_snapshot_now)
+{
+    // arrange
+    adaptive_cadence cadence(seconds(10), seconds(600));
+    adaptive_cadence::clock::time_point now{};
+    std::uint64_t bytes = 100U * MiB;
+    static_cast<void>(feed(cadence, now, 20U, bytes, 0U));
+
+    // Act
+    auto const decision = feed(cadence, now, 1U, bytes, 50U * MiB);
+
+    // Assert
+    ASSERT_TRUE(decision.snapshot_now);
+    ASSERT_TRUE(decision.changed);
+    ASSERT_EQ(seconds(10), decision.interval);
+}
+
+TEST(adaptive_cadence, small_jump_in_small_process_is_not_a_spike)
+{
+    // arrange
+    adaptive_cadence cadence(seconds(10), seconds(600));
+    adaptive_cadence::clock::time_point now{};
+    std::uint64_t bytes = 4U * MiB;
+    static_cast<void>(feed(cadence, now, 20U, bytes, 0U));
+
+    // Act
+    auto const decision = feed(cadence, now, 1U, bytes, 4U * MiB);
+
+    // Assert
+    ASSERT_FALSE(decision.snapshot_now);
+}
+
+TEST(adaptive_cadence, invalid_bounds_throw_invalid_argument)
+{
+    ASSERT_THROW(adaptive_cadence(seconds(0), seconds(10)), std::invalid_argument);
+    ASSERT_THROW(adaptive_cadence(seconds(10), seconds(5)), std::invalid_argument);
+}
+
+}
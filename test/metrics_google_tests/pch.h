@@ -0,0 +1,15 @@
+//
+// pch.h
+// Header for standard system include files.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
@@ -0,0 +1,213 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <metrics/time_series.h>
+#include <bit>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+
+using metrics::sample;
+using metrics::time_series;
+using std::int64_t;
+using std::vector;
+
+namespace metrics::time_series_tests
+{
+
+namespace
+{
+    vector<sample> read_all(time_series const& series)
+    {
+        vector<sample> samples{};
+        series.read(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), samples);
+        return samples;
+    }
+
+    // resident set size which grows by a few pages every so often, as most long running processes do
+    vector<sample> make_resident_set(int64_t const start, std::size_t const count, unsigned int const seed)
+    {
+        std::mt19937 generator(seed);
+        std::bernoulli_distribution changes(0.05);
+        std::uniform_int_distribution<int> pages(-16, 64);
+        vector<sample> samples{};
+        samples.reserve(count);
+        auto value = 64.0 * 1024.0 * 1024.0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (changes(generator))
+                value += 4096.0 * pages(generator);
+            samples.push_back(sample{start + static_cast<int64_t>(i), value});
+        }
+        return samples;
+    }
+}
+
+TEST(time_series, empty_series_has_no_samples)
+{
+    time_series const series{};
+
+    ASSERT_EQ(0U, series.size());
+    ASSERT_FALSE(series.get_last().has_value());
+    ASSERT_TRUE(read_all(series).empty());
+}
+
+TEST(time_series, round_trips_irregular_timestamps_and_values)
+{
+    // arrange
+    time_series series{};
+    vector<sample> const expected{
+        {1'600'000'000, 0.0},
+        {1'600'000'001, 1.5},
+        {1'600'000'002, 1.5},
+        {1'600'000'002, -1.5},
+        {1'600'000'050, std::numeric_limits<double>::max()},
+        {1'600'000'300, std::numeric_limits<double>::denorm_min()},
+        {1'600'003'000, -0.0},
+        {1'600'003'001, std::numeric_limits<double>::infinity()},
+        {3'200'000'000'000, 42.0},
+    };
+
+    // Act
+    for (auto const& taken : expected)
+        ASSERT_TRUE(series.append(taken.timestamp, taken.value));
+    auto const actual = read_all(series);
+
+    // Assert
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i].timestamp, actual[i].timestamp);
+        ASSERT_EQ(std::bit_cast<std::uint64_t>(expected[i].value), std::bit_cast<std::uint64_t>(actual[i].value));
+    }
+}
+
+TEST(time_series, rejects_timestamps_before_the_last)
+{
+    time_series series{};
+    ASSERT_TRUE(series.append(10, 1.0));
+
+    ASSERT_FALSE(series.append(9, 2.0));
+    ASSERT_EQ(1U, series.size());
+}
+
+TEST(time_series, round_trips_across_many_blocks)
+{
+    // arrange
+    time_series series{};
+    std::mt19937 generator(7U);
+    std::uniform_real_distribution<double> noise(0.0, 100.0);
+    vector<sample> expected{};
+    for (int64_t i = 0; i < 20'000; ++i)
+        expected.push_back(sample{i * 5 + (i % 3), noise(generator)});
+
+    // Act
+    for (auto const& taken : expected)
+        ASSERT_TRUE(series.append(taken.timestamp, taken.value));
+    auto const actual = read_all(series);
+
+    // Assert
+    ASSERT_GT(series.get_memory_usage(), 10U * time_series::BLOCK_SIZE);
+    ASSERT_EQ(expected.size(), series.size());
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i].timestamp, actual[i].timestamp);
+        ASSERT_EQ(expected[i].value, actual[i].value);
+    }
+    ASSERT_EQ(expected.back().timestamp, series.get_last().value().timestamp);
+    ASSERT_EQ(expected.back().value, series.get_last().value().value);
+}
+
+TEST(time_series, read_returns_only_the_requested_range)
+{
+    // arrange
+    time_series series{};
+    for (int64_t i = 0; i < 100'000; ++i)
+        ASSERT_TRUE(series.append(i, static_cast<double>(i)));
+    vector<sample> samples{};
+
+    // Act
+    series.read(50'000, 50'009, samples);
+
+    // Assert
+    ASSERT_EQ(10U, samples.size());
+    ASSERT_EQ(50'000, samples.front().timestamp);
+    ASSERT_EQ(50'009, samples.back().timestamp);
+    ASSERT_EQ(50'009.0, samples.back().value);
+}
+
+TEST(time_series, one_second_resident_set_samples_cost_under_half_a_byte_each)
+{
+    // arrange
+    constexpr std::size_t WEEK = 7U * 24U * 60U * 60U;
+    auto const samples = make_resident_set(1'600'000'000, WEEK, 11U);
+    time_series series{};
+
+    // Act
+    for (auto const& taken : samples)
+        ASSERT_TRUE(series.append(taken.timestamp, taken.value));
+
+    // Assert
+    ASSERT_LT(static_cast<double>(series.get_memory_usage()) / static_cast<double>(WEEK), 0.5);
+    ASSERT_EQ(samples.back().value, series.get_last().value().value);
+}
+
+TEST(time_series, readers_see_a_consistent_prefix_while_appending)
+{
+    // arrange
+    constexpr int64_t COUNT = 200'000;
+    time_series series{};
+    std::atomic<bool> done{};
+    std::atomic<bool> consistent{true};
+
+    // Act
+    std::thread reader([&series, &done, &consistent]() {
+        while (!done.load()) {
+            vector<sample> samples{};
+            series.read(0, COUNT, samples);
+            for (std::size_t i = 0; i < samples.size(); ++i)
+                if (samples[i].timestamp != static_cast<int64_t>(i) || samples[i].value != static_cast<double>(i) * 0.25)
+                    consistent.store(false);
+        }
+    });
+    for (int64_t i = 0; i < COUNT; ++i)
+        ASSERT_TRUE(series.append(i, static_cast<double>(i) * 0.25));
+    done.store(true);
+    reader.join();
+
+    // Assert
+    ASSERT_TRUE(consistent.load());
+    ASSERT_EQ(static_cast<std::size_t>(COUNT), read_all(series).size());
+}
+
+TEST(time_series, DISABLED_benchmark_append_and_read)
+{
+    constexpr std::size_t WEEK = 7U * 24U * 60U * 60U;
+    auto const samples = make_resident_set(1'600'000'000, WEEK, 3U);
+    time_series series{};
+
+    auto const start = std::chrono::steady_clock::now();
+    for (auto const& taken : samples)
+        static_cast<void>(series.append(taken.timestamp, taken.value));
+    auto const appended = std::chrono::steady_clock::now();
+    auto const read = read_all(series);
+    auto const finished = std::chrono::steady_clock::now();
+
+    std::cout << "appended " << WEEK << " samples in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(appended - start).count() << "ms, read in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(finished - appended).count() << "ms, "
+        << static_cast<double>(series.get_memory_usage()) / static_cast<double>(WEEK) << " bytes per sample" << std::endl;
+    ASSERT_EQ(WEEK, read.size());
+}
+
+}
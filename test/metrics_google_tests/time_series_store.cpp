@@ -0,0 +1,117 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <metrics/time_series_store.h>
+
+using metrics::series_key;
+using metrics::time_series_store;
+
+namespace metrics::time_series_store_tests
+{
+
+TEST(time_series_store, get_or_add_returns_the_same_series_for_a_key)
+{
+    // arrange
+    time_series_store store{};
+
+    // Act
+    auto& first = store.get_or_add(series_key{42U, "rss"});
+    auto& second = store.get_or_add(series_key{42U, "rss"});
+    auto& other = store.get_or_add(series_key{42U, "cpu"});
+
+    // Assert
+    ASSERT_EQ(&first, &second);
+    ASSERT_NE(&first, &other);
+    ASSERT_EQ(2U, store.size());
+}
+
+TEST(time_series_store, find_returns_null_for_unknown_key)
+{
+    time_series_store store{};
+    static_cast<void>(store.get_or_add(series_key{1U, "rss"}));
+
+    ASSERT_EQ(nullptr, store.find(series_key{2U, "rss"}));
+    ASSERT_NE(nullptr, store.find(series_key{1U, "rss"}));
+}
+
+TEST(time_series_store, memory_usage_includes_every_series)
+{
+    // arrange
+    time_series_store store{};
+    auto& rss = store.get_or_add(series_key{1U, "rss"});
+    auto& handles = store.get_or_add(series_key{1U, "handles"});
+
+    // Act
+    ASSERT_TRUE(rss.append(1, 1.0));
+    ASSERT_TRUE(handles.append(1, 1.0));
+
+    // Assert
+    ASSERT_GE(store.get_memory_usage(), rss.get_memory_usage() + handles.get_memory_usage());
+    ASSERT_EQ(2U, store.get_keys().size());
+}
+
+TEST(time_series_store, remove_drops_only_the_given_series)
+{
+    // arrange
+    time_series_store store{};
+    static_cast<void>(store.get_or_add(series_key{1U, "rss"}));
+    static_cast<void>(store.get_or_add(series_key{1U, "cpu"}));
+
+    // Act
+    auto const removed = store.remove(series_key{1U, "rss"});
+    auto const removed_again = store.remove(series_key{1U, "rss"});
+
+    // Assert
+    ASSERT_TRUE(removed);
+    ASSERT_FALSE(removed_again);
+    ASSERT_EQ(nullptr, store.find(series_key{1U, "rss"}));
+    ASSERT_NE(nullptr, store.find(series_key{1U, "cpu"}));
+}
+
+TEST(time_series_store, remove_process_drops_every_series_of_the_process)
+{
+    // arrange
+    time_series_store store{};
+    static_cast<void>(store.get_or_add(series_key{1U, "rss"}));
+    static_cast<void>(store.get_or_add(series_key{1U, "cpu"}));
+    static_cast<void>(store.get_or_add(series_key{2U, "rss"}));
+
+    // Act
+    auto const removed = store.remove_process(1U);
+
+    // Assert
+    ASSERT_EQ(2U, removed);
+    ASSERT_EQ(1U, store.size());
+    ASSERT_NE(nullptr, store.find(series_key{2U, "rss"}));
+}
+
+TEST(time_series_store, remove_idle_drops_series_not_appended_to_since)
+{
+    // arrange
+    time_series_store store{};
+    ASSERT_TRUE(store.get_or_add(series_key{1U, "rss"}).append(10, 1.0));
+    ASSERT_TRUE(store.get_or_add(series_key{2U, "rss"}).append(100, 1.0));
+    static_cast<void>(store.get_or_add(series_key{3U, "rss"}));
+
+    // Act
+    auto const removed = store.remove_idle(50);
+
+    // Assert
+    ASSERT_EQ(1U, removed);
+    ASSERT_EQ(nullptr, store.find(series_key{1U, "rss"}));
+    ASSERT_NE(nullptr, store.find(series_key{2U, "rss"}));
+    ASSERT_NE(nullptr, store.find(series_key{3U, "rss"}));
+}
+
+}
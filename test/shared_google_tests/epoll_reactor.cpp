@@ -0,0 +1,148 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#if defined(__linux__)
+
+#include <thread>
+#include <shared/epoll_reactor.h>
+#include <shared/eventfd.h>
+#include <shared/timerfd.h>
+
+using std::chrono::milliseconds;
+using std::uint32_t;
+using std::uint64_t;
+
+using shared::infrastructure::epoll_reactor;
+using shared::infrastructure::make_eventfd;
+using shared::infrastructure::make_timerfd;
+using shared::infrastructure::posix_fd;
+
+namespace shared::epoll_reactor_tests
+{
+
+void signal(int const fd)
+{
+    uint64_t const one{1U};
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(one)), ::write(fd, &one, sizeof(one)));
+}
+
+TEST(epoll_reactor, dispatches_ready_descriptor)
+{
+    // arrange
+    epoll_reactor reactor{};
+    auto calls = 0;
+    auto const id = reactor.add(make_eventfd(), EPOLLIN, [&calls](int const fd, uint32_t) {
+        uint64_t value{};
+        static_cast<void>(::read(fd, &value, sizeof(value)));
+        ++calls;
+    });
+    ASSERT_TRUE(id.has_value());
+    signal(reactor.get_descriptor(id.value()).value());
+
+    // Act
+    auto const dispatched = reactor.run_once(milliseconds(100));
+
+    // Assert
+    ASSERT_EQ(1U, dispatched);
+    ASSERT_EQ(1, calls);
+}
+
+TEST(epoll_reactor, invalid_handle_is_rejected)
+{
+    epoll_reactor reactor{};
+
+    auto const id = reactor.add(posix_fd(), EPOLLIN, [](int, uint32_t) {});
+
+    ASSERT_FALSE(id.has_value());
+    ASSERT_EQ(0U, reactor.size());
+}
+
+TEST(epoll_reactor, removed_registration_is_stale)
+{
+    // arrange
+    epoll_reactor reactor{};
+    auto const id = reactor.add(make_eventfd(), EPOLLIN, [](int, uint32_t) {}).value();
+
+    // Act
+    auto const removed = reactor.remove(id);
+
+    // Assert
+    ASSERT_TRUE(removed);
+    ASSERT_FALSE(reactor.get_descriptor(id).has_value());
+    ASSERT_FALSE(reactor.remove(id));
+    ASSERT_EQ(0U, reactor.size());
+}
+
+TEST(epoll_reactor, callback_may_remove_itself)
+{
+    // arrange
+    epoll_reactor reactor{};
+    epoll_reactor::registration id{};
+    auto calls = 0;
+    id = reactor.add(make_eventfd(), EPOLLIN, [&reactor, &id, &calls](int, uint32_t) {
+        ++calls;
+        reactor.remove(id);
+    }).value();
+    signal(reactor.get_descriptor(id).value());
+
+    // Act
+    reactor.run_once(milliseconds(100));
+    auto const second = reactor.run_once(milliseconds(10));
+
+    // Assert
+    ASSERT_EQ(1, calls);
+    ASSERT_EQ(0U, second);
+    ASSERT_EQ(0U, reactor.size());
+}
+
+TEST(epoll_reactor, timerfd_fires)
+{
+    // arrange
+    epoll_reactor reactor{};
+    auto timer = make_timerfd();
+    itimerspec const expiry{{0, 0}, {0, 1'000'000}};
+    ASSERT_EQ(0, ::timerfd_settime(timer.Get(), 0, &expiry, nullptr));
+    auto fired = false;
+    static_cast<void>(reactor.add(std::move(timer), EPOLLIN, [&fired, &reactor](int const fd, uint32_t) {
+        uint64_t expirations{};
+        static_cast<void>(::read(fd, &expirations, sizeof(expirations)));
+        fired = true;
+        reactor.stop();
+    }));
+
+    // Act
+    reactor.run();
+
+    // Assert
+    ASSERT_TRUE(fired);
+}
+
+TEST(epoll_reactor, stop_from_other_thread_ends_run)
+{
+    epoll_reactor reactor{};
+    std::thread stopper([&reactor]() {
+        std::this_thread::sleep_for(milliseconds(10));
+        reactor.stop();
+    });
+
+    reactor.run();
+
+    stopper.join();
+    SUCCEED();
+}
+
+}
+
+#endif
@@ -13,6 +13,7 @@
 
 #include "pch.h"
 #include <process_service_impl.h>
+#include <algorithm>
 #include <chrono>
 
 using std::chrono::duration;
@@ -29,6 +30,8 @@ using std::literals::string_literals::operator ""s;
 namespace Shared::ProcessServiceTests
 {
 
+#if defined(_WIN32)
+
 TEST(process_service, start_throws_when_file_not_found)
 {
     auto const service = make_unique_process_service();
@@ -100,6 +103,21 @@ TEST(process_service, waits_for_process_to_end)
     ASSERT_GE(duration<double>(end - start).count(), 1.0);
 }
 
+TEST(process_service, terminate_ends_running_process_with_exit_code)
+{
+    // arrange
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(CommandExe, "/c ping -n 30 127.0.0.1");
+
+    // Act
+    auto const terminated = process->terminate(7UL);
+    process->wait_for_exit();
+
+    // Assert
+    ASSERT_TRUE(terminated);
+    ASSERT_EQ(7UL, process->exit_code().value());
+}
+
 
 TEST(process_service, ProcessByNameFindsMatch)
 {
@@ -153,4 +171,106 @@ TEST(process_service, get_path_from_running_path_returns_correct_path)
     ASSERT_EQ(expected, path);
 }
 
+#elif defined(__linux__)
+
+constexpr auto const SleepExe = "/bin/sleep";
+
+TEST(process_service, start_returns_running_child)
+{
+    // arrange
+    auto const service = make_unique_process_service();
+
+    // Act
+    auto const process = service->start_process(SleepExe, "5");
+
+    // Assert
+    ASSERT_NE(process, nullptr);
+    ASSERT_TRUE(process->is_running());
+    ASSERT_FALSE(process->exit_code().has_value());
+    process->terminate(0UL);
+}
+
+TEST(process_service, exit_code_reported_once_child_exits)
+{
+    // arrange
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "not-a-number");
+
+    // Act
+    process->wait_for_exit();
+
+    // Assert
+    ASSERT_FALSE(process->is_running());
+    ASSERT_TRUE(process->exit_code().has_value());
+    ASSERT_NE(0UL, process->exit_code().value());
+}
+
+TEST(process_service, terminate_kills_running_child)
+{
+    // arrange
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "30");
+
+    // Act
+    auto const terminated = process->terminate(0UL);
+    process->wait_for_exit();
+
+    // Assert
+    ASSERT_TRUE(terminated);
+    ASSERT_FALSE(process->is_running());
+}
+
+TEST(process_service, get_processes_by_name_finds_child_by_executable_name)
+{
+    // arrange
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "5");
+
+    // Act
+    auto const matchingProcesses = service->get_processes_by_name("sleep");
+
+    // Assert
+    auto const found = std::any_of(matchingProcesses.begin(), matchingProcesses.end(),
+        [&process](auto const& match) { return match->get_id() == process->get_id(); });
+    process->terminate(0UL);
+    ASSERT_TRUE(found);
+}
+
+TEST(process_service, get_process_by_id_opens_running_process)
+{
+    // arrange
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "5");
+
+    // Act
+    auto const opened = service->get_process_by_id(process->get_id());
+
+    // Assert
+    ASSERT_NE(opened, nullptr);
+    ASSERT_TRUE(opened->is_running());
+    process->terminate(0UL);
+    opened->wait_for_exit();
+    ASSERT_FALSE(opened->is_running());
+}
+
+TEST(process_service, private_bytes_reported_until_child_exits)
+{
+    // arrange
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "5");
+
+    // Act
+    auto const running = process->get_private_bytes();
+    process->terminate(0UL);
+    process->wait_for_exit();
+    static_cast<void>(process->is_running());
+
+    // Assert
+    ASSERT_TRUE(running.has_value());
+    ASSERT_GT(running.value(), 0U);
+    ASSERT_FALSE(process->get_private_bytes().has_value());
+}
+
+#endif
+
 }
@@ -0,0 +1,68 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/arena.h>
+#include <cstdint>
+#include <stdexcept>
+
+using snapshot::arena;
+
+namespace snapshot::arena_tests
+{
+
+TEST(arena, allocations_are_aligned_and_distinct)
+{
+    // arrange
+    arena memory(64U);
+
+    // Act
+    auto* const first = memory.allocate(3U, 1U);
+    auto* const second = memory.allocate_array<std::uint64_t>(2U);
+
+    // Assert
+    ASSERT_NE(static_cast<void*>(first), static_cast<void*>(second));
+    ASSERT_EQ(0U, reinterpret_cast<std::uintptr_t>(second) % alignof(std::uint64_t));
+}
+
+TEST(arena, copies_remain_valid_as_blocks_are_added)
+{
+    // arrange
+    arena memory(16U);
+    auto const first = memory.copy("ntdll!RtlAllocateHeap");
+
+    // Act
+    for (auto i = 0; i < 100; ++i)
+        static_cast<void>(memory.copy("app!main+0000001C"));
+
+    // Assert
+    ASSERT_EQ("ntdll!RtlAllocateHeap", first);
+    ASSERT_GE(memory.get_memory_usage(), 100U * 17U);
+}
+
+TEST(arena, clear_releases_every_block)
+{
+    arena memory(64U);
+    static_cast<void>(memory.copy("content"));
+
+    memory.clear();
+
+    ASSERT_EQ(0U, memory.get_memory_usage());
+}
+
+TEST(arena, zero_block_size_throws_invalid_argument)
+{
+    ASSERT_THROW(arena(0U), std::invalid_argument);
+}
+
+}
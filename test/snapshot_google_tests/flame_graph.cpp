@@ -0,0 +1,283 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/flame_graph.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include "umdh_text.h"
+
+using snapshot::allocation_site;
+using snapshot::diff_snapshots;
+using snapshot::flame_graph;
+using snapshot::heap_snapshot;
+using snapshot::read_heap_snapshot;
+using snapshot::trace_table;
+using snapshot::tests::make_umdh_text;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace snapshot::flame_graph_tests
+{
+
+namespace
+{
+    /// <summary>two stacks sharing main, each allocating through RtlAllocateHeap</summary>
+    heap_snapshot make_snapshot(trace_table& traces, std::uint64_t const widget_bytes, std::uint64_t const cache_bytes)
+    {
+        vector<string_view> const widget{"ntdll!RtlAllocateHeap", "app!widget::create", "app!main"};
+        vector<string_view> const cache{"ntdll!RtlAllocateHeap", "app!cache::insert", "app!main"};
+        return heap_snapshot(vector<allocation_site>{{traces.intern(widget), widget_bytes, 1U}, {traces.intern(cache), cache_bytes, 1U}});
+    }
+
+    vector<string> get_folded_lines(flame_graph const& graph)
+    {
+        std::ostringstream output{};
+        graph.write_folded(output);
+        std::istringstream lines(output.str());
+        vector<string> folded{};
+        for (string line{}; std::getline(lines, line);)
+            folded.push_back(line);
+        std::sort(folded.begin(), folded.end());
+        return folded;
+    }
+
+    heap_snapshot change_some(heap_snapshot const& snapshot, unsigned int const seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        vector<allocation_site> sites{};
+        for (auto site : snapshot.get_sites()) {
+            auto const roll = percent(generator);
+            if (roll < 2)
+                continue;
+            if (roll < 7)
+                site.bytes += 4096U;
+            sites.push_back(site);
+        }
+        return heap_snapshot(std::move(sites));
+    }
+}
+
+TEST(flame_graph, folded_stacks_are_outermost_first)
+{
+    // arrange
+    trace_table traces{};
+    auto const snapshot = make_snapshot(traces, 100U, 50U);
+    flame_graph graph(traces);
+
+    // Act
+    graph.add(snapshot);
+
+    // Assert
+    auto const folded = get_folded_lines(graph);
+    ASSERT_EQ(2U, folded.size());
+    ASSERT_EQ("app!main;app!cache::insert;ntdll!RtlAllocateHeap 50", folded[0]);
+    ASSERT_EQ("app!main;app!widget::create;ntdll!RtlAllocateHeap 100", folded[1]);
+    ASSERT_EQ(150, graph.get_total_bytes());
+    ASSERT_EQ(5U, graph.size());
+}
+
+TEST(flame_graph, json_nests_children_with_inclusive_bytes)
+{
+    // arrange
+    trace_table traces{};
+    auto const snapshot = make_snapshot(traces, 100U, 0U);
+    flame_graph graph(traces);
+    graph.add(snapshot);
+    std::ostringstream output{};
+
+    // Act
+    graph.write_json(output);
+
+    // Assert
+    ASSERT_EQ(R"({"name":"root","value":100,"children":[{"name":"app!main","value":100,"children":[{"name":"app!widget::create","value":100,"children":[{"name":"ntdll!RtlAllocateHeap","value":100}]}]}]})", output.str());
+}
+
+TEST(flame_graph, applying_diffs_matches_a_rebuilt_graph)
+{
+    // arrange
+    auto const text = make_umdh_text(2000U);
+    trace_table traces{};
+    auto const first = read_heap_snapshot(text, traces);
+    auto const second = change_some(first, 1U);
+    auto const third = change_some(second, 2U);
+    flame_graph incremental(traces);
+    incremental.add(first);
+
+    // Act
+    incremental.apply(diff_snapshots(first, second));
+    incremental.apply(diff_snapshots(second, third));
+
+    // Assert
+    flame_graph rebuilt(traces);
+    rebuilt.add(third);
+    ASSERT_EQ(static_cast<std::int64_t>(third.get_total_bytes()), incremental.get_total_bytes());
+    ASSERT_EQ(get_folded_lines(rebuilt), get_folded_lines(incremental));
+}
+
+TEST(flame_graph, growth_graph_writes_only_growth)
+{
+    // arrange
+    trace_table traces{};
+    auto const before = make_snapshot(traces, 100U, 50U);
+    auto const after = make_snapshot(traces, 300U, 10U);
+    flame_graph growth(traces);
+
+    // Act
+    growth.apply(diff_snapshots(before, after));
+
+    // Assert
+    auto const folded = get_folded_lines(growth);
+    ASSERT_EQ(1U, folded.size());
+    ASSERT_EQ("app!main;app!widget::create;ntdll!RtlAllocateHeap 200", folded[0]);
+    ASSERT_EQ(160, growth.get_total_bytes());
+}
+
+TEST(flame_graph, growth_hidden_by_shrinking_siblings_is_written)
+{
+    // arrange
+    trace_table traces{};
+    auto const before = make_snapshot(traces, 100U, 500U);
+    auto const after = make_snapshot(traces, 300U, 200U);
+    flame_graph growth(traces);
+    growth.apply(diff_snapshots(before, after));
+    std::ostringstream output{};
+
+    // Act
+    growth.write_json(output);
+
+    // Assert
+    ASSERT_EQ(-100, growth.get_total_bytes());
+    auto const folded = get_folded_lines(growth);
+    ASSERT_EQ(1U, folded.size());
+    ASSERT_EQ("app!main;app!widget::create;ntdll!RtlAllocateHeap 200", folded[0]);
+    ASSERT_EQ(R"({"name":"root","value":200,"children":[{"name":"app!main","value":200,"children":[{"name":"app!widget::create","value":200,"children":[{"name":"ntdll!RtlAllocateHeap","value":200}]}]}]})", output.str());
+}
+
+TEST(flame_graph, narrow_subtrees_are_left_out)
+{
+    // arrange
+    trace_table traces{};
+    auto const snapshot = make_snapshot(traces, 100U, 5U);
+    flame_graph graph(traces);
+    graph.add(snapshot);
+
+    // Act
+    std::ostringstream output{};
+    graph.write_folded(output, 10);
+
+    // Assert
+    ASSERT_EQ("app!main;app!widget::create;ntdll!RtlAllocateHeap 100\n", output.str());
+}
+
+TEST(flame_graph, trace_without_frames_is_written_as_unknown)
+{
+    // arrange
+    trace_table traces{};
+    auto const empty = traces.intern(std::span<string_view const>());
+    flame_graph graph(traces);
+
+    // Act
+    graph.add(heap_snapshot(vector<allocation_site>{{empty, 40U, 1U}}));
+
+    // Assert
+    auto const folded = get_folded_lines(graph);
+    ASSERT_EQ(1U, folded.size());
+    ASSERT_EQ("[unknown] 40", folded[0]);
+    ASSERT_EQ(40, graph.get_total_bytes());
+}
+
+TEST(flame_graph, folded_frames_cannot_split_the_stack)
+{
+    // arrange
+    trace_table traces{};
+    vector<string_view> const frames{"app!line\nbreak", "app!parse;inline", "app!main"};
+    flame_graph graph(traces);
+
+    // Act
+    graph.add(heap_snapshot(vector<allocation_site>{{traces.intern(frames), 40U, 1U}}));
+
+    // Assert
+    auto const folded = get_folded_lines(graph);
+    ASSERT_EQ(1U, folded.size());
+    ASSERT_EQ("app!main;app!parse_inline;app!line_break 40", folded[0]);
+}
+
+TEST(flame_graph, json_escapes_frame_names)
+{
+    trace_table traces{};
+    vector<string_view> const frames{"app!quote\"back\\slash"};
+    flame_graph graph(traces);
+    graph.add(heap_snapshot(vector<allocation_site>{{traces.intern(frames), 8U, 1U}}));
+    std::ostringstream output{};
+
+    graph.write_json(output);
+
+    ASSERT_NE(string::npos, output.str().find(R"("app!quote\"back\\slash")"));
+}
+
+TEST(flame_graph, top_limited_diff_throws_invalid_argument)
+{
+    trace_table traces{};
+    auto const before = make_snapshot(traces, 100U, 50U);
+    auto const after = make_snapshot(traces, 300U, 10U);
+    flame_graph graph(traces);
+
+    ASSERT_THROW(graph.apply(diff_snapshots(before, after, 1U)), std::invalid_argument);
+}
+
+TEST(flame_graph, DISABLED_benchmark_three_hundred_thousand_stacks)
+{
+    // every frame of make_umdh_text has its own offset so stacks share next to nothing, the worst case for size
+    auto const text = make_umdh_text(300'000U, 1U, 16U);
+    trace_table traces{};
+    auto const first = read_heap_snapshot(text, traces);
+    auto const second = change_some(first, 1U);
+    auto const diff = diff_snapshots(first, second);
+    auto const filename = std::filesystem::temp_directory_path() / "flame_graph_benchmark.out";
+    auto const milliseconds = [](auto const elapsed) { return std::chrono::duration<double, std::milli>(elapsed).count(); };
+
+    auto const start = std::chrono::steady_clock::now();
+    flame_graph graph(traces);
+    graph.add(first);
+    auto const built = std::chrono::steady_clock::now();
+    graph.apply(diff);
+    auto const applied = std::chrono::steady_clock::now();
+    std::cout << first.size() << " stacks in " << graph.size() << " nodes built in " << milliseconds(built - start) << "ms, "
+        << diff.changed_sites << " changes applied in " << milliseconds(applied - built) << "ms" << std::endl;
+
+    std::ofstream folded(filename, std::ios::binary | std::ios::trunc);
+    graph.write_folded(folded);
+    auto const folded_at = std::chrono::steady_clock::now();
+    auto const folded_size = folded.tellp();
+    folded.close();
+
+    std::ofstream json(filename, std::ios::binary | std::ios::trunc);
+    graph.write_json(json);
+    auto const json_at = std::chrono::steady_clock::now();
+    std::cout << folded_size << " bytes folded in " << milliseconds(folded_at - applied) << "ms, "
+        << json.tellp() << " bytes of json in " << milliseconds(json_at - folded_at) << "ms" << std::endl;
+    json.close();
+    std::filesystem::remove(filename);
+}
+
+}
@@ -0,0 +1,58 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/heap_snapshot.h>
+#include "umdh_text.h"
+
+using snapshot::allocation_site;
+using snapshot::heap_snapshot;
+using snapshot::read_heap_snapshot;
+using snapshot::trace_table;
+using snapshot::tests::make_umdh_text;
+using std::vector;
+
+namespace snapshot::heap_snapshot_tests
+{
+
+TEST(heap_snapshot, sites_are_ordered_and_merged_by_trace)
+{
+    // arrange
+    vector<allocation_site> const sites{{3U, 30U, 3U}, {1U, 10U, 1U}, {3U, 5U, 1U}};
+
+    // Act
+    heap_snapshot const snapshot(sites);
+
+    // Assert
+    ASSERT_EQ(2U, snapshot.size());
+    ASSERT_EQ((allocation_site{1U, 10U, 1U}), snapshot.get_sites()[0]);
+    ASSERT_EQ((allocation_site{3U, 35U, 4U}), snapshot.get_sites()[1]);
+    ASSERT_EQ(45U, snapshot.get_total_bytes());
+    ASSERT_EQ(5U, snapshot.get_total_count());
+}
+
+TEST(heap_snapshot, read_interns_every_record)
+{
+    // arrange
+    auto const text = make_umdh_text(100U);
+    trace_table traces{};
+
+    // Act
+    auto const snapshot = read_heap_snapshot(text, traces);
+
+    // Assert
+    ASSERT_EQ(100U, snapshot.size());
+    ASSERT_EQ(100U, traces.size());
+}
+
+}
@@ -0,0 +1,80 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/mapped_file.h>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+using snapshot::mapped_file;
+using std::filesystem::path;
+
+namespace snapshot::mapped_file_tests
+{
+
+namespace
+{
+    path write_file(std::string const& name, std::string const& content)
+    {
+        auto const filename = std::filesystem::temp_directory_path() / name;
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        file << content;
+        return filename;
+    }
+}
+
+TEST(mapped_file, view_matches_file_content)
+{
+    // arrange
+    auto const filename = write_file("mapped_file_view.txt", "00000010 bytes + 00000010 at 00C7A5D8 by BackTrace1\n");
+
+    // Act
+    mapped_file const mapped(filename);
+
+    // Assert
+    ASSERT_EQ("00000010 bytes + 00000010 at 00C7A5D8 by BackTrace1\n", mapped.get_view());
+    std::filesystem::remove(filename);
+}
+
+TEST(mapped_file, empty_file_has_empty_view)
+{
+    auto const filename = write_file("mapped_file_empty.txt", "");
+
+    mapped_file const mapped(filename);
+
+    ASSERT_TRUE(mapped.get_view().empty());
+    std::filesystem::remove(filename);
+}
+
+TEST(mapped_file, missing_file_throws_system_error)
+{
+    ASSERT_THROW(mapped_file(std::filesystem::temp_directory_path() / "mapped_file_missing.txt"), std::system_error);
+}
+
+TEST(mapped_file, move_transfers_the_mapping)
+{
+    // arrange
+    auto const filename = write_file("mapped_file_move.txt", "content");
+    mapped_file original(filename);
+
+    // Act
+    mapped_file const moved(std::move(original));
+
+    // Assert
+    ASSERT_EQ("content", moved.get_view());
+    ASSERT_TRUE(original.get_view().empty());
+    std::filesystem::remove(filename);
+}
+
+}
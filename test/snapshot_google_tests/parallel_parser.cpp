@@ -0,0 +1,144 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/parallel_parser.h>
+#include <iostream>
+#include <numeric>
+#include "umdh_text.h"
+
+using snapshot::allocation_record;
+using snapshot::parse_parallel;
+using snapshot::split_records;
+using snapshot::umdh_reader;
+using snapshot::tests::make_umdh_text;
+using std::string_view;
+using tasks::executor;
+
+namespace snapshot::parallel_parser_tests
+{
+
+namespace
+{
+    struct totals final
+    {
+        std::size_t records{};
+        std::uint64_t bytes{};
+        std::uint64_t backtraces{};
+    };
+
+    void add(totals& result, allocation_record const& record)
+    {
+        ++result.records;
+        result.bytes += record.bytes * record.count;
+        result.backtraces += record.backtrace_id;
+    }
+
+    totals merge(std::vector<totals> const& chunks)
+    {
+        return std::accumulate(chunks.begin(), chunks.end(), totals{}, [](totals merged, totals const& chunk) {
+            merged.records += chunk.records;
+            merged.bytes += chunk.bytes;
+            merged.backtraces += chunk.backtraces;
+            return merged;
+        });
+    }
+
+    totals parse_serial(string_view const& text)
+    {
+        totals result{};
+        umdh_reader reader(text);
+        allocation_record record{};
+        while (reader.next(record))
+            add(result, record);
+        return result;
+    }
+}
+
+TEST(split_records, chunks_cover_text_and_start_on_record_boundaries)
+{
+    // arrange
+    auto const text = make_umdh_text(1'000U);
+
+    // Act
+    auto const chunks = split_records(text, 16U, 1U);
+
+    // Assert
+    ASSERT_EQ(16U, chunks.size());
+    ASSERT_EQ(text.data(), chunks.front().data());
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+        ASSERT_EQ(chunks[i - 1U].data() + chunks[i - 1U].size(), chunks[i].data());
+        ASSERT_EQ('\n', chunks[i - 1U].back());
+        ASSERT_NE(' ', chunks[i].front());
+    }
+    ASSERT_EQ(text.data() + text.size(), chunks.back().data() + chunks.back().size());
+}
+
+TEST(split_records, small_text_is_a_single_chunk)
+{
+    auto const text = make_umdh_text(10U);
+
+    auto const chunks = split_records(text, 16U);
+
+    ASSERT_EQ(1U, chunks.size());
+    ASSERT_EQ(text.size(), chunks.front().size());
+}
+
+TEST(parse_parallel, matches_serial_parse)
+{
+    // arrange
+    auto const text = make_umdh_text(20'000U);
+    auto const expected = parse_serial(text);
+    executor workers(4U);
+
+    // Act
+    auto const chunks = parse_parallel<totals>(workers, text, add);
+    auto const actual = merge(chunks);
+
+    // Assert
+    ASSERT_GT(chunks.size(), 1U);
+    ASSERT_EQ(expected.records, actual.records);
+    ASSERT_EQ(expected.bytes, actual.bytes);
+    ASSERT_EQ(expected.backtraces, actual.backtraces);
+}
+
+TEST(parse_parallel, parses_inline_when_called_from_a_worker)
+{
+    // arrange
+    auto const text = make_umdh_text(20'000U);
+    executor workers(1U);
+
+    // Act
+    auto const actual = workers.submit([&workers, &text]() { return merge(parse_parallel<totals>(workers, text, add)); }).get();
+
+    // Assert
+    ASSERT_EQ(20'000U, actual.records);
+}
+
+TEST(parse_parallel, DISABLED_benchmark_scaling)
+{
+    auto const text = make_umdh_text(4'000'000U);
+    auto const serial = parse_serial(text);
+
+    for (std::size_t workers = 1U; workers <= std::max(std::thread::hardware_concurrency(), 1U); workers *= 2U) {
+        executor pool(workers);
+        auto const start = std::chrono::steady_clock::now();
+        auto const parsed = merge(parse_parallel<totals>(pool, text, add));
+        auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << workers << " workers: " << static_cast<double>(text.size()) / (1024.0 * 1024.0) / elapsed << "MiB/s" << std::endl;
+        ASSERT_EQ(serial.records, parsed.records);
+    }
+}
+
+}
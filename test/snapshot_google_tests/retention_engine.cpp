@@ -0,0 +1,267 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/retention_engine.h>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <snapshot/snapshot_file.h>
+
+using snapshot::allocation_site;
+using snapshot::heap_snapshot;
+using snapshot::retention_engine;
+using snapshot::retention_policy;
+using snapshot::snapshot_file_reader;
+using snapshot::snapshot_file_writer;
+using snapshot::trace_table;
+using std::chrono::hours;
+using std::chrono::minutes;
+using std::chrono::system_clock;
+using std::filesystem::path;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace snapshot::retention_engine_tests
+{
+
+namespace
+{
+    path make_archive(string const& name)
+    {
+        auto const directory = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+
+    /// <summary>a segment with a snapshot at each time, each with a trace of its own and one shared by all</summary>
+    void write_segment(path const& filename, vector<system_clock::time_point> const& times)
+    {
+        trace_table traces{};
+        snapshot_file_writer writer(filename);
+        for (std::size_t index = 0; index < times.size(); ++index) {
+            auto const own = "app!allocate_" + std::to_string(index);
+            vector<string_view> const shared_frames{"ntdll!RtlAllocateHeap", "app!main"};
+            vector<string_view> const own_frames{"ntdll!RtlAllocateHeap", own, "app!main"};
+            vector<allocation_site> const sites{{traces.intern(shared_frames), 100U, 1U}, {traces.intern(own_frames), 10U * (index + 1U), 1U}};
+            writer.append(heap_snapshot(sites), times[index], traces);
+        }
+        writer.close();
+    }
+
+    vector<system_clock::time_point> every(system_clock::time_point const first, minutes const spacing, std::size_t const count)
+    {
+        vector<system_clock::time_point> times{};
+        for (std::size_t index = 0; index < count; ++index)
+            times.push_back(first + spacing * index);
+        return times;
+    }
+
+    system_clock::time_point start_of_day(system_clock::time_point const time)
+    {
+        return std::chrono::floor<std::chrono::days>(time);
+    }
+}
+
+TEST(retention_engine, recent_snapshots_are_kept)
+{
+    // arrange
+    auto const archive = make_archive("retention_recent");
+    auto const now = system_clock::now();
+    write_segment(archive / "0001.snap", every(now - hours(2), minutes(10), 12U));
+    retention_engine engine(archive);
+
+    // Act
+    auto const report = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(1U, report.segments_checked);
+    ASSERT_EQ(0U, report.segments_rewritten);
+    ASSERT_TRUE(report.pass_complete);
+    ASSERT_EQ(12U, snapshot_file_reader(archive / "0001.snap").size());
+}
+
+TEST(retention_engine, older_snapshots_are_thinned_to_hourly)
+{
+    // arrange
+    auto const archive = make_archive("retention_hourly");
+    auto const now = system_clock::now();
+    auto const first = start_of_day(now - hours(72));
+    write_segment(archive / "0001.snap", every(first, minutes(10), 18U));
+    retention_engine engine(archive);
+
+    // Act
+    auto const report = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(1U, report.segments_rewritten);
+    ASSERT_EQ(15U, report.snapshots_removed);
+    snapshot_file_reader const reader(archive / "0001.snap");
+    ASSERT_EQ(3U, reader.size());
+    for (std::size_t index = 0; index < reader.size(); ++index)
+        ASSERT_EQ(first + hours(index), reader.get_info(index).taken_at);
+    // the representative of the second hour is the seventh snapshot, whose own trace was allocate_6
+    ASSERT_EQ(170U, reader.read_snapshot(1U).get_total_bytes());
+    trace_table traces{};
+    reader.read_traces(traces);
+    ASSERT_EQ(4U, traces.size());
+}
+
+TEST(retention_engine, days_spanning_segments_keep_only_their_first_snapshot)
+{
+    // arrange
+    auto const archive = make_archive("retention_daily");
+    auto const now = system_clock::now();
+    auto const first = start_of_day(now - hours(24 * 60));
+    write_segment(archive / "0001.snap", every(first, minutes(30), 2U));
+    write_segment(archive / "0002.snap", every(first + hours(1), minutes(30), 2U));
+    write_segment(archive / "0003.snap", every(first + hours(24), minutes(30), 2U));
+    retention_engine engine(archive);
+
+    // Act
+    auto const report = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(3U, report.segments_checked);
+    ASSERT_EQ(1U, report.segments_removed);
+    ASSERT_EQ(4U, report.snapshots_removed);
+    ASSERT_FALSE(std::filesystem::exists(archive / "0002.snap"));
+    ASSERT_EQ(first, snapshot_file_reader(archive / "0001.snap").get_info(0U).taken_at);
+    ASSERT_EQ(first + hours(24), snapshot_file_reader(archive / "0003.snap").get_info(0U).taken_at);
+}
+
+TEST(retention_engine, work_is_spread_over_ticks)
+{
+    // arrange
+    auto const archive = make_archive("retention_budget");
+    auto const now = system_clock::now();
+    auto const first = start_of_day(now - hours(72));
+    write_segment(archive / "0001.snap", every(first, minutes(10), 6U));
+    write_segment(archive / "0002.snap", every(first + hours(1), minutes(10), 6U));
+    retention_policy policy{};
+    policy.bytes_per_tick = 1U;
+    retention_engine engine(archive, policy);
+
+    // Act
+    auto const first_tick = engine.tick(now);
+    auto const second_tick = engine.tick(now);
+    auto const next_pass = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(1U, first_tick.segments_rewritten);
+    ASSERT_FALSE(first_tick.pass_complete);
+    ASSERT_EQ(1U, second_tick.segments_rewritten);
+    ASSERT_TRUE(second_tick.pass_complete);
+    ASSERT_EQ(0U, next_pass.segments_rewritten);
+    ASSERT_EQ(1U, snapshot_file_reader(archive / "0002.snap").size());
+}
+
+TEST(retention_engine, segment_being_written_is_left_alone)
+{
+    // arrange
+    auto const archive = make_archive("retention_open");
+    auto const now = system_clock::now();
+    write_segment(archive / "0001.snap", every(start_of_day(now - hours(72)), minutes(10), 6U));
+    // without its trailer the segment looks as it does while its writer is still appending
+    std::filesystem::resize_file(archive / "0001.snap", std::filesystem::file_size(archive / "0001.snap") - 1U);
+    retention_engine engine(archive);
+
+    // Act
+    auto const report = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(0U, report.segments_rewritten);
+    ASSERT_EQ(0U, report.snapshots_removed);
+}
+
+TEST(retention_engine, segment_open_for_writing_is_skipped)
+{
+    // arrange
+    auto const archive = make_archive("retention_writing");
+    auto const now = system_clock::now();
+    write_segment(archive / "0001.snap", every(start_of_day(now - hours(72)), minutes(10), 6U));
+    trace_table traces{};
+    vector<string_view> const frames{"ntdll!RtlAllocateHeap", "app!main"};
+    vector<allocation_site> const sites{{traces.intern(frames), 100U, 1U}};
+    snapshot_file_writer writer(archive / "0002.snap");
+    writer.append(heap_snapshot(sites), now - hours(72), traces);
+    writer.append(heap_snapshot(sites), now - hours(72) + minutes(10), traces);
+    retention_engine engine(archive);
+
+    // Act
+    auto const report = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(2U, report.segments_checked);
+    ASSERT_EQ(1U, report.segments_rewritten);
+    ASSERT_TRUE(std::filesystem::exists(archive / "0002.snap"));
+    writer.close();
+    ASSERT_EQ(2U, snapshot_file_reader(archive / "0002.snap").size());
+}
+
+TEST(retention_engine, segment_abandoned_by_its_writer_is_recovered)
+{
+    // arrange
+    auto const archive = make_archive("retention_abandoned");
+    auto const now = system_clock::now();
+    auto const first = start_of_day(now - hours(72));
+    write_segment(archive / "0001.snap", every(first, minutes(10), 18U));
+    std::filesystem::resize_file(archive / "0001.snap", std::filesystem::file_size(archive / "0001.snap") - 1U);
+    std::filesystem::last_write_time(archive / "0001.snap", std::filesystem::file_time_type::clock::now() - hours(48));
+    retention_engine engine(archive);
+
+    // Act
+    auto const report = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(1U, report.segments_rewritten);
+    ASSERT_EQ(15U, report.snapshots_removed);
+    snapshot_file_reader const reader(archive / "0001.snap");
+    ASSERT_FALSE(reader.was_recovered());
+    ASSERT_EQ(3U, reader.size());
+    ASSERT_EQ(first, reader.get_info(0U).taken_at);
+}
+
+TEST(retention_engine, each_series_keeps_its_own_representatives)
+{
+    // arrange
+    auto const archive = make_archive("retention_series");
+    auto const now = system_clock::now();
+    auto const first = start_of_day(now - hours(72));
+    std::filesystem::create_directories(archive / "name_app.100");
+    std::filesystem::create_directories(archive / "name_app.200");
+    write_segment(archive / "name_app.100" / "0001.snap", every(first, minutes(10), 6U));
+    write_segment(archive / "name_app.200" / "0001.snap", every(first + minutes(5), minutes(10), 6U));
+    retention_engine engine(archive);
+
+    // Act
+    auto const report = engine.tick(now);
+
+    // Assert
+    ASSERT_EQ(2U, report.segments_checked);
+    ASSERT_EQ(10U, report.snapshots_removed);
+    ASSERT_EQ(first, snapshot_file_reader(archive / "name_app.100" / "0001.snap").get_info(0U).taken_at);
+    ASSERT_EQ(first + minutes(5), snapshot_file_reader(archive / "name_app.200" / "0001.snap").get_info(0U).taken_at);
+}
+
+TEST(retention_engine, invalid_policy_throws_invalid_argument)
+{
+    retention_policy policy{};
+    policy.hourly_window = hours(1);
+
+    ASSERT_THROW(retention_engine(make_archive("retention_invalid"), policy), std::invalid_argument);
+}
+
+}
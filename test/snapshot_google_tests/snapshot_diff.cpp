@@ -0,0 +1,113 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/snapshot_diff.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using snapshot::allocation_site;
+using snapshot::diff_snapshots;
+using snapshot::heap_snapshot;
+using snapshot::site_change;
+using std::vector;
+
+namespace snapshot::snapshot_diff_tests
+{
+
+namespace
+{
+    heap_snapshot make_snapshot(std::size_t const sites, unsigned int const seed, double const changed)
+    {
+        std::mt19937 generator(seed);
+        std::bernoulli_distribution changes(changed);
+        std::uniform_int_distribution<std::uint64_t> growth(1U, 1U << 16U);
+        vector<allocation_site> taken{};
+        taken.reserve(sites);
+        for (std::size_t site = 0; site < sites; ++site)
+            taken.push_back(allocation_site{static_cast<trace_id>(site), 4096U + (changes(generator) ? growth(generator) : 0U), 4U});
+        return heap_snapshot(std::move(taken));
+    }
+}
+
+TEST(diff_snapshots, reports_changed_new_and_vanished_sites)
+{
+    // arrange
+    heap_snapshot const before(vector<allocation_site>{{1U, 100U, 1U}, {2U, 200U, 2U}, {3U, 300U, 3U}});
+    heap_snapshot const after(vector<allocation_site>{{1U, 100U, 1U}, {2U, 250U, 3U}, {4U, 400U, 4U}});
+
+    // Act
+    auto const diff = diff_snapshots(before, after);
+
+    // Assert
+    ASSERT_EQ(3U, diff.deltas.size());
+    ASSERT_EQ(4U, diff.deltas[0].trace);
+    ASSERT_EQ(site_change::NEW, diff.deltas[0].change);
+    ASSERT_EQ(400, diff.deltas[0].bytes_delta);
+    ASSERT_EQ(2U, diff.deltas[1].trace);
+    ASSERT_EQ(site_change::CHANGED, diff.deltas[1].change);
+    ASSERT_EQ(50, diff.deltas[1].bytes_delta);
+    ASSERT_EQ(1, diff.deltas[1].count_delta);
+    ASSERT_EQ(250U, diff.deltas[1].bytes);
+    ASSERT_EQ(3U, diff.deltas[2].trace);
+    ASSERT_EQ(site_change::VANISHED, diff.deltas[2].change);
+    ASSERT_EQ(-300, diff.deltas[2].bytes_delta);
+    ASSERT_EQ(150, diff.bytes_delta);
+    ASSERT_EQ(2, diff.count_delta);
+    ASSERT_EQ(1U, diff.new_sites);
+    ASSERT_EQ(1U, diff.vanished_sites);
+}
+
+TEST(diff_snapshots, identical_snapshots_have_no_deltas)
+{
+    auto const snapshot = make_snapshot(1'000U, 1U, 0.5);
+
+    auto const diff = diff_snapshots(snapshot, snapshot);
+
+    ASSERT_TRUE(diff.deltas.empty());
+    ASSERT_EQ(0, diff.bytes_delta);
+}
+
+TEST(diff_snapshots, top_keeps_the_largest_growth_in_order)
+{
+    // arrange
+    auto const before = make_snapshot(10'000U, 1U, 0.0);
+    auto const after = make_snapshot(10'000U, 2U, 0.5);
+    auto const full = diff_snapshots(before, after);
+
+    // Act
+    auto const top = diff_snapshots(before, after, 10U);
+
+    // Assert
+    ASSERT_EQ(10U, top.deltas.size());
+    ASSERT_EQ(full.changed_sites, top.changed_sites);
+    for (std::size_t i = 0; i < top.deltas.size(); ++i) {
+        ASSERT_EQ(full.deltas[i].trace, top.deltas[i].trace);
+        ASSERT_EQ(full.deltas[i].bytes_delta, top.deltas[i].bytes_delta);
+    }
+}
+
+TEST(diff_snapshots, DISABLED_benchmark_million_site_snapshots)
+{
+    auto const before = make_snapshot(1'000'000U, 1U, 0.05);
+    auto const after = make_snapshot(1'000'000U, 2U, 0.05);
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const diff = diff_snapshots(before, after, 100U);
+    auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "diffed 1,000,000 sites with " << diff.changed_sites << " changed in " << elapsed << "ms" << std::endl;
+}
+
+}
@@ -0,0 +1,388 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/snapshot_file.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include "umdh_text.h"
+
+using snapshot::allocation_site;
+using snapshot::heap_snapshot;
+using snapshot::read_heap_snapshot;
+using snapshot::snapshot_file_reader;
+using snapshot::snapshot_file_writer;
+using snapshot::trace_table;
+using snapshot::tests::make_umdh_text;
+using std::chrono::system_clock;
+using std::filesystem::path;
+using std::vector;
+
+namespace snapshot::snapshot_file_tests
+{
+
+namespace
+{
+    path get_filename(std::string const& name)
+    {
+        return std::filesystem::temp_directory_path() / name;
+    }
+
+    /// <summary>two snapshots of the same process, the second seeing traces the first didn't</summary>
+    path write_series(std::string const& name, trace_table& traces, vector<heap_snapshot>& snapshots, bool const close = true)
+    {
+        auto const filename = get_filename(name);
+        auto const first = make_umdh_text(100U, 1U);
+        auto const second = make_umdh_text(150U, 2U);
+        snapshots.push_back(read_heap_snapshot(first, traces));
+        snapshots.push_back(read_heap_snapshot(second, traces));
+
+        snapshot_file_writer writer(filename);
+        writer.append(snapshots[0], system_clock::time_point(std::chrono::seconds(1000)), traces);
+        writer.append(snapshots[1], system_clock::time_point(std::chrono::seconds(1060)), traces);
+        if (close)
+            writer.close();
+        return filename;
+    }
+
+    void truncate(path const& filename, std::uintmax_t const length)
+    {
+        std::filesystem::resize_file(filename, length);
+    }
+
+    void overwrite(path const& filename, std::streamoff const offset, char const value)
+    {
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.put(value);
+    }
+}
+
+TEST(snapshot_file, snapshots_round_trip)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = write_series("snapshot_file_round_trip.bin", traces, snapshots);
+
+    // Act
+    snapshot_file_reader const reader(filename);
+
+    // Assert
+    ASSERT_EQ(2U, reader.size());
+    ASSERT_FALSE(reader.was_recovered());
+    for (std::size_t index = 0; index < snapshots.size(); ++index) {
+        auto const read = reader.read_snapshot(index);
+        ASSERT_EQ(snapshots[index].size(), read.size());
+        ASSERT_TRUE(std::equal(snapshots[index].get_sites().begin(), snapshots[index].get_sites().end(), read.get_sites().begin()));
+    }
+}
+
+TEST(snapshot_file, traces_read_back_with_the_same_ids)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = write_series("snapshot_file_traces.bin", traces, snapshots);
+    snapshot_file_reader const reader(filename);
+    trace_table read{};
+
+    // Act
+    reader.read_traces(read);
+
+    // Assert
+    ASSERT_EQ(traces.size(), read.size());
+    for (trace_id trace = 0; trace < traces.size(); ++trace) {
+        auto const expected = traces.get_trace(trace);
+        auto const actual = read.get_trace(trace);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t frame = 0; frame < expected.size(); ++frame)
+            ASSERT_EQ(traces.get_frame(expected[frame]), read.get_frame(actual[frame]));
+    }
+}
+
+TEST(snapshot_file, totals_are_read_from_the_index)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = write_series("snapshot_file_totals.bin", traces, snapshots);
+
+    // Act
+    snapshot_file_reader const reader(filename);
+
+    // Assert
+    auto const& info = reader.get_info(1U);
+    ASSERT_EQ(system_clock::time_point(std::chrono::seconds(1060)), info.taken_at);
+    ASSERT_EQ(snapshots[1].get_total_bytes(), info.total_bytes);
+    ASSERT_EQ(snapshots[1].get_total_count(), info.total_count);
+    ASSERT_EQ(snapshots[1].size(), info.sites);
+}
+
+TEST(snapshot_file, known_traces_are_not_written_again)
+{
+    // arrange
+    auto const text = make_umdh_text(1000U);
+    trace_table traces{};
+    auto const snapshot = read_heap_snapshot(text, traces);
+    snapshot_file_writer writer(get_filename("snapshot_file_dictionary.bin"), 1U);
+    writer.append(snapshot, system_clock::now(), traces);
+    auto const first = writer.get_size();
+
+    // Act
+    writer.append(snapshot, system_clock::now(), traces);
+
+    // Assert
+    ASSERT_LT(writer.get_size() - first, first / 4U);
+}
+
+TEST(snapshot_file, deltas_reconstruct_every_snapshot)
+{
+    // arrange
+    auto const filename = get_filename("snapshot_file_deltas.bin");
+    std::mt19937 generator(7U);
+    std::uniform_int_distribution<std::uint32_t> traces(0U, 199U);
+    vector<allocation_site> sites{};
+    for (trace_id trace = 0; trace < 150U; ++trace)
+        sites.push_back(allocation_site{trace, 1000U + trace, 10U});
+    vector<heap_snapshot> snapshots{};
+    {
+        trace_table const empty{};
+        snapshot_file_writer writer(filename, 4U);
+        for (auto index = 0; index < 10; ++index) {
+            // grow, shrink to nothing, drop and add a few sites at random
+            for (auto change = 0; change < 20; ++change) {
+                auto const trace = traces(generator);
+                auto const found = std::find_if(sites.begin(), sites.end(), [trace](auto const& site) { return site.trace == trace; });
+                if (found == sites.end())
+                    sites.push_back(allocation_site{trace, 64U, 1U});
+                else if (change % 5 == 0)
+                    sites.erase(found);
+                else if (change % 5 == 1)
+                    *found = allocation_site{trace, 0U, 0U};
+                else
+                    found->bytes += 32U * trace;
+            }
+            snapshots.emplace_back(sites);
+            writer.append(snapshots.back(), system_clock::now(), empty);
+        }
+    }
+
+    // Act
+    snapshot_file_reader const reader(filename);
+
+    // Assert
+    ASSERT_EQ(snapshots.size(), reader.size());
+    for (auto index = snapshots.size(); index > 0U; --index) {
+        auto const read = reader.read_snapshot(index - 1U);
+        auto const& expected = snapshots[index - 1U];
+        ASSERT_EQ(expected.size(), read.size());
+        ASSERT_TRUE(std::equal(expected.get_sites().begin(), expected.get_sites().end(), read.get_sites().begin()));
+        ASSERT_EQ(expected.get_total_bytes(), read.get_total_bytes());
+    }
+}
+
+TEST(snapshot_file, delta_holds_only_changed_sites)
+{
+    // arrange
+    auto const text = make_umdh_text(1000U);
+    trace_table traces{};
+    auto const snapshot = read_heap_snapshot(text, traces);
+    vector<allocation_site> sites(snapshot.get_sites().begin(), snapshot.get_sites().end());
+    sites[10].bytes += 100U;
+    sites.erase(sites.begin() + 20);
+    heap_snapshot const changed(std::move(sites));
+    snapshot_file_writer writer(get_filename("snapshot_file_delta_size.bin"));
+    writer.append(snapshot, system_clock::now(), traces);
+    auto const first = writer.get_size();
+
+    // Act
+    writer.append(changed, system_clock::now(), traces);
+
+    // Assert
+    ASSERT_LT(writer.get_size() - first, 64U);
+}
+
+TEST(snapshot_file, zero_keyframe_interval_throws_invalid_argument)
+{
+    ASSERT_THROW(snapshot_file_writer(get_filename("snapshot_file_zero_interval.bin"), 0U), std::invalid_argument);
+}
+
+TEST(snapshot_file, unclosed_file_is_recovered_by_scanning)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = write_series("snapshot_file_unclosed.bin", traces, snapshots);
+    truncate(filename, std::filesystem::file_size(filename) - 1U);
+
+    // Act
+    snapshot_file_reader const reader(filename);
+
+    // Assert
+    ASSERT_TRUE(reader.was_recovered());
+    ASSERT_EQ(2U, reader.size());
+    ASSERT_EQ(snapshots[1].get_total_bytes(), reader.get_info(1U).total_bytes);
+    ASSERT_EQ(snapshots[1].size(), reader.read_snapshot(1U).size());
+}
+
+TEST(snapshot_file, index_offset_which_wraps_is_recovered_by_scanning)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = write_series("snapshot_file_wrapped.bin", traces, snapshots);
+    auto const trailer = static_cast<std::uint64_t>(std::filesystem::file_size(filename) - 24U);
+    // an offset just short of 2^64 and enough entries that the sum wraps around to the trailer exactly
+    auto const short_by = 48U - trailer % 48U;
+    auto const entries = (trailer + short_by) / 48U;
+    auto const offset = std::uint64_t{0} - short_by;
+    for (auto byte = 0; byte < 8; ++byte)
+        overwrite(filename, static_cast<std::streamoff>(trailer) + byte, static_cast<char>(offset >> (8 * byte) & 0xFFU));
+    for (auto byte = 0; byte < 4; ++byte)
+        overwrite(filename, static_cast<std::streamoff>(trailer) + 8 + byte, static_cast<char>(entries >> (8 * byte) & 0xFFU));
+
+    // Act
+    snapshot_file_reader const reader(filename);
+
+    // Assert
+    ASSERT_TRUE(reader.was_recovered());
+    ASSERT_EQ(2U, reader.size());
+}
+
+TEST(snapshot_file, recovery_stops_at_a_torn_block)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = get_filename("snapshot_file_torn.bin");
+    std::uintmax_t first{};
+    {
+        auto const text = make_umdh_text(100U);
+        snapshots.push_back(read_heap_snapshot(text, traces));
+        snapshot_file_writer writer(filename);
+        writer.append(snapshots[0], system_clock::now(), traces);
+        first = writer.get_size();
+        writer.append(snapshots[0], system_clock::now(), traces);
+    }
+    truncate(filename, first + 20U);
+
+    // Act
+    snapshot_file_reader const reader(filename);
+
+    // Assert
+    ASSERT_TRUE(reader.was_recovered());
+    ASSERT_EQ(1U, reader.size());
+}
+
+TEST(snapshot_file, damaged_snapshot_throws_runtime_error)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = write_series("snapshot_file_damaged.bin", traces, snapshots);
+    overwrite(filename, static_cast<std::streamoff>(std::filesystem::file_size(filename) / 2U), '\x7F');
+    snapshot_file_reader const reader(filename);
+
+    // Act / Assert
+    ASSERT_THROW({
+        for (std::size_t index = 0; index < reader.size(); ++index)
+            static_cast<void>(reader.read_snapshot(index));
+        trace_table read{};
+        reader.read_traces(read);
+    }, std::runtime_error);
+}
+
+TEST(snapshot_file, other_files_are_rejected)
+{
+    auto const filename = get_filename("snapshot_file_other.bin");
+    std::ofstream(filename, std::ios::binary | std::ios::trunc) << make_umdh_text(1U);
+
+    ASSERT_THROW(snapshot_file_reader{filename}, std::runtime_error);
+}
+
+TEST(snapshot_file, file_shorter_than_its_header_is_rejected)
+{
+    // arrange
+    trace_table traces{};
+    vector<heap_snapshot> snapshots{};
+    auto const filename = write_series("snapshot_file_short.bin", traces, snapshots);
+    truncate(filename, 13U);
+
+    // Act / Assert
+    ASSERT_THROW(snapshot_file_reader{filename}, std::runtime_error);
+}
+
+TEST(snapshot_file, append_after_close_throws_invalid_argument)
+{
+    trace_table traces{};
+    snapshot_file_writer writer(get_filename("snapshot_file_closed.bin"));
+    writer.close();
+
+    ASSERT_THROW(writer.append(heap_snapshot(vector<allocation_site>{}), system_clock::now(), traces), std::invalid_argument);
+}
+
+TEST(snapshot_file, DISABLED_benchmark_size_against_umdh_text)
+{
+    constexpr std::size_t snapshot_count = 32U;
+    auto const text = make_umdh_text(100'000U, 1U);
+    trace_table traces{};
+    auto const first = read_heap_snapshot(text, traces);
+
+    // successive snapshots of one process, about 5% of sites change between each
+    vector<heap_snapshot> snapshots{};
+    std::mt19937 generator(3U);
+    std::uniform_int_distribution<std::size_t> picks(0U, first.size() - 1U);
+    vector<allocation_site> sites(first.get_sites().begin(), first.get_sites().end());
+    for (std::size_t index = 0; index < snapshot_count; ++index) {
+        for (std::size_t change = 0; change < sites.size() / 20U; ++change)
+            sites[picks(generator)].bytes += 64U;
+        snapshots.emplace_back(sites);
+    }
+
+    for (auto const keyframe_interval : {std::size_t{1U}, std::size_t{16U}}) {
+        auto const filename = get_filename("snapshot_file_benchmark.bin");
+        auto const start = std::chrono::steady_clock::now();
+        {
+            snapshot_file_writer writer(filename, keyframe_interval);
+            for (auto const& snapshot : snapshots)
+                writer.append(snapshot, system_clock::now(), traces);
+        }
+        auto const written = std::chrono::steady_clock::now();
+
+        snapshot_file_reader const reader(filename);
+        std::uint64_t total{};
+        for (std::size_t index = 0; index < reader.size(); ++index)
+            total += reader.get_info(index).total_bytes;
+        auto const totals = std::chrono::steady_clock::now();
+        // the last snapshot before a keyframe has the most deltas to apply
+        auto const last = reader.read_snapshot(std::min(keyframe_interval, snapshot_count) - 1U);
+        auto const decoded = std::chrono::steady_clock::now();
+
+        auto const file_size = std::filesystem::file_size(filename);
+        auto const text_size = text.size() * snapshot_count;
+        std::cout << "keyframe every " << keyframe_interval << ": " << snapshot_count << " snapshots of umdh text " << text_size
+            << " bytes stored in " << file_size << " bytes, " << static_cast<double>(text_size) / static_cast<double>(file_size)
+            << "x smaller, written in " << std::chrono::duration<double, std::milli>(written - start).count() << "ms, totals in "
+            << std::chrono::duration<double, std::micro>(totals - written).count() << "us, " << last.size() << " sites decoded in "
+            << std::chrono::duration<double, std::milli>(decoded - totals).count() << "ms (" << total << " bytes total)" << std::endl;
+        std::filesystem::remove(filename);
+    }
+}
+
+}
@@ -0,0 +1,191 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/trace_table.h>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include "umdh_text.h"
+
+using snapshot::allocation_record;
+using snapshot::trace_id;
+using snapshot::trace_table;
+using snapshot::umdh_reader;
+using snapshot::tests::make_umdh_text;
+using std::string_view;
+using std::vector;
+
+namespace snapshot::trace_table_tests
+{
+
+namespace
+{
+    vector<trace_id> intern_all(trace_table& table, string_view const& text)
+    {
+        vector<trace_id> traces{};
+        umdh_reader reader(text);
+        allocation_record record{};
+        while (reader.next(record))
+            traces.push_back(table.intern(record));
+        return traces;
+    }
+}
+
+TEST(trace_table, equal_traces_share_an_id)
+{
+    // arrange
+    trace_table table{};
+    vector<string_view> const first{"ntdll!RtlAllocateHeap+274", "app!main+1C"};
+    vector<string_view> const second{"ntdll!RtlAllocateHeap+274", "app!main+1C"};
+    vector<string_view> const reversed{"app!main+1C", "ntdll!RtlAllocateHeap+274"};
+
+    // Act
+    auto const first_id = table.intern(first);
+    auto const second_id = table.intern(second);
+    auto const reversed_id = table.intern(reversed);
+
+    // Assert
+    ASSERT_EQ(first_id, second_id);
+    ASSERT_NE(first_id, reversed_id);
+    ASSERT_EQ(2U, table.size());
+    ASSERT_EQ(2U, table.get_frame_count());
+}
+
+TEST(trace_table, trace_frames_can_be_read_back)
+{
+    // arrange
+    trace_table table{};
+    vector<string_view> const frames{"ntdll!RtlAllocateHeap+274", "ucrtbase!malloc+12", "app!main+1C"};
+
+    // Act
+    auto const id = table.intern(frames);
+    auto const stored = table.get_trace(id);
+
+    // Assert
+    ASSERT_EQ(frames.size(), stored.size());
+    for (std::size_t i = 0; i < frames.size(); ++i)
+        ASSERT_EQ(frames[i], table.get_frame(stored[i]));
+}
+
+TEST(trace_table, ids_are_stable_across_snapshots_of_a_series)
+{
+    // arrange
+    auto const text = make_umdh_text(5'000U);
+    trace_table table{};
+    auto const first = intern_all(table, text);
+    auto const traces = table.size();
+
+    // Act
+    auto const second = intern_all(table, text);
+
+    // Assert
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(traces, table.size());
+}
+
+TEST(trace_table, records_are_found_by_backtrace_id_once_seen)
+{
+    // arrange
+    trace_table table{};
+    auto const first_text = make_umdh_text(1U, 1U);
+    auto const second_text = make_umdh_text(1U, 2U);
+    umdh_reader first(first_text);
+    umdh_reader second(second_text);
+    allocation_record record{};
+    ASSERT_TRUE(first.next(record));
+    auto const first_id = table.intern(record);
+
+    // Act
+    ASSERT_TRUE(second.next(record));
+    auto const second_id = table.intern(record);
+
+    // Assert
+    ASSERT_EQ(first_id, second_id);
+    ASSERT_NE(first_id, table.intern(record.frames));
+}
+
+TEST(trace_table, empty_trace_is_interned)
+{
+    trace_table table{};
+
+    auto const id = table.intern(std::span<string_view const>());
+
+    ASSERT_TRUE(table.get_trace(id).empty());
+}
+
+TEST(trace_table, unknown_ids_throw_invalid_argument)
+{
+    trace_table const table{};
+
+    ASSERT_THROW(static_cast<void>(table.get_trace(0U)), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(table.get_frame(0U)), std::invalid_argument);
+}
+
+TEST(trace_table, clear_forgets_every_trace)
+{
+    // arrange
+    trace_table table{};
+    static_cast<void>(intern_all(table, make_umdh_text(5'000U)));
+    auto const used = table.get_memory_usage();
+
+    // Act
+    table.clear();
+
+    // Assert
+    ASSERT_EQ(0U, table.size());
+    ASSERT_LT(table.get_memory_usage(), used / 10U);
+    ASSERT_EQ(0U, table.intern(std::span<string_view const>()));
+}
+
+TEST(trace_table, moved_from_table_can_intern_again)
+{
+    // arrange
+    trace_table table{};
+    static_cast<void>(intern_all(table, make_umdh_text(100U)));
+    auto const traces = table.size();
+
+    // Act
+    trace_table moved(std::move(table));
+    trace_table assigned{};
+    assigned = std::move(moved);
+
+    // Assert
+    ASSERT_EQ(traces, assigned.size());
+    ASSERT_EQ(0U, table.size());
+    ASSERT_EQ(0U, moved.size());
+    vector<string_view> const frames{"ntdll!RtlAllocateHeap", "app!main"};
+    ASSERT_EQ(0U, table.intern(frames));
+    ASSERT_EQ(0U, moved.intern(frames));
+}
+
+TEST(trace_table, DISABLED_benchmark_interning)
+{
+    auto const text = make_umdh_text(1'000'000U, 1U, 16U);
+    trace_table table{};
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const first = intern_all(table, text);
+    auto const interned = std::chrono::steady_clock::now();
+    auto const second = intern_all(table, text);
+    auto const finished = std::chrono::steady_clock::now();
+
+    std::cout << first.size() << " records: first snapshot "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(interned - start).count() << "ms, repeat "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(finished - interned).count() << "ms, "
+        << table.get_memory_usage() / (1024U * 1024U) << "MiB interned against "
+        << text.size() / (1024U * 1024U) << "MiB of text" << std::endl;
+    ASSERT_EQ(first, second);
+}
+
+}
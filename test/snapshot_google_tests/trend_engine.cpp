@@ -0,0 +1,178 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/trend_engine.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+using snapshot::allocation_site;
+using snapshot::diff_snapshots;
+using snapshot::heap_snapshot;
+using snapshot::trend_engine;
+using snapshot::trend_thresholds;
+using std::vector;
+
+namespace snapshot::trend_engine_tests
+{
+
+namespace
+{
+    /// feeds each snapshot after the first to engine as a diff against its predecessor
+    void add_all(trend_engine& engine, vector<heap_snapshot> const& snapshots)
+    {
+        for (std::size_t i = 1; i < snapshots.size(); ++i)
+            engine.add(diff_snapshots(snapshots[i - 1U], snapshots[i]));
+    }
+
+    heap_snapshot make_snapshot(std::uint64_t const leaking, std::uint64_t const noisy, std::uint64_t const stable)
+    {
+        return heap_snapshot(vector<allocation_site>{{0U, leaking, 1U}, {1U, noisy, 1U}, {2U, stable, 1U}});
+    }
+}
+
+TEST(trend_engine, steady_growth_is_flagged)
+{
+    // arrange
+    vector<heap_snapshot> snapshots{};
+    for (std::uint64_t i = 0; i < 10U; ++i)
+        snapshots.push_back(make_snapshot(1'000U + i * 100U, i % 2U == 0U ? 500U : 900U, 300U));
+    trend_engine engine(snapshots.front());
+
+    // Act
+    add_all(engine, snapshots);
+
+    // Assert
+    ASSERT_EQ(1U, engine.get_flagged().size());
+    auto const& flagged = engine.get_flagged().front();
+    ASSERT_EQ(0U, flagged.trace);
+    ASSERT_NEAR(100.0, flagged.slope, 1e-6);
+    ASSERT_NEAR(1.0, flagged.r_squared, 1e-9);
+    ASSERT_EQ(9U, flagged.growth_streak);
+    ASSERT_EQ(1'900U, flagged.bytes);
+}
+
+TEST(trend_engine, unchanged_site_is_flat)
+{
+    // arrange
+    vector<heap_snapshot> snapshots(6U, make_snapshot(1U, 1U, 300U));
+    trend_engine engine(snapshots.front());
+
+    // Act
+    add_all(engine, snapshots);
+    auto const trend = engine.get_trend(2U);
+
+    // Assert
+    ASSERT_TRUE(trend.has_value());
+    ASSERT_EQ(0.0, trend.value().slope);
+    ASSERT_EQ(300U, trend.value().bytes);
+    ASSERT_FALSE(engine.get_trend(3U).has_value());
+}
+
+TEST(trend_engine, matches_a_direct_fit_over_the_window)
+{
+    // arrange
+    std::mt19937 generator(5U);
+    std::uniform_int_distribution<std::uint64_t> step(0U, 3U);
+    vector<heap_snapshot> snapshots{};
+    vector<double> values{};
+    std::uint64_t value = 1'000U;
+    for (auto i = 0; i < 40; ++i) {
+        // unchanged for a snapshot or two at a time so the fit has runs to combine
+        if (step(generator) != 0U)
+            value += step(generator) * 10U;
+        values.push_back(static_cast<double>(value));
+        snapshots.push_back(make_snapshot(value, 1U, 1U));
+    }
+    trend_thresholds thresholds{};
+    thresholds.window = 8U;
+    trend_engine engine(snapshots.front(), thresholds);
+
+    // Act
+    add_all(engine, snapshots);
+    auto const trend = engine.get_trend(0U).value();
+
+    // Assert
+    double n{}, x{}, xx{}, y{}, xy{};
+    for (std::size_t i = values.size() - 8U; i < values.size(); ++i) {
+        auto const position = static_cast<double>(i);
+        n += 1.0;
+        x += position;
+        xx += position * position;
+        y += values[i];
+        xy += position * values[i];
+    }
+    ASSERT_NEAR((n * xy - x * y) / (n * xx - x * x), trend.slope, 1e-6);
+}
+
+TEST(trend_engine, growth_which_stops_ages_out_of_the_window)
+{
+    // arrange
+    vector<heap_snapshot> snapshots{};
+    for (std::uint64_t i = 0; i < 6U; ++i)
+        snapshots.push_back(make_snapshot(1'000U + i * 100U, 1U, 1U));
+    trend_thresholds thresholds{};
+    thresholds.window = 4U;
+    trend_engine engine(snapshots.front(), thresholds);
+    add_all(engine, snapshots);
+    ASSERT_EQ(1U, engine.get_flagged().size());
+
+    // Act
+    for (auto i = 0; i < 4; ++i)
+        engine.add(diff_snapshots(snapshots.back(), snapshots.back()));
+
+    // Assert
+    ASSERT_TRUE(engine.get_flagged().empty());
+    ASSERT_EQ(0.0, engine.get_trend(0U).value().slope);
+}
+
+TEST(trend_engine, rejects_diffs_cut_by_a_top_limit)
+{
+    auto const before = make_snapshot(1U, 1U, 1U);
+    auto const after = make_snapshot(2U, 2U, 2U);
+    trend_engine engine(before);
+
+    ASSERT_THROW(engine.add(diff_snapshots(before, after, 1U)), std::invalid_argument);
+}
+
+TEST(trend_engine, DISABLED_benchmark_million_sites)
+{
+    constexpr std::size_t SITES = 1'000'000U;
+    std::mt19937 generator(1U);
+    std::uniform_int_distribution<std::size_t> pick(0U, SITES - 1U);
+    vector<allocation_site> sites{};
+    for (std::size_t site = 0; site < SITES; ++site)
+        sites.push_back(allocation_site{static_cast<trace_id>(site), 4096U, 1U});
+    heap_snapshot previous(sites);
+    trend_engine engine(previous);
+
+    double total{};
+    for (auto snapshot = 0; snapshot < 50; ++snapshot) {
+        for (auto change = 0; change < 10'000; ++change)
+            sites[pick(generator)].bytes += 64U;
+        heap_snapshot next(sites);
+        auto const diff = diff_snapshots(previous, next);
+
+        auto const start = std::chrono::steady_clock::now();
+        engine.add(diff);
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        previous = std::move(next);
+    }
+
+    std::cout << "1% of 1,000,000 sites changing per snapshot: " << total / 50.0 << "ms per snapshot, "
+        << engine.get_flagged().size() << " flagged" << std::endl;
+}
+
+}
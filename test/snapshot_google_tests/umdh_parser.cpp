@@ -0,0 +1,160 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot/umdh_parser.h>
+#include <chrono>
+#include <iostream>
+#include "umdh_text.h"
+
+using snapshot::allocation_record;
+using snapshot::umdh_reader;
+using snapshot::umdh_stream_parser;
+using snapshot::tests::make_umdh_text;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace snapshot::umdh_parser_tests
+{
+
+namespace
+{
+    constexpr string_view SNAPSHOT =
+        "// Debug library initialized ...\n"
+        "DBGHELP: app - private symbols & lines\n"
+        "*- - - - - - - - - - Heap 00160000 Hogs - - - - - - - - - -\n"
+        "\n"
+        "000001A0 bytes in 0x2 allocations (@ 0x000000D0 + 0x00000018) by: BackTrace00A53\r\n"
+        "        ntdll!RtlAllocateHeap+00000274\r\n"
+        "        app!main+0000001C\r\n"
+        "\r\n"
+        "00000040 bytes + 00000010 at 00C7A5D8 by BackTrace00C14\n"
+        "\t7C93A7F4\n"
+        "\n"
+        "00000010 bytes in 0x1 allocations (@ 0x00000010 + 0x00000010) by: BackTrace1F\n";
+
+    struct parsed_record final
+    {
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+        std::uint64_t backtrace_id{};
+        vector<string> frames{};
+
+        [[nodiscard]] friend bool operator==(parsed_record const&, parsed_record const&) = default;
+    };
+
+    parsed_record copy(allocation_record const& record)
+    {
+        parsed_record copied{record.bytes, record.count, record.backtrace_id, {}};
+        for (auto const frame : record.frames)
+            copied.frames.emplace_back(frame);
+        return copied;
+    }
+
+    vector<parsed_record> parse_all(string_view const& text)
+    {
+        vector<parsed_record> records{};
+        umdh_reader reader(text);
+        allocation_record record{};
+        while (reader.next(record))
+            records.push_back(copy(record));
+        return records;
+    }
+}
+
+TEST(umdh_reader, reads_both_record_forms_and_skips_noise)
+{
+    // Act
+    auto const records = parse_all(SNAPSHOT);
+
+    // Assert
+    ASSERT_EQ(3U, records.size());
+    ASSERT_EQ((parsed_record{0x1A0U, 2U, 0xA53U, {"ntdll!RtlAllocateHeap+00000274", "app!main+0000001C"}}), records[0]);
+    ASSERT_EQ((parsed_record{0x40U, 1U, 0xC14U, {"7C93A7F4"}}), records[1]);
+    ASSERT_EQ((parsed_record{0x10U, 1U, 0x1FU, {}}), records[2]);
+}
+
+TEST(umdh_reader, frames_refer_into_the_parsed_text)
+{
+    // arrange
+    umdh_reader reader(SNAPSHOT);
+    allocation_record record{};
+
+    // Act
+    ASSERT_TRUE(reader.next(record));
+
+    // Assert
+    auto const frame = *record.frames.begin();
+    ASSERT_GE(frame.data(), SNAPSHOT.data());
+    ASSERT_LE(frame.data() + frame.size(), SNAPSHOT.data() + SNAPSHOT.size());
+}
+
+TEST(umdh_reader, leaves_a_record_at_the_end_of_text_unread_when_not_final)
+{
+    // arrange
+    auto const partial = SNAPSHOT.substr(0U, SNAPSHOT.find("\t7C93A7F4"));
+    umdh_reader reader(partial, false);
+    allocation_record record{};
+
+    // Act
+    ASSERT_TRUE(reader.next(record));
+    auto const second = reader.next(record);
+
+    // Assert
+    ASSERT_FALSE(second);
+    ASSERT_EQ(partial.find("00000040 bytes"), reader.get_consumed());
+}
+
+TEST(umdh_stream_parser, matches_whole_text_however_it_is_split)
+{
+    // arrange
+    auto const text = make_umdh_text(40U, 3U, 3U);
+    auto const expected = parse_all(text);
+
+    for (std::size_t chunk_size : {1U, 2U, 7U, 64U, 1000U}) {
+        vector<parsed_record> actual{};
+        umdh_stream_parser parser{};
+        auto const visitor = [&actual](allocation_record const& record) { actual.push_back(copy(record)); };
+
+        // Act
+        for (std::size_t offset = 0; offset < text.size(); offset += chunk_size)
+            parser.feed(string_view(text).substr(offset, chunk_size), visitor);
+        parser.finish(visitor);
+
+        // Assert
+        ASSERT_EQ(expected, actual) << "chunk size " << chunk_size;
+    }
+}
+
+TEST(umdh_reader, DISABLED_benchmark_throughput)
+{
+    auto const text = make_umdh_text(1'000'000U);
+    std::uint64_t bytes{};
+    std::size_t frames{};
+
+    auto const start = std::chrono::steady_clock::now();
+    umdh_reader reader(text);
+    allocation_record record{};
+    while (reader.next(record)) {
+        bytes += record.bytes;
+        for (auto const frame : record.frames)
+            frames += frame.size();
+    }
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "parsed " << text.size() / (1024U * 1024U) << "MiB at "
+        << static_cast<double>(text.size()) / (1024.0 * 1024.0) / elapsed << "MiB/s, checksum " << bytes + frames << std::endl;
+}
+
+}
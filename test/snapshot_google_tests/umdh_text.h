@@ -0,0 +1,59 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace snapshot::tests
+{
+
+    /// <summary>snapshot text shaped like umdh -p output with records spread over a handful of modules</summary>
+    inline std::string make_umdh_text(std::size_t const records, unsigned int const seed = 1U, std::size_t const frames_per_record = 8U)
+    {
+        static char const* const modules[] = {"ntdll!RtlAllocateHeap", "ucrtbase!malloc", "app!widget::create", "app!cache::insert", "app!main"};
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<std::uint32_t> bytes(16U, 1U << 20U);
+        std::uniform_int_distribution<std::uint32_t> counts(1U, 500U);
+        std::uniform_int_distribution<std::uint32_t> offsets(0U, 0xFFFFU);
+
+        std::string text =
+            "// Debug library initialized ...\n"
+            "DBGHELP: app - private symbols & lines\n"
+            "//\n"
+            "// Each log entry has the following syntax:\n"
+            "//\n"
+            "\n"
+            "*- - - - - - - - - - Start of data for heap @ 0000020C1E3A0000 - - - - - - - - - -\n"
+            "\n";
+        text.reserve(records * (80U + frames_per_record * 48U));
+
+        char line[160]{};
+        for (std::size_t record = 0; record < records; ++record) {
+            auto const count = counts(generator);
+            std::snprintf(line, sizeof(line), "%08X bytes in 0x%X allocations (@ 0x%08X + 0x%08X) by: BackTrace%05zX\n",
+                bytes(generator), count, 32U, 16U, record + 1U);
+            text += line;
+            for (std::size_t frame = 0; frame < frames_per_record; ++frame) {
+                std::snprintf(line, sizeof(line), "        %s+%08X\n", modules[(record + frame) % std::size(modules)], offsets(generator));
+                text += line;
+            }
+            text += '\n';
+        }
+        return text;
+    }
+
+}
@@ -0,0 +1,140 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/coroutine_task_action.h>
+#include <stdexcept>
+
+using std::chrono::milliseconds;
+using std::make_shared;
+
+using tasks::action_result;
+using tasks::coroutine_action_adapter;
+using tasks::coroutine_task_action;
+using tasks::executor;
+using tasks::lazy;
+using tasks::schedule_on;
+using tasks::sync_wait;
+using tasks::task_state;
+
+namespace tasks::coroutine_task_action_tests
+{
+
+lazy<int> answer()
+{
+    co_return 42;
+}
+
+lazy<int> add_answers()
+{
+    auto const first = co_await answer();
+    auto const second = co_await answer();
+    co_return first + second;
+}
+
+lazy<int> throws()
+{
+    throw std::runtime_error("failed");
+    co_return 0;
+}
+
+lazy<int> count_down(int const remaining)
+{
+    if (remaining == 0)
+        co_return 0;
+    co_return 1 + co_await count_down(remaining - 1);
+}
+
+class stepped_action final : public coroutine_task_action
+{
+public:
+    using coroutine_task_action::process;
+
+    lazy<action_result> process() override
+    {
+        co_await schedule_on(m_executor);
+        first_step_on_worker = m_executor.is_worker_thread();
+        co_await schedule_on(m_executor);
+        co_return action_result(task_state::COMPLETE, milliseconds(5));
+    }
+
+    explicit stepped_action(executor& executor)
+        : m_executor{executor}
+    {
+    }
+
+    bool first_step_on_worker{};
+
+private:
+    executor& m_executor;
+};
+
+static_assert(tasks::CoroutineTaskAction<stepped_action>);
+
+TEST(lazy, does_not_start_until_awaited)
+{
+    // arrange
+    auto started = false;
+    // a parameter rather than a capture, the closure is gone by the time the coroutine runs
+    auto work = [](bool& flag) -> lazy<void> {
+        flag = true;
+        co_return;
+    }(started);
+
+    // Act
+    auto const before_await = started;
+    sync_wait(std::move(work));
+
+    // Assert
+    ASSERT_FALSE(before_await);
+    ASSERT_TRUE(started);
+}
+
+TEST(lazy, nested_awaits_return_result)
+{
+    ASSERT_EQ(84, sync_wait(add_answers()));
+}
+
+TEST(lazy, exception_is_rethrown_to_awaiter)
+{
+    ASSERT_THROW(static_cast<void>(sync_wait(throws())), std::runtime_error);
+}
+
+TEST(lazy, deeply_nested_awaits_return_result)
+{
+    ASSERT_EQ(1'000, sync_wait(count_down(1'000)));
+}
+
+TEST(coroutine_action_adapter, process_async_completes_future_with_coroutine_result)
+{
+    // arrange
+    executor pool(2);
+    auto const action = make_shared<stepped_action>(pool);
+    coroutine_action_adapter adapter(action, pool);
+
+    // Act
+    auto const [state, remaining] = adapter.process_async().get();
+
+    // Assert
+    ASSERT_EQ(task_state::COMPLETE, state);
+    ASSERT_EQ(milliseconds(5), remaining);
+    ASSERT_TRUE(action->first_step_on_worker);
+}
+
+TEST(coroutine_action_adapter, constructor_throws_when_action_is_null)
+{
+    executor pool(1);
+    ASSERT_THROW(coroutine_action_adapter(nullptr, pool), std::invalid_argument);
+}
+
+}
@@ -0,0 +1,135 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/executor.h>
+#include <tasks/task_action.h>
+
+using std::chrono::milliseconds;
+using std::future;
+using std::vector;
+
+using tasks::action_result;
+using tasks::executor;
+using tasks::task_action;
+using tasks::task_state;
+
+namespace tasks::executor_tests
+{
+
+class snapshot_action final : public task_action
+{
+public:
+    using task_action::process_async;
+
+    std::future<action_result> process_async() override
+    {
+        return m_executor.submit([]() {
+            return action_result(task_state::COMPLETE, milliseconds(0));
+        });
+    }
+
+    explicit snapshot_action(executor& executor)
+        : m_executor{executor}
+    {
+    }
+
+private:
+    executor& m_executor;
+};
+
+TEST(executor, submit_returns_result)
+{
+    executor pool(2);
+
+    auto result = pool.submit([]() { return 42; });
+
+    ASSERT_EQ(42, result.get());
+}
+
+TEST(executor, submit_propagates_exception)
+{
+    executor pool(1);
+
+    auto result = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+
+    ASSERT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(executor, task_action_completes_through_executor)
+{
+    executor pool(2);
+    snapshot_action action(pool);
+
+    auto const [state, remaining] = action.process_async().get();
+
+    ASSERT_EQ(task_state::COMPLETE, state);
+    ASSERT_EQ(milliseconds(0), remaining);
+}
+
+TEST(executor, runs_all_submitted_work)
+{
+    // arrange
+    constexpr auto count = 10'000;
+    executor pool(4);
+    std::atomic<int> executed{};
+    vector<future<void>> results;
+    results.reserve(count);
+
+    // Act
+    for (auto i = 0; i < count; ++i)
+        results.push_back(pool.submit([&executed]() { executed.fetch_add(1); }));
+    for (auto& result : results)
+        result.get();
+
+    // Assert
+    ASSERT_EQ(count, executed.load());
+    ASSERT_EQ(static_cast<std::uint64_t>(count), pool.get_statistics().executed);
+    ASSERT_EQ(0U, pool.get_queue_depth());
+}
+
+TEST(executor, idle_workers_steal_from_busy_worker)
+{
+    // arrange
+    executor pool(4);
+    std::atomic<int> executed{};
+
+    // Act
+    // everything posted from a worker lands on that worker's deque, the others can only get it by stealing
+    pool.submit([&pool, &executed]() {
+        for (auto i = 0; i < 64; ++i)
+            pool.post([&executed]() {
+                std::this_thread::sleep_for(milliseconds(1));
+                executed.fetch_add(1);
+            });
+    }).get();
+    while (executed.load() < 64)
+        std::this_thread::sleep_for(milliseconds(1));
+
+    // Assert
+    ASSERT_GT(pool.get_steal_count(), 0U);
+}
+
+TEST(executor, destructor_runs_remaining_work)
+{
+    std::atomic<int> executed{};
+    {
+        executor pool(1);
+        for (auto i = 0; i < 100; ++i)
+            pool.post([&executed]() { executed.fetch_add(1); });
+    }
+
+    ASSERT_EQ(100, executed.load());
+}
+
+}
@@ -0,0 +1,86 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/latency_histogram.h>
+
+using std::chrono::hours;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+using tasks::latency_histogram;
+
+namespace tasks::latency_histogram_tests
+{
+
+TEST(latency_histogram, empty_histogram_reports_zero)
+{
+    latency_histogram const histogram;
+
+    ASSERT_EQ(0U, histogram.get_count());
+    ASSERT_EQ(nanoseconds::zero(), histogram.get_percentile(99.0));
+}
+
+TEST(latency_histogram, percentiles_are_within_bucket_precision)
+{
+    // arrange
+    latency_histogram histogram;
+
+    // Act
+    for (auto value = 1; value <= 10'000; ++value)
+        histogram.record(microseconds(value));
+
+    // Assert
+    auto const p50 = static_cast<double>(histogram.get_percentile(50.0).count());
+    auto const p99 = static_cast<double>(histogram.get_percentile(99.0).count());
+    ASSERT_NEAR(5'000'000.0, p50, 5'000'000.0 / 64.0);
+    ASSERT_NEAR(9'900'000.0, p99, 9'900'000.0 / 64.0);
+    ASSERT_EQ(microseconds(10'000), histogram.get_maximum());
+    ASSERT_EQ(microseconds(1), histogram.get_minimum());
+}
+
+TEST(latency_histogram, every_bucket_boundary_round_trips)
+{
+    for (std::uint32_t bucket = 0; bucket < latency_histogram::BUCKETS; ++bucket)
+        ASSERT_EQ(bucket, latency_histogram::bucket_of(latency_histogram::highest_in_bucket(bucket)));
+}
+
+TEST(latency_histogram, values_beyond_range_are_clamped)
+{
+    // arrange
+    latency_histogram histogram;
+
+    // Act
+    histogram.record(hours(24));
+
+    // Assert
+    ASSERT_EQ(nanoseconds(latency_histogram::MAXIMUM_VALUE), histogram.get_maximum());
+}
+
+TEST(latency_histogram, merge_combines_counts)
+{
+    // arrange
+    latency_histogram first;
+    latency_histogram second;
+    first.record(microseconds(10));
+    second.record(microseconds(1'000));
+
+    // Act
+    first.merge(second);
+
+    // Assert
+    ASSERT_EQ(2U, first.get_count());
+    ASSERT_EQ(microseconds(1'000), first.get_maximum());
+}
+
+}
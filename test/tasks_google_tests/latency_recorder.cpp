@@ -0,0 +1,127 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/latency_dump_task.h>
+#include <tasks/latency_recorder.h>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include "test_task.h"
+
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+using std::make_shared;
+using std::type_index;
+using std::vector;
+
+using tasks::latency_dump_task;
+using tasks::latency_metric;
+using tasks::latency_recorder;
+using tasks::task_state;
+using tasks::tests::test_task;
+
+namespace tasks::latency_recorder_tests
+{
+
+TEST(latency_recorder, samples_from_every_thread_are_merged_on_read)
+{
+    // arrange
+    constexpr auto thread_count = 4;
+    constexpr auto samples = 1'000;
+    latency_recorder recorder;
+    auto const type = type_index(typeid(test_task));
+
+    // Act
+    vector<std::thread> threads;
+    for (auto i = 0; i < thread_count; ++i)
+        threads.emplace_back([&recorder, type]() {
+            for (auto sample = 1; sample <= samples; ++sample)
+                recorder.record(type, latency_metric::RUN, microseconds(sample));
+        });
+    for (auto& thread : threads)
+        thread.join();
+    auto const histogram = recorder.get_histogram<test_task>(latency_metric::RUN);
+
+    // Assert
+    ASSERT_EQ(static_cast<std::uint64_t>(thread_count * samples), histogram.get_count());
+    ASSERT_NEAR(500'000.0, static_cast<double>(histogram.get_percentile(50.0).count()), 500'000.0 / 64.0);
+}
+
+TEST(latency_recorder, recorder_reusing_a_slot_starts_empty)
+{
+    // arrange
+    auto const type = type_index(typeid(test_task));
+    for (auto i = 0; i < 100; ++i) {
+        latency_recorder earlier;
+        earlier.record(type, latency_metric::RUN, microseconds(1));
+    }
+    latency_recorder recorder;
+
+    // Act
+    recorder.record(type, latency_metric::RUN, microseconds(1));
+
+    // Assert
+    ASSERT_EQ(1U, recorder.get_histogram<test_task>(latency_metric::RUN).get_count());
+}
+
+TEST(latency_recorder, observed_run_records_each_metric)
+{
+    // arrange
+    auto const recorder = make_shared<latency_recorder>();
+    test_task target{};
+    target.add_observer(recorder);
+
+    // Act
+    static_cast<void>(target.try_transition(task_state::PENDING, task_state::READY));
+    static_cast<void>(target.try_transition(task_state::READY, task_state::RUNNING));
+    static_cast<void>(target.try_transition(task_state::RUNNING, task_state::COMPLETE));
+
+    // Assert
+    ASSERT_EQ(1U, recorder->get_histogram<test_task>(latency_metric::QUEUE).get_count());
+    ASSERT_EQ(1U, recorder->get_histogram<test_task>(latency_metric::RUN).get_count());
+    ASSERT_EQ(1U, recorder->get_histogram<test_task>(latency_metric::END_TO_END).get_count());
+    ASSERT_EQ(3U, recorder->get_summaries().size());
+}
+
+TEST(latency_recorder, dump_task_writes_line_per_metric)
+{
+    // arrange
+    latency_recorder recorder;
+    recorder.record(type_index(typeid(test_task)), latency_metric::QUEUE, microseconds(5));
+    std::ostringstream output;
+    latency_dump_task dump(recorder, output);
+
+    // Act
+    dump.process();
+
+    // Assert
+    ASSERT_NE(std::string::npos, output.str().find("queue count=1"));
+}
+
+TEST(latency_recorder, DISABLED_benchmark_record_cost)
+{
+    latency_recorder recorder;
+    auto const type = type_index(typeid(test_task));
+    constexpr auto samples = 10'000'000;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < samples; ++i)
+        recorder.record(type, latency_metric::RUN, nanoseconds(1'000 + i % 100'000));
+    auto const elapsed = std::chrono::duration_cast<nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "nanoseconds per record: " << static_cast<double>(elapsed.count()) / samples << std::endl;
+}
+
+}
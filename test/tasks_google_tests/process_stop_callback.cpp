@@ -0,0 +1,95 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/process_stop_callback.h>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+using std::nullopt;
+using std::optional;
+
+using shared::model::process;
+using tasks::process_stop_callback;
+using tasks::terminate_process;
+
+namespace tasks::process_stop_callback_tests
+{
+
+class fake_process final : public process
+{
+public:
+    [[nodiscard]] unsigned long get_id() const noexcept override
+    {
+        return 1UL;
+    }
+    [[nodiscard]] bool is_running() const noexcept override
+    {
+        return !terminated_with.has_value();
+    }
+    [[nodiscard]] optional<unsigned long> exit_code() const noexcept override
+    {
+        return terminated_with;
+    }
+    void wait_for_exit() const noexcept override
+    {
+    }
+    bool terminate(unsigned long const exit_code) noexcept override
+    {
+        terminated_with = exit_code;
+        return true;
+    }
+    [[nodiscard]] optional<std::filesystem::path> get_path_to_running_process(std::string_view const&) const noexcept override
+    {
+        return nullopt;
+    }
+    [[nodiscard]] optional<std::uint64_t> get_private_bytes() const noexcept override
+    {
+        return nullopt;
+    }
+
+    optional<unsigned long> terminated_with{};
+};
+
+TEST(process_stop_callback, stop_terminates_process)
+{
+    // arrange
+    fake_process helper{};
+    std::stop_source source;
+    process_stop_callback const on_stop(source.get_token(), terminate_process{helper, 3UL});
+
+    // Act
+    source.request_stop();
+
+    // Assert
+    ASSERT_EQ(3UL, helper.terminated_with.value());
+}
+
+TEST(process_stop_callback, process_is_left_running_when_callback_out_of_scope)
+{
+    // arrange
+    fake_process helper{};
+    std::stop_source source;
+    {
+        process_stop_callback const on_stop(source.get_token(), terminate_process{helper});
+    }
+
+    // Act
+    source.request_stop();
+
+    // Assert
+    ASSERT_TRUE(helper.is_running());
+}
+
+}
@@ -0,0 +1,176 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/ready_queue.h>
+#include <memory>
+#include <vector>
+
+using std::chrono::milliseconds;
+using std::make_unique;
+using std::unique_ptr;
+using std::vector;
+
+using tasks::fifo_ready_queue;
+using tasks::ready_queue;
+using tasks::slack_ready_queue;
+using tasks::task;
+
+namespace tasks::ready_queue_tests
+{
+
+using clock = ready_queue::clock;
+
+class simulated_task final : public task
+{
+public:
+    void process() override
+    {
+    }
+
+    explicit simulated_task(clock::time_point const arrival, milliseconds const duration, milliseconds const relative_deadline)
+        : arrival{arrival}
+        , duration{duration}
+    {
+        update_time_remaining(duration);
+        set_deadline(arrival + relative_deadline);
+    }
+
+    clock::time_point arrival;
+    milliseconds duration;
+};
+
+struct simulation_result final
+{
+    int misses{};
+    int short_misses{};
+};
+
+vector<unique_ptr<simulated_task>> make_overload(milliseconds const length)
+{
+    // snapshots every 20ms taking 6ms due within 100ms, diffs every 100ms taking 80ms due within 400ms; 110% of a single worker
+    clock::time_point const origin{};
+    vector<unique_ptr<simulated_task>> workload;
+    for (milliseconds at{}; at < length; at += milliseconds(20)) {
+        if (at % milliseconds(100) == milliseconds(0))
+            workload.push_back(make_unique<simulated_task>(origin + at, milliseconds(80), milliseconds(400)));
+        workload.push_back(make_unique<simulated_task>(origin + at, milliseconds(6), milliseconds(100)));
+    }
+    return workload;
+}
+
+simulation_result simulate(ready_queue& queue, vector<unique_ptr<simulated_task>> const& workload)
+{
+    // deterministic single worker, non preemptive; each task runs for exactly its estimate
+    simulation_result result;
+    clock::time_point now{};
+    std::size_t next_arrival{};
+    while (next_arrival < workload.size() || queue.size() > 0U) {
+        while (next_arrival < workload.size() && workload[next_arrival]->arrival <= now) {
+            queue.push(*workload[next_arrival], workload[next_arrival]->arrival);
+            ++next_arrival;
+        }
+
+        auto* const next = static_cast<simulated_task*>(queue.pop());
+        if (next == nullptr) {
+            now = workload[next_arrival]->arrival;
+            continue;
+        }
+        now += next->duration;
+        if (now > next->get_deadline().value()) {
+            ++result.misses;
+            if (next->duration < milliseconds(10))
+                ++result.short_misses;
+        }
+    }
+    return result;
+}
+
+TEST(ready_queue, fifo_pops_in_arrival_order)
+{
+    // arrange
+    fifo_ready_queue queue;
+    clock::time_point const now{};
+    simulated_task first(now, milliseconds(100), milliseconds(1000));
+    simulated_task second(now, milliseconds(1), milliseconds(10));
+    queue.push(first, now);
+    queue.push(second, now);
+
+    // Act
+    auto* const popped = queue.pop();
+
+    // Assert
+    ASSERT_EQ(&first, popped);
+}
+
+TEST(ready_queue, slack_pops_least_slack_first)
+{
+    // arrange
+    slack_ready_queue queue;
+    clock::time_point const now{};
+    simulated_task long_job(now, milliseconds(100), milliseconds(1000));
+    simulated_task urgent(now, milliseconds(1), milliseconds(10));
+    simulated_task tight(now, milliseconds(950), milliseconds(1000));
+    queue.push(long_job, now);
+    queue.push(urgent, now);
+    queue.push(tight, now);
+
+    // Act
+    auto* const first = queue.pop();
+    auto* const second = queue.pop();
+    auto* const third = queue.pop();
+
+    // Assert
+    ASSERT_EQ(&urgent, first);
+    ASSERT_EQ(&tight, second);
+    ASSERT_EQ(&long_job, third);
+    ASSERT_EQ(nullptr, queue.pop());
+}
+
+TEST(ready_queue, slack_without_deadline_ages_ahead_of_later_arrivals)
+{
+    // arrange
+    slack_ready_queue queue(milliseconds(100));
+    clock::time_point const now{};
+    simulated_task undated(now, milliseconds(10), milliseconds(0));
+    undated.set_deadline(std::nullopt);
+    simulated_task later(now + milliseconds(500), milliseconds(10), milliseconds(50));
+    queue.push(undated, now);
+    queue.push(later, now + milliseconds(500));
+
+    // Act
+    auto* const popped = queue.pop();
+
+    // Assert
+    ASSERT_EQ(&undated, popped);
+}
+
+TEST(ready_queue, slack_misses_fewer_deadlines_than_fifo_under_overload)
+{
+    // arrange
+    auto const workload = make_overload(milliseconds(2'000));
+    fifo_ready_queue fifo;
+    slack_ready_queue slack;
+
+    // Act
+    auto const fifo_result = simulate(fifo, workload);
+    auto const slack_result = simulate(slack, workload);
+    RecordProperty("fifo_misses", fifo_result.misses);
+    RecordProperty("slack_misses", slack_result.misses);
+
+    // Assert
+    ASSERT_LT(slack_result.misses, fifo_result.misses);
+    ASSERT_LT(slack_result.short_misses, fifo_result.short_misses);
+}
+
+}
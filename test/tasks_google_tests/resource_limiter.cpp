@@ -0,0 +1,163 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/resource_limiter.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using std::chrono::milliseconds;
+using std::future;
+using std::shared_future;
+using std::string;
+using std::vector;
+
+using tasks::executor;
+using tasks::resource_limiter;
+
+namespace tasks::resource_limiter_tests
+{
+
+class declaring_task final : public task
+{
+public:
+    void process() override
+    {
+        ++process_count;
+    }
+
+    [[nodiscard]] vector<string> get_resource_classes() const override
+    {
+        return {"snapshot-tool", "disk-io"};
+    }
+
+    std::atomic<int> process_count{};
+};
+
+TEST(resource_limiter, never_exceeds_limit)
+{
+    // arrange
+    executor pool(4);
+    resource_limiter limiter(pool);
+    limiter.add_class("snapshot-tool", 2);
+    std::atomic<int> running{};
+    std::atomic<int> peak{};
+    vector<future<void>> results;
+
+    // Act
+    for (auto i = 0; i < 20; ++i)
+        results.push_back(limiter.submit({"snapshot-tool"}, [&running, &peak]() {
+            auto const now_running = ++running;
+            auto observed = peak.load();
+            while (now_running > observed && !peak.compare_exchange_weak(observed, now_running)) {
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+            --running;
+        }));
+    for (auto& result : results)
+        result.get();
+
+    // Assert
+    ASSERT_LE(peak.load(), 2);
+    ASSERT_EQ(0U, limiter.get_in_use("snapshot-tool"));
+}
+
+TEST(resource_limiter, parked_work_does_not_block_workers)
+{
+    // arrange
+    executor pool(2);
+    resource_limiter limiter(pool);
+    limiter.add_class("snapshot-tool", 1);
+    std::promise<void> gate;
+    shared_future<void> const opened = gate.get_future().share();
+    vector<future<void>> snapshots;
+    for (auto i = 0; i < 4; ++i)
+        snapshots.push_back(limiter.submit({"snapshot-tool"}, [opened]() { opened.wait(); }));
+
+    // Act
+    auto const unrelated = pool.submit([]() { return 7; });
+    auto const unrelated_status = unrelated.wait_for(std::chrono::seconds(5));
+    auto const queued = limiter.get_queue_length("snapshot-tool");
+    gate.set_value();
+    for (auto& snapshot : snapshots)
+        snapshot.get();
+
+    // Assert
+    ASSERT_EQ(std::future_status::ready, unrelated_status);
+    ASSERT_EQ(3U, queued);
+    ASSERT_EQ(0U, limiter.get_queue_length("snapshot-tool"));
+}
+
+TEST(resource_limiter, try_submit_rejects_when_queue_is_full)
+{
+    // arrange
+    executor pool(2);
+    resource_limiter limiter(pool);
+    limiter.add_class("disk-io", 1, 1);
+    std::promise<void> gate;
+    shared_future<void> const opened = gate.get_future().share();
+    auto first = limiter.try_submit({"disk-io"}, [opened]() { opened.wait(); });
+    auto second = limiter.try_submit({"disk-io"}, []() {});
+
+    // Act
+    auto third = limiter.try_submit({"disk-io"}, []() {});
+    gate.set_value();
+
+    // Assert
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    ASSERT_FALSE(third.has_value());
+    first.value().get();
+    second.value().get();
+    ASSERT_EQ(1U, limiter.get_statistics().front().rejected);
+}
+
+TEST(resource_limiter, task_runs_holding_each_declared_class)
+{
+    // arrange
+    executor pool(2);
+    resource_limiter limiter(pool);
+    limiter.add_class("snapshot-tool", 1);
+    limiter.add_class("disk-io", 1);
+    declaring_task target{};
+
+    // Act
+    auto first = limiter.submit(target);
+    auto second = limiter.submit(target);
+    first.get();
+    second.get();
+
+    // Assert
+    ASSERT_EQ(2, target.process_count.load());
+    ASSERT_EQ(0U, limiter.get_in_use("disk-io"));
+}
+
+TEST(resource_limiter, submit_throws_when_class_unknown)
+{
+    executor pool(1);
+    resource_limiter limiter(pool);
+
+    ASSERT_THROW(static_cast<void>(limiter.submit({"symbolization"}, []() {})), std::invalid_argument);
+}
+
+TEST(resource_limiter, add_class_throws_when_name_in_use)
+{
+    executor pool(1);
+    resource_limiter limiter(pool);
+    limiter.add_class("disk-io", 1);
+
+    ASSERT_THROW(limiter.add_class("disk-io", 2), std::invalid_argument);
+}
+
+}
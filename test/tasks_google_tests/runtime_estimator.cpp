@@ -0,0 +1,151 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/runtime_estimator.h>
+#include <iostream>
+#include <memory>
+
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::make_shared;
+using std::optional;
+
+using tasks::runtime_estimator;
+using tasks::runtime_model;
+using tasks::task;
+using tasks::task_state;
+
+namespace tasks::runtime_estimator_tests
+{
+
+class sized_task final : public task
+{
+public:
+    void process() override
+    {
+    }
+
+    [[nodiscard]] optional<double> get_input_size() const noexcept override
+    {
+        return input_size;
+    }
+
+    optional<double> input_size{};
+};
+
+void run(task& target)
+{
+    static_cast<void>(target.try_transition(target.get_current_state(), task_state::READY));
+    static_cast<void>(target.try_transition(task_state::READY, task_state::RUNNING));
+    static_cast<void>(target.try_transition(task_state::RUNNING, task_state::COMPLETE));
+}
+
+TEST(runtime_model, estimate_is_moving_average_without_size)
+{
+    // arrange
+    runtime_model model(0.5);
+
+    // Act
+    model.record(nanoseconds(100), std::nullopt);
+    model.record(nanoseconds(200), std::nullopt);
+
+    // Assert
+    ASSERT_EQ(nanoseconds(150), model.estimate(std::nullopt));
+}
+
+TEST(runtime_model, estimate_follows_size_regression_once_fitted)
+{
+    // arrange
+    runtime_model model;
+
+    // Act
+    for (auto size = 1; size <= 10; ++size)
+        model.record(nanoseconds(1'000 + 50 * size), static_cast<double>(size));
+
+    // Assert
+    ASSERT_EQ(nanoseconds(6'000), model.estimate(100.0));
+    ASSERT_NEAR(50.0, model.get_statistics().slope.value(), 1e-9);
+}
+
+TEST(runtime_model, statistics_include_quantiles)
+{
+    // arrange
+    runtime_model model;
+
+    // Act
+    for (auto i = 1; i <= 1'000; ++i)
+        model.record(nanoseconds(i), std::nullopt);
+    auto const statistics = model.get_statistics();
+
+    // Assert
+    ASSERT_EQ(1'000U, statistics.count);
+    ASSERT_NEAR(500.0, static_cast<double>(statistics.median.count()), 10.0);
+    ASSERT_NEAR(990.0, static_cast<double>(statistics.p99.count()), 10.0);
+}
+
+TEST(runtime_estimator, completed_run_is_recorded_against_task_type)
+{
+    // arrange
+    auto const estimator = make_shared<runtime_estimator>();
+    sized_task target{};
+    target.add_observer(estimator);
+
+    // Act
+    run(target);
+    auto const model = estimator->find_model<sized_task>();
+
+    // Assert
+    ASSERT_NE(nullptr, model);
+    ASSERT_EQ(1U, model->get_statistics().count);
+    ASSERT_EQ(milliseconds::zero(), target.get_estimated_time_remaining());
+}
+
+TEST(runtime_estimator, ready_task_is_given_learned_estimate)
+{
+    // arrange
+    auto const estimator = make_shared<runtime_estimator>();
+    sized_task target{};
+    target.add_observer(estimator);
+    run(target);
+    auto const model = estimator->find_model<sized_task>();
+    auto const expected = std::chrono::ceil<milliseconds>(model->estimate(std::nullopt));
+
+    // Act
+    static_cast<void>(target.try_transition(task_state::COMPLETE, task_state::READY));
+
+    // Assert
+    ASSERT_EQ(expected, target.get_estimated_time_remaining());
+}
+
+TEST(runtime_estimator, find_model_returns_null_for_unseen_type)
+{
+    runtime_estimator const estimator;
+
+    ASSERT_EQ(nullptr, estimator.find_model<sized_task>());
+}
+
+TEST(runtime_model, DISABLED_benchmark_record_cost)
+{
+    runtime_model model;
+    constexpr auto samples = 10'000'000;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < samples; ++i)
+        model.record(nanoseconds(1'000 + i % 977), static_cast<double>(i % 4096));
+    auto const elapsed = std::chrono::duration_cast<nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "nanoseconds per record: " << static_cast<double>(elapsed.count()) / samples << std::endl;
+}
+
+}
@@ -0,0 +1,72 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/streaming_quantile.h>
+#include <random>
+#include <stdexcept>
+
+using tasks::streaming_quantile;
+
+namespace tasks::streaming_quantile_tests
+{
+
+TEST(streaming_quantile, value_is_zero_when_empty)
+{
+    streaming_quantile const median(0.5);
+
+    ASSERT_EQ(0.0, median.get_value());
+}
+
+TEST(streaming_quantile, value_is_exact_with_fewer_than_five_samples)
+{
+    // arrange
+    streaming_quantile median(0.5);
+
+    // Act
+    median.add(30.0);
+    median.add(10.0);
+    median.add(20.0);
+
+    // Assert
+    ASSERT_EQ(20.0, median.get_value());
+}
+
+TEST(streaming_quantile, estimates_quantiles_of_uniform_stream)
+{
+    // arrange
+    std::mt19937 generator(42U);
+    std::uniform_real_distribution<double> distribution(0.0, 1000.0);
+    streaming_quantile median(0.5);
+    streaming_quantile p99(0.99);
+
+    // Act
+    for (auto i = 0; i < 100'000; ++i) {
+        auto const value = distribution(generator);
+        median.add(value);
+        p99.add(value);
+    }
+
+    // Assert
+    ASSERT_NEAR(500.0, median.get_value(), 15.0);
+    ASSERT_NEAR(990.0, p99.get_value(), 5.0);
+    ASSERT_EQ(100'000U, median.get_count());
+}
+
+TEST(streaming_quantile, constructor_throws_when_probability_out_of_range)
+{
+    ASSERT_THROW(streaming_quantile(1.0), std::invalid_argument);
+    ASSERT_THROW(streaming_quantile(0.0), std::invalid_argument);
+}
+
+}
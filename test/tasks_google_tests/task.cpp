@@ -0,0 +1,172 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/task_transition.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "test_task.h"
+
+using std::make_shared;
+using std::vector;
+
+using tasks::is_valid_transition;
+using tasks::task;
+using tasks::task_observer;
+using tasks::task_state;
+using tasks::tests::test_task;
+
+namespace tasks::task_tests
+{
+
+class recording_observer final : public task_observer
+{
+public:
+    void on_transition(task&, task_state const previous, task_state const current) noexcept override
+    {
+        transitions.emplace_back(previous, current);
+    }
+
+    vector<std::pair<task_state, task_state>> transitions;
+};
+
+class counting_observer final : public task_observer
+{
+public:
+    void on_transition(task&, task_state const, task_state const) noexcept override
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<int> count{};
+};
+
+TEST(task, initial_state_is_pending)
+{
+    test_task target{};
+
+    ASSERT_EQ(task_state::PENDING, target.get_current_state());
+}
+
+TEST(task, is_valid_transition_follows_lifecycle)
+{
+    ASSERT_TRUE(is_valid_transition(task_state::PENDING, task_state::READY));
+    ASSERT_TRUE(is_valid_transition(task_state::READY, task_state::RUNNING));
+    ASSERT_TRUE(is_valid_transition(task_state::RUNNING, task_state::COMPLETE));
+    ASSERT_TRUE(is_valid_transition(task_state::RUNNING, task_state::FAILED));
+    ASSERT_TRUE(is_valid_transition(task_state::COMPLETE, task_state::READY));
+    ASSERT_FALSE(is_valid_transition(task_state::PENDING, task_state::RUNNING));
+    ASSERT_FALSE(is_valid_transition(task_state::RUNNING, task_state::READY));
+    ASSERT_FALSE(is_valid_transition(task_state::READY, task_state::READY));
+}
+
+TEST(task, try_transition_returns_false_when_not_in_expected_state)
+{
+    // arrange
+    test_task target{};
+
+    // Act
+    auto const transitioned = target.try_transition(task_state::READY, task_state::RUNNING);
+
+    // Assert
+    ASSERT_FALSE(transitioned);
+    ASSERT_EQ(task_state::PENDING, target.get_current_state());
+}
+
+TEST(task, try_transition_throws_when_transition_is_invalid)
+{
+    test_task target{};
+
+    ASSERT_THROW(static_cast<void>(target.try_transition(task_state::PENDING, task_state::COMPLETE)), std::invalid_argument);
+}
+
+TEST(task, observer_is_notified_of_each_transition)
+{
+    // arrange
+    test_task target{};
+    auto const observer = make_shared<recording_observer>();
+    target.add_observer(observer);
+
+    // Act
+    static_cast<void>(target.try_transition(task_state::PENDING, task_state::READY));
+    static_cast<void>(target.try_transition(task_state::READY, task_state::RUNNING));
+    static_cast<void>(target.try_transition(task_state::RUNNING, task_state::COMPLETE));
+
+    // Assert
+    ASSERT_EQ(3U, observer->transitions.size());
+    ASSERT_EQ(std::make_pair(task_state::PENDING, task_state::READY), observer->transitions[0]);
+    ASSERT_EQ(std::make_pair(task_state::RUNNING, task_state::COMPLETE), observer->transitions[2]);
+}
+
+TEST(task, removed_observer_is_not_notified)
+{
+    // arrange
+    test_task target{};
+    auto const observer = make_shared<recording_observer>();
+    target.add_observer(observer);
+
+    // Act
+    auto const removed = target.remove_observer(*observer);
+    static_cast<void>(target.try_transition(task_state::PENDING, task_state::READY));
+
+    // Assert
+    ASSERT_TRUE(removed);
+    ASSERT_TRUE(observer->transitions.empty());
+}
+
+TEST(task, concurrent_transitions_are_won_by_exactly_one_thread)
+{
+    // arrange
+    constexpr auto thread_count = 8;
+    test_task target{};
+    static_cast<void>(target.try_transition(task_state::PENDING, task_state::READY));
+    auto const observer = make_shared<counting_observer>();
+    target.add_observer(observer);
+    std::atomic<int> winners{};
+
+    // Act
+    vector<std::thread> threads;
+    for (auto i = 0; i < thread_count; ++i)
+        threads.emplace_back([&target, &winners]() {
+            if (target.try_transition(task_state::READY, task_state::RUNNING))
+                winners.fetch_add(1, std::memory_order_relaxed);
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    // Assert
+    ASSERT_EQ(1, winners.load());
+    ASSERT_EQ(1, observer->count.load());
+    ASSERT_EQ(task_state::RUNNING, target.get_current_state());
+}
+
+TEST(task, next_run_is_given_a_new_stop_token)
+{
+    // arrange
+    test_task target{};
+    static_cast<void>(target.try_transition(task_state::PENDING, task_state::READY));
+    static_cast<void>(target.try_transition(task_state::READY, task_state::RUNNING));
+    target.request_stop();
+    static_cast<void>(target.try_transition(task_state::RUNNING, task_state::FAILED));
+
+    // Act
+    static_cast<void>(target.try_transition(task_state::FAILED, task_state::READY));
+
+    // Assert
+    ASSERT_FALSE(target.get_stop_token().stop_requested());
+}
+
+}
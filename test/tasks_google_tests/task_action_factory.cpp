@@ -0,0 +1,162 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/task_action_factory.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::chrono::milliseconds;
+using std::future;
+using std::string;
+
+using tasks::action_result;
+using tasks::task_action;
+using tasks::task_action_factory;
+using tasks::task_state;
+using tasks::type_list;
+
+namespace tasks::task_action_factory_tests
+{
+
+future<action_result> ready_result(task_state const state)
+{
+    std::promise<action_result> promise;
+    promise.set_value(action_result(state, milliseconds(0)));
+    return promise.get_future();
+}
+
+class capture_action final
+{
+public:
+    future<action_result> process_async()
+    {
+        ++processed;
+        return ready_result(task_state::RUNNING);
+    }
+
+    int processed{};
+};
+
+class publish_action final
+{
+public:
+    future<action_result> process_async()
+    {
+        return ready_result(task_state::COMPLETE);
+    }
+    future<action_result> process_async(std::stop_token stop_token)
+    {
+        return ready_result(stop_token.stop_requested() ? task_state::FAILED : task_state::COMPLETE);
+    }
+
+    explicit publish_action(string destination)
+        : destination{std::move(destination)}
+    {
+    }
+
+    string destination;
+};
+
+using factory = task_action_factory<type_list<capture_action, publish_action>>;
+
+static_assert(factory::size == 2U);
+static_assert(factory::index_of<publish_action>() == 1U);
+static_assert(!factory::contains<int>());
+
+TEST(task_action_factory, create_by_type_constructs_in_place)
+{
+    // arrange / Act
+    auto action = factory::create<publish_action>("report");
+
+    // Assert
+    ASSERT_EQ(factory::index_of<publish_action>(), action.index());
+    ASSERT_EQ("report", std::get<publish_action>(action).destination);
+}
+
+TEST(task_action_factory, create_by_index_default_constructs_when_possible)
+{
+    // arrange / Act
+    auto const capture = factory::create(0U);
+    auto const publish = factory::create(1U);
+    auto const missing = factory::create(2U);
+
+    // Assert
+    ASSERT_TRUE(capture.has_value());
+    ASSERT_FALSE(publish.has_value());
+    ASSERT_FALSE(missing.has_value());
+}
+
+TEST(task_action_factory, process_async_dispatches_to_held_action)
+{
+    // arrange
+    auto action = factory::create<capture_action>();
+
+    // Act
+    auto const [state, remaining] = factory::process_async(action).get();
+
+    // Assert
+    ASSERT_EQ(task_state::RUNNING, state);
+    ASSERT_EQ(1, std::get<capture_action>(action).processed);
+}
+
+TEST(task_action_factory, process_async_passes_stop_token_when_accepted)
+{
+    // arrange
+    auto action = factory::create<publish_action>("report");
+    std::stop_source source;
+    source.request_stop();
+
+    // Act
+    auto const [state, remaining] = factory::process_async(action, source.get_token()).get();
+
+    // Assert
+    ASSERT_EQ(task_state::FAILED, state);
+}
+
+class virtual_capture_action final : public task_action
+{
+public:
+    using task_action::process_async;
+
+    future<action_result> process_async() override
+    {
+        return ready_result(task_state::RUNNING);
+    }
+};
+
+TEST(task_action_factory, DISABLED_benchmark_against_virtual_base)
+{
+    constexpr auto ticks = 1'000'000;
+
+    auto const virtual_start = std::chrono::steady_clock::now();
+    for (auto tick = 0; tick < ticks; ++tick) {
+        std::unique_ptr<task_action> action = std::make_unique<virtual_capture_action>();
+        static_cast<void>(action->process_async().get());
+    }
+    auto const virtual_elapsed = std::chrono::steady_clock::now() - virtual_start;
+
+    auto const variant_start = std::chrono::steady_clock::now();
+    for (auto tick = 0; tick < ticks; ++tick) {
+        auto action = factory::create<capture_action>();
+        static_cast<void>(factory::process_async(action).get());
+    }
+    auto const variant_elapsed = std::chrono::steady_clock::now() - variant_start;
+
+    std::cout << "virtual nanoseconds per tick: " << std::chrono::duration<double, std::nano>(virtual_elapsed).count() / ticks << std::endl;
+    std::cout << "variant nanoseconds per tick: " << std::chrono::duration<double, std::nano>(variant_elapsed).count() / ticks << std::endl;
+}
+
+}
@@ -0,0 +1,139 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/task_graph.h>
+#include <algorithm>
+#include <any>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using std::any;
+using std::any_cast;
+using std::string;
+using std::vector;
+
+using tasks::executor;
+using tasks::node_outcome;
+using tasks::task_graph;
+
+namespace tasks::task_graph_tests
+{
+
+task_graph make_layered_graph(std::size_t const layers, std::size_t const width)
+{
+    // every node yields one more than the larger of the two nodes above it, the first layer yields 0
+    task_graph graph;
+    vector<task_graph::node_id> previous;
+    for (std::size_t column = 0; column < width; ++column)
+        previous.push_back(graph.add_node([](vector<any>) { return any(std::uint64_t{0}); }));
+
+    for (std::size_t layer = 1; layer < layers; ++layer) {
+        vector<task_graph::node_id> current;
+        for (std::size_t column = 0; column < width; ++column)
+            current.push_back(graph.add_node([](vector<any> inputs) {
+                return any(std::max(any_cast<std::uint64_t>(inputs[0]), any_cast<std::uint64_t>(inputs[1])) + 1U);
+            }, {previous[column], previous[(column + 1) % width]}));
+        previous = std::move(current);
+    }
+    return graph;
+}
+
+TEST(task_graph, outputs_are_passed_to_dependents_in_order)
+{
+    // arrange
+    executor pool(2);
+    task_graph graph;
+    auto const capture = graph.add_node([](vector<any>) { return any(string("capture")); });
+    auto const parse = graph.add_node([](vector<any> inputs) { return any(any_cast<string>(inputs[0]) + ">parse"); }, {capture});
+    auto const previous = graph.add_node([](vector<any>) { return any(string("previous")); });
+    auto const diff = graph.add_node([](vector<any> inputs) {
+        return any(any_cast<string>(inputs[0]) + "|" + any_cast<string>(inputs[1]));
+    }, {parse, previous});
+
+    // Act
+    auto const result = graph.run(pool).get();
+
+    // Assert
+    ASSERT_TRUE(result.succeeded());
+    ASSERT_EQ("capture>parse|previous", any_cast<string>(result.outputs[diff]));
+}
+
+TEST(task_graph, failed_node_cancels_downstream_only)
+{
+    // arrange
+    executor pool(2);
+    task_graph graph;
+    auto const failing = graph.add_node([](vector<any>) -> any { throw std::runtime_error("capture failed"); });
+    auto const child = graph.add_node([](vector<any>) { return any(1); }, {failing});
+    auto const grandchild = graph.add_node([](vector<any>) { return any(2); }, {child});
+    auto const independent = graph.add_node([](vector<any>) { return any(3); });
+
+    // Act
+    auto const result = graph.run(pool).get();
+
+    // Assert
+    ASSERT_FALSE(result.succeeded());
+    ASSERT_EQ(node_outcome::FAILED, result.outcomes[failing]);
+    ASSERT_NE(nullptr, result.errors[failing]);
+    ASSERT_EQ(node_outcome::CANCELLED, result.outcomes[child]);
+    ASSERT_EQ(node_outcome::CANCELLED, result.outcomes[grandchild]);
+    ASSERT_EQ(node_outcome::COMPLETE, result.outcomes[independent]);
+}
+
+TEST(task_graph, add_node_throws_when_dependency_is_unknown)
+{
+    task_graph graph;
+
+    ASSERT_THROW(static_cast<void>(graph.add_node([](vector<any>) { return any(); }, {0U})), std::invalid_argument);
+}
+
+TEST(task_graph, empty_graph_completes_immediately)
+{
+    executor pool(1);
+    task_graph const graph;
+
+    ASSERT_TRUE(graph.run(pool).get().succeeded());
+}
+
+TEST(task_graph, layered_graph_of_ten_thousand_nodes_completes)
+{
+    // arrange
+    executor pool(4);
+    auto const graph = make_layered_graph(100, 100);
+
+    // Act
+    auto const result = graph.run(pool).get();
+
+    // Assert
+    ASSERT_TRUE(result.succeeded());
+    ASSERT_EQ(std::uint64_t{99}, any_cast<std::uint64_t>(result.outputs.back()));
+}
+
+TEST(task_graph, DISABLED_benchmark_ten_thousand_node_throughput)
+{
+    executor pool;
+    auto const graph = make_layered_graph(100, 100);
+    constexpr auto runs = 50;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (auto run = 0; run < runs; ++run)
+        ASSERT_TRUE(graph.run(pool).get().succeeded());
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "nodes per second: " << static_cast<double>(graph.size() * runs) / elapsed << std::endl;
+}
+
+}
@@ -0,0 +1,230 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/task_journal.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include "test_task.h"
+
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::filesystem::path;
+using std::make_shared;
+
+using tasks::journal_entry;
+using tasks::task_journal;
+using tasks::task_state;
+using tasks::tests::test_task;
+
+namespace tasks::task_journal_tests
+{
+
+class temporary_directory final
+{
+public:
+    [[nodiscard]] path const& get() const noexcept
+    {
+        return m_path;
+    }
+
+    temporary_directory()
+        : m_path{std::filesystem::temp_directory_path() / ("task_journal_" + std::to_string(std::random_device{}()))}
+    {
+        std::filesystem::create_directories(m_path);
+    }
+    temporary_directory(temporary_directory const&) = delete;
+    temporary_directory& operator=(temporary_directory const&) = delete;
+    ~temporary_directory()
+    {
+        std::error_code ignored;
+        std::filesystem::remove_all(m_path, ignored);
+    }
+
+private:
+    path m_path;
+};
+
+TEST(task_journal, tracked_transitions_are_recovered_after_reopening)
+{
+    // arrange
+    temporary_directory const directory{};
+    {
+        auto const journal = make_shared<task_journal>(directory.get());
+        test_task target{};
+        journal->track(target, 7U);
+        target.add_observer(journal);
+
+        static_cast<void>(target.try_transition(task_state::PENDING, task_state::READY));
+        static_cast<void>(target.try_transition(task_state::READY, task_state::RUNNING));
+        journal->flush();
+    }
+
+    // Act
+    task_journal const reopened(directory.get());
+
+    // Assert
+    auto const& recovered = reopened.get_recovered();
+    ASSERT_EQ(1U, recovered.size());
+    ASSERT_EQ(task_state::RUNNING, recovered.at(7U).state);
+}
+
+TEST(task_journal, recovered_schedule_continues_the_same_series)
+{
+    // arrange
+    temporary_directory const directory{};
+    auto const anchor = journal_entry::clock::now();
+    {
+        task_journal journal(directory.get());
+        journal.wait_durable(journal.append_schedule(3U, anchor, seconds(10)));
+    }
+
+    // Act
+    auto const recovered = task_journal::replay(directory.get());
+    auto const next_due = recovered.at(3U).get_next_due(anchor + seconds(25));
+
+    // Assert
+    ASSERT_TRUE(next_due.has_value());
+    ASSERT_EQ(anchor + seconds(30), next_due.value());
+}
+
+TEST(task_journal, remove_forgets_task)
+{
+    // arrange
+    temporary_directory const directory{};
+    {
+        task_journal journal(directory.get());
+        static_cast<void>(journal.append_transition(1U, task_state::READY));
+        static_cast<void>(journal.append_transition(2U, task_state::READY));
+        journal.wait_durable(journal.append_remove(1U));
+    }
+
+    // Act
+    auto const recovered = task_journal::replay(directory.get());
+
+    // Assert
+    ASSERT_EQ(1U, recovered.size());
+    ASSERT_EQ(1U, recovered.count(2U));
+}
+
+TEST(task_journal, torn_record_is_discarded_and_overwritten)
+{
+    // arrange
+    temporary_directory const directory{};
+    {
+        task_journal journal(directory.get());
+        journal.wait_durable(journal.append_transition(1U, task_state::COMPLETE));
+    }
+    {
+        std::ofstream log(directory.get() / "journal.log", std::ios::binary | std::ios::app);
+        log.write("partial", 7);
+    }
+
+    // Act
+    {
+        task_journal journal(directory.get());
+        journal.wait_durable(journal.append_transition(2U, task_state::FAILED));
+    }
+    auto const recovered = task_journal::replay(directory.get());
+
+    // Assert
+    ASSERT_EQ(2U, recovered.size());
+    ASSERT_EQ(task_state::COMPLETE, recovered.at(1U).state);
+    ASSERT_EQ(task_state::FAILED, recovered.at(2U).state);
+}
+
+TEST(task_journal, compact_empties_log_and_keeps_state)
+{
+    // arrange
+    temporary_directory const directory{};
+    auto const anchor = journal_entry::clock::now();
+    task_journal journal(directory.get());
+    static_cast<void>(journal.append_schedule(1U, anchor, seconds(5)));
+    for (auto index = 0; index < 100; ++index)
+        static_cast<void>(journal.append_transition(1U, index % 2 == 0 ? task_state::READY : task_state::RUNNING));
+    journal.flush();
+
+    // Act
+    journal.compact();
+    journal.wait_durable(journal.append_transition(2U, task_state::PENDING));
+    auto const recovered = task_journal::replay(directory.get());
+
+    // Assert
+    ASSERT_EQ(1U, journal.get_log_size());
+    ASSERT_EQ(2U, recovered.size());
+    ASSERT_EQ(task_state::RUNNING, recovered.at(1U).state);
+    ASSERT_EQ(seconds(5), recovered.at(1U).period);
+}
+
+TEST(task_journal, log_is_compacted_once_threshold_is_reached)
+{
+    // arrange
+    temporary_directory const directory{};
+    task_journal journal(directory.get(), 10U);
+
+    // Act
+    for (auto index = 0; index < 10; ++index)
+        static_cast<void>(journal.append_transition(static_cast<std::uint64_t>(index), task_state::READY));
+    journal.flush();
+
+    // Assert
+    ASSERT_EQ(0U, journal.get_log_size());
+    ASSERT_EQ(10U, task_journal::replay(directory.get()).size());
+}
+
+TEST(task_journal, concurrent_appends_share_syncs)
+{
+    // arrange
+    temporary_directory const directory{};
+    task_journal journal(directory.get());
+    constexpr auto thread_count = 8;
+    constexpr auto appends_per_thread = 50;
+
+    // Act
+    std::vector<std::thread> appenders;
+    for (auto thread_index = 0; thread_index < thread_count; ++thread_index)
+        appenders.emplace_back([&journal, thread_index]() {
+            for (auto index = 0; index < appends_per_thread; ++index)
+                journal.wait_durable(journal.append_transition(static_cast<std::uint64_t>(thread_index), task_state::RUNNING));
+        });
+    for (auto& appender : appenders)
+        appender.join();
+
+    // Assert
+    ASSERT_EQ(static_cast<std::size_t>(thread_count * appends_per_thread), journal.get_log_size());
+    ASSERT_LT(journal.get_sync_count(), static_cast<std::size_t>(thread_count * appends_per_thread));
+}
+
+TEST(task_journal, DISABLED_benchmark_replay)
+{
+    temporary_directory const directory{};
+    constexpr auto records = 2'000'000;
+    {
+        task_journal journal(directory.get(), records + 1);
+        for (auto index = 0; index < records; ++index)
+            static_cast<void>(journal.append_transition(static_cast<std::uint64_t>(index % 10'000), static_cast<task_state>(index % 5)));
+        journal.flush();
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const recovered = task_journal::replay(directory.get());
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "replayed " << records << " records for " << recovered.size() << " tasks in "
+        << std::chrono::duration_cast<milliseconds>(elapsed).count() << "ms" << std::endl;
+}
+
+}
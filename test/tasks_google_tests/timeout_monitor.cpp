@@ -0,0 +1,114 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/timeout_monitor.h>
+#include <future>
+#include <memory>
+#include "test_task.h"
+
+using std::chrono::milliseconds;
+using std::make_shared;
+
+#if defined(__linux__)
+using shared::infrastructure::epoll_reactor;
+#endif
+using tasks::task_state;
+using tasks::tests::test_task;
+using tasks::timeout_monitor;
+
+namespace tasks::timeout_monitor_tests
+{
+
+void start(task& target)
+{
+    static_cast<void>(target.try_transition(task_state::PENDING, task_state::READY));
+    static_cast<void>(target.try_transition(task_state::READY, task_state::RUNNING));
+}
+
+TEST(timeout_monitor, own_thread_stops_task_once_timeout_elapses)
+{
+    // arrange
+    auto const monitor = make_shared<timeout_monitor>();
+    test_task target{};
+    target.set_timeout(milliseconds(5));
+    target.add_observer(monitor);
+    std::promise<void> stopped{};
+    std::stop_callback const on_stop(target.get_stop_token(), [&stopped]() { stopped.set_value(); });
+
+    // Act
+    start(target);
+
+    // Assert
+    ASSERT_EQ(std::future_status::ready, stopped.get_future().wait_for(std::chrono::seconds(5)));
+    ASSERT_EQ(0U, monitor->size());
+}
+
+#if defined(__linux__)
+
+TEST(timeout_monitor, running_task_is_stopped_once_timeout_elapses)
+{
+    // arrange
+    epoll_reactor reactor{};
+    auto const monitor = make_shared<timeout_monitor>(reactor);
+    test_task target{};
+    target.set_timeout(milliseconds(5));
+    target.add_observer(monitor);
+    std::stop_callback const on_stop(target.get_stop_token(), [&reactor]() { reactor.stop(); });
+
+    // Act
+    start(target);
+    reactor.run();
+
+    // Assert
+    ASSERT_TRUE(target.get_stop_token().stop_requested());
+    ASSERT_EQ(0U, monitor->size());
+}
+
+TEST(timeout_monitor, completed_task_is_disarmed)
+{
+    // arrange
+    epoll_reactor reactor{};
+    auto const monitor = make_shared<timeout_monitor>(reactor);
+    test_task target{};
+    target.set_timeout(milliseconds(5));
+    target.add_observer(monitor);
+    start(target);
+
+    // Act
+    static_cast<void>(target.try_transition(task_state::RUNNING, task_state::COMPLETE));
+    static_cast<void>(reactor.run_once(milliseconds(20)));
+
+    // Assert
+    ASSERT_EQ(0U, monitor->size());
+    ASSERT_FALSE(target.get_stop_token().stop_requested());
+}
+
+TEST(timeout_monitor, task_without_timeout_is_not_armed)
+{
+    // arrange
+    epoll_reactor reactor{};
+    auto const monitor = make_shared<timeout_monitor>(reactor);
+    test_task target{};
+    target.add_observer(monitor);
+
+    // Act
+    start(target);
+
+    // Assert
+    ASSERT_EQ(0U, monitor->size());
+}
+
+#endif
+
+}
@@ -0,0 +1,130 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <future>
+#include <tasks/timer_scheduler.h>
+#include "test_task.h"
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::vector;
+
+#if defined(__linux__)
+using shared::infrastructure::epoll_reactor;
+#endif
+using tasks::tests::test_task;
+using tasks::timer_id;
+using tasks::timer_scheduler;
+
+namespace tasks::timer_scheduler_tests
+{
+
+TEST(timer_scheduler, own_thread_fires_close_to_deadline)
+{
+    // arrange
+    test_task target{};
+    std::promise<timer_scheduler::clock::time_point> fired{};
+    auto fired_at = fired.get_future();
+    auto const start = timer_scheduler::clock::now();
+    timer_scheduler scheduler([&fired](task&, timer_id const&) { fired.set_value(timer_scheduler::clock::now()); });
+
+    // Act
+    static_cast<void>(scheduler.schedule_once(target, milliseconds(20)));
+
+    // Assert
+    ASSERT_EQ(std::future_status::ready, fired_at.wait_for(std::chrono::seconds(5)));
+    auto const lateness = duration_cast<microseconds>(fired_at.get() - (start + milliseconds(20)));
+    ASSERT_GE(lateness, -microseconds(250));
+    ASSERT_LT(lateness, milliseconds(20));
+    ASSERT_EQ(0U, scheduler.size());
+}
+
+TEST(timer_scheduler, own_thread_stops_with_timers_pending)
+{
+    // arrange
+    test_task target{};
+    auto fired = false;
+
+    // Act
+    {
+        timer_scheduler scheduler([&fired](task&, timer_id const&) { fired = true; });
+        static_cast<void>(scheduler.schedule_periodic(target, std::chrono::hours(1)));
+    }
+
+    // Assert
+    ASSERT_FALSE(fired);
+}
+
+#if defined(__linux__)
+
+TEST(timer_scheduler, fires_close_to_deadline)
+{
+    // arrange
+    epoll_reactor reactor{};
+    test_task target{};
+    auto const start = timer_scheduler::clock::now();
+    timer_scheduler::clock::time_point fired_at{};
+    timer_scheduler scheduler(reactor, [&reactor, &fired_at](task&, timer_id const&) {
+        fired_at = timer_scheduler::clock::now();
+        reactor.stop();
+    });
+    static_cast<void>(scheduler.schedule_once(target, milliseconds(20)));
+
+    // Act
+    reactor.run();
+
+    // Assert
+    auto const lateness = duration_cast<microseconds>(fired_at - (start + milliseconds(20)));
+    ASSERT_GE(lateness, -microseconds(250));
+    ASSERT_LT(lateness, milliseconds(20));
+}
+
+TEST(timer_scheduler, periodic_timer_keeps_firing_until_cancelled)
+{
+    // arrange
+    epoll_reactor reactor{};
+    test_task target{};
+    auto fired = 0;
+    timer_id id{};
+    timer_scheduler scheduler(reactor, [&](task& expired, timer_id const&) {
+        expired.process();
+        if (++fired == 5) {
+            scheduler.cancel(id);
+            reactor.stop();
+        }
+    });
+    id = scheduler.schedule_periodic(target, milliseconds(2));
+
+    // Act
+    reactor.run();
+
+    // Assert
+    ASSERT_EQ(5, target.process_count);
+    ASSERT_EQ(0U, scheduler.size());
+}
+
+TEST(timer_scheduler, idle_scheduler_does_not_wake_reactor)
+{
+    epoll_reactor reactor{};
+    timer_scheduler const scheduler(reactor, [](task&, timer_id const&) {});
+
+    auto const dispatched = reactor.run_once(milliseconds(20));
+
+    ASSERT_EQ(0U, dispatched);
+}
+
+#endif
+
+}
@@ -0,0 +1,174 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/timer_wheel.h>
+#include "test_task.h"
+
+using std::chrono::hours;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::vector;
+
+using tasks::tests::test_task;
+using tasks::timer_wheel;
+
+namespace tasks::timer_wheel_tests
+{
+
+constexpr auto resolution = milliseconds(1);
+auto const origin = timer_wheel::clock::time_point{} + hours(1);
+
+TEST(timer_wheel, once_fires_at_deadline)
+{
+    // arrange
+    timer_wheel wheel(resolution, origin);
+    test_task target{};
+    vector<timer_wheel::expiration> expired;
+    auto const id = wheel.schedule_once(target, milliseconds(10));
+
+    // Act
+    auto const early = wheel.advance(origin + milliseconds(9), expired);
+    auto const on_time = wheel.advance(origin + milliseconds(10), expired);
+
+    // Assert
+    ASSERT_EQ(0U, early);
+    ASSERT_EQ(1U, on_time);
+    ASSERT_EQ(&target, expired.front().target);
+    ASSERT_FALSE(wheel.is_scheduled(id));
+    ASSERT_EQ(0U, wheel.size());
+}
+
+TEST(timer_wheel, next_expiry_is_deadline)
+{
+    timer_wheel wheel(resolution, origin);
+    test_task target{};
+
+    static_cast<void>(wheel.schedule_once(target, milliseconds(42)));
+
+    ASSERT_EQ(origin + milliseconds(42), wheel.get_next_expiry());
+}
+
+TEST(timer_wheel, empty_wheel_has_no_next_expiry)
+{
+    timer_wheel const wheel(resolution, origin);
+
+    ASSERT_FALSE(wheel.get_next_expiry().has_value());
+}
+
+TEST(timer_wheel, cancelled_timer_does_not_fire)
+{
+    // arrange
+    timer_wheel wheel(resolution, origin);
+    test_task target{};
+    vector<timer_wheel::expiration> expired;
+    auto const id = wheel.schedule_once(target, milliseconds(5));
+
+    // Act
+    auto const cancelled = wheel.cancel(id);
+    wheel.advance(origin + seconds(1), expired);
+
+    // Assert
+    ASSERT_TRUE(cancelled);
+    ASSERT_TRUE(expired.empty());
+    ASSERT_FALSE(wheel.cancel(id));
+}
+
+TEST(timer_wheel, periodic_fires_every_period)
+{
+    // arrange
+    timer_wheel wheel(resolution, origin);
+    test_task target{};
+    vector<timer_wheel::expiration> expired;
+    auto const id = wheel.schedule_periodic(target, milliseconds(100));
+
+    // Act
+    for (auto elapsed = milliseconds(0); elapsed <= milliseconds(1000); elapsed += milliseconds(10))
+        wheel.advance(origin + elapsed, expired);
+
+    // Assert
+    ASSERT_EQ(10U, expired.size());
+    ASSERT_TRUE(wheel.is_scheduled(id));
+}
+
+TEST(timer_wheel, periodic_fires_once_when_periods_are_missed)
+{
+    timer_wheel wheel(resolution, origin);
+    test_task target{};
+    vector<timer_wheel::expiration> expired;
+    static_cast<void>(wheel.schedule_periodic(target, milliseconds(10)));
+
+    wheel.advance(origin + milliseconds(95), expired);
+
+    ASSERT_EQ(1U, expired.size());
+    ASSERT_EQ(origin + milliseconds(100), wheel.get_next_expiry());
+}
+
+TEST(timer_wheel, long_delay_cascades_to_exact_tick)
+{
+    // arrange
+    timer_wheel wheel(resolution, origin);
+    test_task target{};
+    vector<timer_wheel::expiration> expired;
+    auto const delay = hours(30) + milliseconds(7);
+    static_cast<void>(wheel.schedule_once(target, delay));
+
+    // Act
+    wheel.advance(origin + delay - milliseconds(1), expired);
+    auto const before = expired.size();
+    wheel.advance(origin + delay, expired);
+
+    // Assert
+    ASSERT_EQ(0U, before);
+    ASSERT_EQ(1U, expired.size());
+}
+
+TEST(timer_wheel, delay_beyond_range_throws)
+{
+    timer_wheel wheel(resolution, origin);
+    test_task target{};
+
+    ASSERT_THROW(static_cast<void>(wheel.schedule_once(target, wheel.get_maximum_delay() + seconds(1))), std::out_of_range);
+}
+
+TEST(timer_wheel, holds_one_hundred_thousand_timers_in_order)
+{
+    // arrange
+    constexpr auto count = 100'000;
+    timer_wheel wheel(microseconds(250), origin);
+    vector<test_task> targets(count);
+    vector<timer_wheel::expiration> expired;
+    expired.reserve(count);
+    for (auto i = 0; i < count; ++i)
+        static_cast<void>(wheel.schedule_once(targets[i], milliseconds(1 + (i * 7919) % 600'000)));
+
+    // Act
+    auto last = origin;
+    auto ordered = true;
+    while (auto const next = wheel.get_next_expiry()) {
+        auto const before = expired.size();
+        wheel.advance(next.value(), expired);
+        if (expired.size() != before) {
+            ordered = ordered && next.value() >= last;
+            last = next.value();
+        }
+    }
+
+    // Assert
+    ASSERT_EQ(static_cast<std::size_t>(count), expired.size());
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(0U, wheel.size());
+}
+
+}